@@ -51,6 +51,13 @@ struct RiskConfig {
     // Add other risk parameters
 };
 
+struct LoggingConfig {
+    std::string level = "INFO";
+    std::string file;                 // Empty logs to the console
+    unsigned rate_limit_per_sec = 0;  // Per component; 0 = unlimited
+    std::map<std::string, std::string> component_levels;
+};
+
 struct AppConfig {
     RunMode run_mode = RunMode::BACKTEST;
     std::vector<std::string> symbols;
@@ -59,6 +66,7 @@ struct AppConfig {
     std::vector<StrategyConfig> strategies;
     RiskConfig risk;
     WebSocketConfig websocket;
+    LoggingConfig logging;
     
     // Convert RunMode to string for display
     static std::string runModeToString(RunMode mode) {
@@ -0,0 +1,229 @@
+#ifndef ASYNC_LOGGER_H
+#define ASYNC_LOGGER_H
+
+#include <nlohmann/json.hpp>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Asynchronous logger for hot paths. A log call copies its arguments into a
+// fixed-size binary record in the calling thread's own SPSC ring and returns;
+// a background thread formats the records and writes them out. Nothing on the
+// producer side locks, allocates or makes a syscall after the first call on a
+// thread. Records that don't fit (full ring, rate limit) are dropped and counted.
+//
+// Format strings use "{}" placeholders ("{:.2f}" for fixed precision) and must
+// be string literals: only the pointer is stored in the record.
+
+// ERR rather than ERROR: <windows.h> defines ERROR as a macro.
+enum class LogLevel : uint8_t { TRACE, DEBUG, INFO, WARN, ERR, OFF };
+
+class AsyncLogger;
+
+// Named logging component with its own level and rate limit. Create one per
+// module (usually a file-scope static) and pass it to the LOG_* macros.
+class LogComponent {
+public:
+    explicit LogComponent(const char* name);
+    uint16_t id() const { return id_; }
+
+private:
+    uint16_t id_;
+};
+
+// Silences every log call made by the current thread while in scope. Used by
+// worker threads that run many engines in parallel (optimisation, Monte Carlo).
+// Once muteStdout() has been called, the thread's std::cout output is dropped
+// as well.
+class ScopedLogMute {
+public:
+    ScopedLogMute();
+    ~ScopedLogMute();
+
+    // Routes std::cout through a filter that discards writes from muted
+    // threads. Idempotent; call it before starting the threads to be muted.
+    static void muteStdout();
+    ScopedLogMute(const ScopedLogMute&) = delete;
+    ScopedLogMute& operator=(const ScopedLogMute&) = delete;
+
+private:
+    bool previous_;
+};
+
+class AsyncLogger {
+public:
+    static constexpr size_t RECORD_SIZE = 256;      // Bytes per ring slot
+    static constexpr size_t RING_CAPACITY = 4096;    // Slots per thread (power of two)
+    static constexpr size_t MAX_COMPONENTS = 64;
+
+    static AsyncLogger& instance();
+
+    // Reads the "logging" config block:
+    // {"level": "INFO", "file": "", "rate_limit_per_sec": 0,
+    //  "components": {"WebSocket": "WARN", ...}}
+    void configure(const nlohmann::json& logging_config);
+
+    void setLevel(LogLevel level);
+    void setComponentLevel(const std::string& component, LogLevel level);
+    // Maximum records per second per component; 0 disables the limit.
+    void setRateLimit(uint32_t records_per_sec);
+    // Empty path writes to stdout (WARN and above to stderr).
+    void setOutputFile(const std::string& path);
+
+    // Blocks until every record logged before the call has been written.
+    void flush();
+    void shutdown();
+
+    bool enabled(const LogComponent& component, LogLevel level) const {
+        return !thread_muted_ && level >= component_state_[component.id()].level.load(std::memory_order_relaxed);
+    }
+
+    template <typename... Args>
+    void log(const LogComponent& component, LogLevel level, const char* fmt, const Args&... args) {
+        if (!admit(component.id())) return;
+        Ring& ring = thread_ring();
+        Record* record = ring.reserve();
+        if (!record) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        record->timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        record->fmt = fmt;
+        record->component = component.id();
+        record->level = level;
+        record->truncated = false;
+        record->size = 0;
+        (encode(*record, args), ...);
+        ring.commit();
+        wake_formatter();
+    }
+
+    static LogLevel parseLevel(const std::string& name, LogLevel fallback = LogLevel::INFO);
+    static const char* levelName(LogLevel level);
+
+private:
+    friend class LogComponent;
+    friend class ScopedLogMute;
+
+    enum class ArgType : uint8_t { INT, UINT, DOUBLE, BOOL, CHAR, STRING };
+
+    struct Record {
+        int64_t timestamp_ns;
+        const char* fmt;
+        uint16_t component;
+        LogLevel level;
+        bool truncated; // An argument didn't fit; later ones are dropped too
+        uint16_t size;  // Bytes used in payload
+        unsigned char payload[RECORD_SIZE - 24];
+    };
+    static_assert(sizeof(Record) == RECORD_SIZE, "Log record must fill exactly one ring slot");
+
+    // Single-producer (the owning thread) / single-consumer (the formatter) ring.
+    struct Ring {
+        alignas(64) std::atomic<uint64_t> head{0}; // Next slot to write
+        alignas(64) std::atomic<uint64_t> tail{0}; // Next slot to read
+        std::atomic<bool> orphaned{false};         // Owning thread has exited
+        std::unique_ptr<Record[]> slots{new Record[RING_CAPACITY]};
+
+        Record* reserve() {
+            uint64_t h = head.load(std::memory_order_relaxed);
+            if (h - tail.load(std::memory_order_acquire) >= RING_CAPACITY) return nullptr;
+            return &slots[h & (RING_CAPACITY - 1)];
+        }
+        void commit() { head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+    };
+
+    struct ComponentState {
+        std::atomic<LogLevel> level{LogLevel::INFO};
+        std::atomic<int64_t> window_start{0};      // Rate-limit window, whole seconds
+        std::atomic<uint32_t> window_count{0};
+        std::atomic<uint64_t> suppressed{0};
+    };
+
+    AsyncLogger();
+    ~AsyncLogger();
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    uint16_t registerComponent(const char* name);
+    bool admit(uint16_t component);
+    Ring& thread_ring();
+    void wake_formatter();
+    void formatter_loop();
+    bool drain_once();
+    void write_record(const Record& record);
+    void report_suppressed();
+
+    static void put(Record& record, ArgType type, const void* data, size_t size);
+    static void encode(Record& record, bool value) { put(record, ArgType::BOOL, &value, 1); }
+    static void encode(Record& record, char value) { put(record, ArgType::CHAR, &value, 1); }
+    static void encode(Record& record, double value) { put(record, ArgType::DOUBLE, &value, sizeof(value)); }
+    static void encode(Record& record, float value) { encode(record, static_cast<double>(value)); }
+    static void encode(Record& record, std::string_view value);
+    static void encode(Record& record, const std::string& value) { encode(record, std::string_view(value)); }
+    static void encode(Record& record, const char* value) { encode(record, std::string_view(value ? value : "(null)")); }
+    template <typename T>
+    static std::enable_if_t<std::is_integral_v<T> || std::is_enum_v<T>> encode(Record& record, T value) {
+        if constexpr (std::is_enum_v<T>) {
+            encode(record, static_cast<std::underlying_type_t<T>>(value));
+        } else if constexpr (std::is_signed_v<T>) {
+            int64_t v = value;
+            put(record, ArgType::INT, &v, sizeof(v));
+        } else {
+            uint64_t v = value;
+            put(record, ArgType::UINT, &v, sizeof(v));
+        }
+    }
+
+    std::array<ComponentState, MAX_COMPONENTS> component_state_;
+    std::vector<std::string> component_names_;
+    std::map<std::string, LogLevel> component_overrides_; // Applied to components registered later too
+    LogLevel default_level_ = LogLevel::INFO;
+    std::mutex components_mutex_;
+    std::atomic<uint32_t> rate_limit_{0};
+    std::atomic<uint64_t> dropped_{0};
+
+    std::vector<std::shared_ptr<Ring>> rings_;
+    std::mutex rings_mutex_;
+
+    FILE* file_ = nullptr;
+    std::mutex output_mutex_;
+
+    std::thread formatter_;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cond_;
+    std::condition_variable drained_cond_;
+    std::atomic<bool> pending_{false};
+    bool flush_requested_ = false;
+    std::atomic<bool> running_{true};
+    uint64_t drain_generation_ = 0;
+
+    static thread_local bool thread_muted_;
+};
+
+#define LOG_AT(component, level, ...) \
+    do { \
+        if (AsyncLogger::instance().enabled(component, level)) \
+            AsyncLogger::instance().log(component, level, __VA_ARGS__); \
+    } while (0)
+
+#define LOG_TRACE(component, ...) LOG_AT(component, LogLevel::TRACE, __VA_ARGS__)
+#define LOG_DEBUG(component, ...) LOG_AT(component, LogLevel::DEBUG, __VA_ARGS__)
+#define LOG_INFO(component, ...) LOG_AT(component, LogLevel::INFO, __VA_ARGS__)
+#define LOG_WARN(component, ...) LOG_AT(component, LogLevel::WARN, __VA_ARGS__)
+#define LOG_ERROR(component, ...) LOG_AT(component, LogLevel::ERR, __VA_ARGS__)
+
+#endif // ASYNC_LOGGER_H
@@ -0,0 +1,73 @@
+#ifndef BACKTEST_PIPELINE_H
+#define BACKTEST_PIPELINE_H
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../data/DataHandler.h"
+#include "../data/SnapshotDataHandler.h"
+#include "../event/Event.h"
+#include "../event/SpscQueue.h"
+#include "../event/ThreadSafeQueue.h"
+
+// The events one updateBars() call produced, on their way down the pipeline.
+struct PipelineBatch {
+    uint64_t sequence = 0;                       // Replay order; checked by every stage
+    std::vector<std::shared_ptr<Event>> events;
+    std::vector<MarketSnapshot> snapshots;       // Source state right after the call
+    std::vector<std::shared_ptr<Event>> signals; // Added by the strategy stage
+    bool last = false;                           // Sent once the source is finished
+};
+
+// Runs a backtest as three stages on their own threads, connected by SPSC
+// rings:
+//   decode:   source->updateBars(), snapshots of the symbols it touched
+//   strategy: the strategies, reading the data through their own snapshot view
+//   engine:   risk, execution and portfolio (the calling thread)
+// Batches keep their replay sequence, and each stage sees the data exactly
+// as the serial loop would at that batch, so the results are identical.
+// Strategies must not depend on engine state (they never see fills), which
+// is what lets the strategy stage run ahead of the engine.
+class BacktestPipeline {
+public:
+    // Handles a batch on the strategy thread and appends the signals.
+    using StrategyStage = std::function<void(PipelineBatch&)>;
+    // Handles a batch on the engine thread; false ends the run early.
+    using EngineStage = std::function<bool(PipelineBatch&)>;
+
+    BacktestPipeline(std::shared_ptr<DataHandler> source,
+                     std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> source_queue,
+                     std::shared_ptr<SnapshotDataHandler> strategy_view,
+                     std::shared_ptr<SnapshotDataHandler> engine_view,
+                     size_t capacity = 1024,
+                     bool pin_threads = true);
+
+    // Runs until the source is finished or `engine` returns false. Returns
+    // the number of batches the engine handled.
+    uint64_t run(const StrategyStage& strategy, const EngineStage& engine);
+
+private:
+    void decode_loop();
+    void strategy_loop(const StrategyStage& strategy);
+    // Blocks while `ring` is full; false if the run is being stopped.
+    bool push(SpscQueue<PipelineBatch>& ring, PipelineBatch&& batch);
+    void fail(std::exception_ptr error);
+
+    std::shared_ptr<DataHandler> source_;
+    std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> source_queue_;
+    std::shared_ptr<SnapshotDataHandler> strategy_view_;
+    std::shared_ptr<SnapshotDataHandler> engine_view_;
+    bool pin_threads_;
+    SpscQueue<PipelineBatch> decoded_;
+    SpscQueue<PipelineBatch> evaluated_;
+    std::atomic<bool> stopping_{false};
+    std::mutex error_mutex_;
+    std::exception_ptr error_;
+};
+
+#endif // BACKTEST_PIPELINE_H
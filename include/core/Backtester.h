@@ -9,6 +9,8 @@
 #include <thread>
 #include <atomic>
 #include <unordered_map> // Add this for std::unordered_map
+#include <functional>
+#include <algorithm>
 
 #include "../data/DataHandler.h"
 #include "../event/Event.h"
@@ -23,6 +25,8 @@
 #include "../core/CustomAllocator.h"
 #include "../strategy/MLStrategyClassifier.h"
 #include "../analytics/PerformanceForecaster.h"
+#include "StrategyRuntime.h"
+#include "../data/SnapshotDataHandler.h"
 
 
 class Backtester {
@@ -43,9 +47,39 @@ public:
     const nlohmann::json& config() const { return config_; }
     RunMode run_mode() const { return run_mode_; }
     std::shared_ptr<Portfolio> getPortfolio() const { return portfolio_; }
+    std::shared_ptr<DataHandler> getDataHandler() const { return data_handler_; }
+    // Skips the end-of-run reports; used for the many runs of a parameter sweep.
+    void setReportsEnabled(bool enabled) { reports_enabled_ = enabled && !headless_; }
+    // Checked every `every_events` events of run_backtest(); returning true
+    // abandons the run (e.g. a losing candidate in an optimisation).
+    void setStopCondition(std::function<bool(const Portfolio&)> condition, long long every_events) {
+        stop_condition_ = std::move(condition);
+        stop_check_interval_ = std::max(1LL, every_events);
+        next_stop_check_ = stop_check_interval_;
+    }
+    bool stoppedEarly() const { return stopped_early_; }
+    // Events handled by the last run.
+    long long eventCount() const { return event_count_; }
+    // Sharpe, drawdown and return of the run so far, kept incrementally.
+    // All a headless run ("headless": true) reports.
+    RunMetrics runMetrics() const { return portfolio_->runMetrics(); }
+
+    // The replay DataHandler of a historical run ("data" block of `config`):
+    // a JournalDataHandler for data.journal_path, an HFTDataHandler otherwise.
+    static std::shared_ptr<DataHandler> createHistoricalDataHandler(
+        const nlohmann::json& config,
+        std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> event_queue);
+
+    // `config` set up as one of many headless backtests (sweeps, batches):
+    // BACKTEST mode, no threads within the run and no checkpoints, since
+    // the caller already keeps every core busy with whole runs.
+    static nlohmann::json headlessRunConfig(const nlohmann::json& config);
 
 private:
     void run_backtest();
+    // Symbol groups on their own threads, merged afterwards ("partitioned").
+    void run_partitioned();
+    void print_reports(long long duration_ms);
     nlohmann::json run_optimization();
     void run_walk_forward();
     void main_loop();
@@ -54,8 +88,16 @@ private:
     void handle_order_event(const std::shared_ptr<Event>& event);
     void handle_fill_event(const std::shared_ptr<Event>& event);
 
+    // Moves the strategies onto their own worker threads ("strategy_threads").
     void start_strategy_threads();
-    void strategy_thread_worker(std::shared_ptr<Strategy> strategy);
+    // Replays the data as a decode/strategy/engine pipeline ("pipeline").
+    void run_pipeline(long long& event_count);
+    bool check_stop_condition(long long event_count);
+    // Binary engine state at a batch boundary ("checkpoint" config block).
+    void save_checkpoint(long long event_count);
+    // Loads the checkpoint nearest before `market_time` (< 0: the latest).
+    void restore_checkpoint(long long market_time, long long& event_count);
+    void apply_strategy_classifier(const MarketRegimeChangedEvent& regime_event);
     void handleEvent(const std::shared_ptr<Event>& event);
     void log_live_performance();
 
@@ -67,13 +109,36 @@ private:
     std::shared_ptr<Portfolio> portfolio_;
     std::shared_ptr<ExecutionHandler> execution_handler_;
     bool finished_ = true; // Add this line
+    bool reports_enabled_ = true;
+    bool headless_ = false;
+    std::function<bool(const Portfolio&)> stop_condition_;
+    long long stop_check_interval_ = 0;
+    long long next_stop_check_ = 0;
+    bool stopped_early_ = false;
+    long long event_count_ = 0;
+    std::string checkpoint_dir_;
+    long long checkpoint_interval_ms_ = 0; // Event time between checkpoints; 0 disables them
+    long long next_checkpoint_time_ = 0;
 
     std::atomic<bool> continue_backtest_{true};
-    std::vector<std::thread> strategy_threads_;
+    bool strategy_threads_enabled_ = false;
+    std::vector<std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>>> strategy_outboxes_;
+    std::unique_ptr<StrategyRuntime> strategy_runtime_;
+    // Pipeline mode: the replaying handler and its queue; data_handler_ is then
+    // the engine's snapshot view and strategy_view_ the strategies'.
+    bool pipeline_enabled_ = false;
+    std::shared_ptr<DataHandler> source_data_handler_;
+    std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> source_queue_;
+    std::shared_ptr<SnapshotDataHandler> strategy_view_;
 
     // For live monitoring
     std::chrono::steady_clock::time_point last_monitor_time_;
     long long monitor_interval_ms_;
+    // SHADOW mode tick-to-signal latency: frame receipt to signal creation, ns,
+    // for the latest kLatencySamples signals (ring indexed by count)
+    static constexpr size_t kLatencySamples = 4096;
+    std::vector<long long> signal_latencies_ns_;
+    size_t signal_count_ = 0;
 
     // For risk monitoring
     std::chrono::steady_clock::time_point last_risk_check_time_;
@@ -0,0 +1,80 @@
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include <set>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "RunMetrics.h"
+
+using json = nlohmann::json;
+
+// Settings of a non-interactive batch (`backtester --batch ...`).
+struct BatchOptions {
+    std::string config_path = "config.json"; // Base config every job patches
+    std::string jobs_path;                   // One job per line, see BatchRunner
+    std::string out_path;                    // Result lines; empty: stdout
+    std::string format = "jsonl";            // "jsonl" or "csv"
+    int threads = 0;                         // <= 0: all cores
+    bool resume = false;                     // Skip jobs that succeeded in out_path
+};
+
+// One job of a batch: a merge patch on the base config, and its name.
+struct BatchJob {
+    std::string id;
+    json patch;
+};
+
+// Outcome of one batch job.
+struct BatchResult {
+    std::string id;
+    bool ok = false;
+    RunMetrics metrics;
+    long long events = 0;
+    long long duration_ms = 0;
+    std::string error;
+};
+
+// Runs many headless backtests from a job file. Each line of the file is a
+// JSON merge patch (RFC 7386) applied to the base config; an optional "id"
+// key names the job (default: "job-<line number>"). Blank lines and lines
+// starting with '#' are skipped.
+//
+// Jobs run concurrently on a bounded ThreadPool. They share the process-wide
+// DatasetCache, so jobs over the same data decode it once. One result line
+// is written per job, in completion order, and flushed straight away, so a
+// killed batch loses at most the jobs that were running. With resume set,
+// jobs whose id already has a successful result line are skipped and new
+// lines are appended; failed jobs run again.
+class BatchRunner {
+public:
+    explicit BatchRunner(const BatchOptions& options);
+
+    // Returns the number of jobs that failed (0: every job succeeded).
+    size_t run();
+
+    // One job: `patch` merged into `base_config`, run as a headless backtest.
+    // Errors are reported in the result rather than thrown.
+    static BatchResult runJob(const json& base_config, const std::string& id, const json& patch);
+
+    // Jobs of a job file (format above). Throws on malformed lines and
+    // duplicate ids.
+    static std::vector<BatchJob> loadJobs(const std::string& path);
+
+    // Result line without the trailing newline.
+    static std::string formatResult(const BatchResult& result, const std::string& format);
+    static std::string csvHeader();
+    static json toJson(const BatchResult& result);
+    static BatchResult fromJson(const json& line);
+
+private:
+    // Ids with a complete, successful result line in out_path. Drops a
+    // partial last line left by an interrupted batch.
+    std::set<std::string> completedJobs() const;
+
+    BatchOptions options_;
+    json base_config_;
+};
+
+#endif // BATCH_RUNNER_H
@@ -0,0 +1,259 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../data/DataTypes.h"
+
+// Binary state of an engine at one point of a replay, so a run can resume
+// there instead of replaying from the start.
+//
+// File layout (native byte order):
+//   CheckpointHeader
+//   sections: uint32 tag, uint64 length, `length` bytes of component state
+// Sections are length-prefixed, so a reader can skip a component it does not
+// have (e.g. the data cursor when a live feed resumes).
+constexpr uint32_t CHECKPOINT_MAGIC = 0x54504B43; // "CKPT" little-endian
+constexpr uint32_t CHECKPOINT_VERSION = 2;
+
+struct CheckpointHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t fingerprint;   // Of the config the run was started with
+    int64_t market_time;    // Event time of the checkpoint, ms
+    int64_t event_count;    // Events handled before it
+    uint64_t reserved[4];
+};
+
+static_assert(sizeof(CheckpointHeader) == 64, "Checkpoint header layout changed");
+
+enum class CheckpointSection : uint32_t {
+    DATA = 1,
+    PORTFOLIO = 2,
+    RISK = 3,
+    STRATEGIES = 4,
+    REGIME = 5
+};
+
+// Appends state to a byte buffer. Sizes are written as uint64.
+class StateWriter {
+public:
+    template <typename T>
+    void put(T value) {
+        static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "put() takes plain values");
+        const char* bytes = reinterpret_cast<const char*>(&value);
+        buffer_.append(bytes, sizeof(T));
+    }
+    void put(bool value) { put<uint8_t>(value ? 1 : 0); }
+    void put(const std::string& value) {
+        put<uint64_t>(value.size());
+        buffer_.append(value);
+    }
+    void put(const MarketState& state) {
+        put(state.volatility);
+        put(state.trend);
+        put(state.volatility_value);
+    }
+    void put(const Bar& bar) {
+        put(bar.symbol);
+        put(bar.timestamp);
+        put(bar.open);
+        put(bar.high);
+        put(bar.low);
+        put(bar.close);
+        put(bar.volume);
+    }
+    void put(const OrderBook& book) {
+        put(book.symbol);
+        put(book.timestamp);
+        putLevels(book.bids);
+        putLevels(book.asks);
+    }
+    // LEB128; small values take one byte.
+    void putVarint(uint64_t value) {
+        while (value >= 0x80) {
+            buffer_.push_back(static_cast<char>(value | 0x80));
+            value >>= 7;
+        }
+        buffer_.push_back(static_cast<char>(value));
+    }
+    // Zigzag-mapped, so small negative values stay small too.
+    void putSignedVarint(int64_t value) {
+        putVarint((static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63));
+    }
+    template <typename T>
+    void putSequence(const T& values) {
+        put<uint64_t>(values.size());
+        for (const auto& value : values) {
+            put(value);
+        }
+    }
+
+    // Component state written by `write` as one section.
+    template <typename F>
+    void section(CheckpointSection tag, F&& write) {
+        StateWriter inner;
+        write(inner);
+        put(static_cast<uint32_t>(tag));
+        put<uint64_t>(inner.buffer_.size());
+        buffer_.append(inner.buffer_);
+    }
+
+    // Raw bytes, e.g. what another writer produced.
+    void append(const std::string& bytes) { buffer_.append(bytes); }
+
+    const std::string& bytes() const { return buffer_; }
+
+private:
+    void putLevels(const std::vector<std::pair<double, double>>& levels) {
+        put<uint64_t>(levels.size());
+        for (const auto& [price, quantity] : levels) {
+            put(price);
+            put(quantity);
+        }
+    }
+
+    std::string buffer_;
+};
+
+// Reads what a StateWriter wrote, in the same order. Throws
+// std::runtime_error on truncated or malformed input.
+class StateReader {
+public:
+    StateReader(const char* data, size_t size) : data_(data), size_(size) {}
+
+    template <typename T>
+    T get() {
+        static_assert(std::is_arithmetic_v<T> || std::is_enum_v<T>, "get() returns plain values");
+        T value;
+        std::memcpy(&value, take(sizeof(T)), sizeof(T));
+        return value;
+    }
+    uint64_t getVarint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            const auto byte = static_cast<uint8_t>(*take(1));
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        throw std::runtime_error("Checkpoint: malformed varint");
+    }
+    int64_t getSignedVarint() {
+        const uint64_t value = getVarint();
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+    std::string getString() {
+        const size_t size = getSize();
+        return std::string(take(size), size);
+    }
+    MarketState getMarketState() {
+        MarketState state;
+        state.volatility = get<VolatilityLevel>();
+        state.trend = get<TrendDirection>();
+        state.volatility_value = get<double>();
+        return state;
+    }
+    Bar getBar() {
+        Bar bar;
+        bar.symbol = getString();
+        bar.timestamp = getString();
+        bar.open = get<double>();
+        bar.high = get<double>();
+        bar.low = get<double>();
+        bar.close = get<double>();
+        bar.volume = get<long long>();
+        return bar;
+    }
+    OrderBook getOrderBook() {
+        OrderBook book;
+        book.symbol = getString();
+        book.timestamp = get<long long>();
+        book.bids = getLevels();
+        book.asks = getLevels();
+        return book;
+    }
+    // Element count of a sequence, checked against the bytes left.
+    size_t getSize() {
+        const uint64_t size = get<uint64_t>();
+        if (size > size_ - offset_) {
+            throw std::runtime_error("Checkpoint: corrupt length");
+        }
+        return static_cast<size_t>(size);
+    }
+    template <typename T>
+    std::deque<T> getDeque() {
+        std::deque<T> values(getSize());
+        for (auto& value : values) {
+            value = get<T>();
+        }
+        return values;
+    }
+
+    // Sections of a checkpoint body, by tag.
+    std::map<CheckpointSection, StateReader> sections() {
+        std::map<CheckpointSection, StateReader> found;
+        while (offset_ < size_) {
+            const auto tag = static_cast<CheckpointSection>(get<uint32_t>());
+            const size_t length = getSize();
+            found.emplace(tag, StateReader(take(length), length));
+        }
+        return found;
+    }
+
+    bool atEnd() const { return offset_ == size_; }
+
+private:
+    const char* take(size_t bytes) {
+        if (bytes > size_ - offset_) {
+            throw std::runtime_error("Checkpoint: unexpected end of data");
+        }
+        const char* at = data_ + offset_;
+        offset_ += bytes;
+        return at;
+    }
+    std::vector<std::pair<double, double>> getLevels() {
+        std::vector<std::pair<double, double>> levels(getSize());
+        for (auto& [price, quantity] : levels) {
+            price = get<double>();
+            quantity = get<double>();
+        }
+        return levels;
+    }
+
+    const char* data_;
+    size_t size_;
+    size_t offset_ = 0;
+};
+
+// Checkpoint files of one run live in one directory, named after their
+// market time so the nearest one can be found without opening the others.
+namespace checkpoint {
+
+std::string pathFor(const std::string& dir, long long market_time);
+
+// Writes atomically (temporary file, then rename).
+void write(const std::string& path, const CheckpointHeader& header, const std::string& body);
+
+struct Loaded {
+    CheckpointHeader header;
+    std::string body;
+};
+Loaded read(const std::string& path);
+
+// The checkpoint in `dir` with the latest market time <= `market_time`
+// (any time if market_time < 0), or nullopt.
+std::optional<std::string> findAtOrBefore(const std::string& dir, long long market_time);
+
+} // namespace checkpoint
+
+#endif // CHECKPOINT_H
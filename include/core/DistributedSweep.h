@@ -0,0 +1,103 @@
+#ifndef DISTRIBUTED_SWEEP_H
+#define DISTRIBUTED_SWEEP_H
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "BatchRunner.h"
+
+using json = nlohmann::json;
+
+// Settings of a distributed sweep ("distributed" config block).
+struct DistributedOptions {
+    std::string address = "127.0.0.1";       // Coordinator listen address; "0.0.0.0" for every interface
+    unsigned short port = 7700;              // 0: any free port
+    size_t shard_size = 4;                   // Jobs per shard
+    long long heartbeat_ms = 1000;           // How often workers report in
+    long long heartbeat_timeout_ms = 10000;  // Silence after which a shard is reassigned
+    int max_attempts = 3;                    // Workers a shard may fail on before its jobs fail
+    std::string shared_dir;                  // Non-empty: exchange shards through files here, not TCP
+    int local_workers = 0;                   // Worker processes the coordinator starts itself
+    int local_worker_threads = 0;            // Threads of each (<= 0: all cores)
+    std::string worker_executable;           // The backtester binary, for local workers
+
+    static DistributedOptions fromConfig(const json& config);
+};
+
+// Splits a sweep into shards of jobs and hands them to worker processes,
+// on this machine or others, then merges their results.
+//
+// TCP transport: newline-delimited JSON messages.
+//   worker -> coordinator  {"type":"hello","worker":name,"threads":n}
+//   coordinator -> worker  {"type":"config","config":base,"heartbeat_ms":ms}
+//   coordinator -> worker  {"type":"shard","shard":k,"jobs":[{"id","patch"},...]}
+//   worker -> coordinator  {"type":"heartbeat"}, every heartbeat_ms
+//   worker -> coordinator  {"type":"result","shard":k,"results":[...]}
+//   coordinator -> worker  {"type":"done"}
+// A worker holds one shard at a time and runs its jobs in parallel.
+//
+// Shared-directory transport, for nodes that share a filesystem but cannot
+// reach the coordinator: shards are files in <dir>/pending. A worker claims
+// one by renaming it into <dir>/claimed, touches the claimed file as its
+// heartbeat and renames its results into <dir>/results. <dir>/done marks the
+// end of the sweep.
+//
+// Either way, a shard whose worker disconnects or goes silent for
+// heartbeat_timeout_ms goes back to the queue, up to max_attempts times.
+//
+// The protocol has no authentication and hands the whole config to any
+// client, so the coordinator listens on loopback unless told otherwise.
+class SweepCoordinator {
+public:
+    SweepCoordinator(const json& base_config, std::vector<BatchJob> jobs, const DistributedOptions& options);
+
+    // Serves shards until every job has a result. Results come back in the
+    // order of the jobs.
+    std::vector<BatchResult> run();
+
+    // Called on the coordinator's thread with each result as soon as it is
+    // known, so a caller can save it before the sweep ends.
+    void onResult(std::function<void(const BatchResult&)> callback) { on_result_ = std::move(callback); }
+    // Called with the TCP port once the coordinator listens (port 0 picks one).
+    void onListening(std::function<void(unsigned short)> callback) { on_listening_ = std::move(callback); }
+
+    // One job per point of the "optimization" block's param_ranges grid,
+    // applied to strategy_to_optimize.
+    static std::vector<BatchJob> optimizationJobs(const json& config);
+    // One job per simulation of the "monte_carlo" block, with the parameters
+    // MonteCarloSimulator would draw.
+    static std::vector<BatchJob> monteCarloJobs(const json& config, int num_simulations);
+
+private:
+    std::vector<BatchResult> runTcp();
+    std::vector<BatchResult> runSharedDirectory();
+
+    json base_config_;
+    std::vector<BatchJob> jobs_;
+    DistributedOptions options_;
+    std::function<void(const BatchResult&)> on_result_;
+    std::function<void(unsigned short)> on_listening_;
+};
+
+// Runs shards for a SweepCoordinator until it reports the sweep done.
+class SweepWorker {
+public:
+    SweepWorker(const DistributedOptions& options, int threads);
+
+    // Connects to the coordinator at host:port, retrying for up to
+    // connect_timeout_ms while it starts up.
+    void runTcp(const std::string& host, unsigned short port, long long connect_timeout_ms = 30000);
+    // Claims shards from options.shared_dir.
+    void runSharedDirectory();
+
+private:
+    std::vector<BatchResult> runShard(const json& base_config, const std::vector<BatchJob>& jobs);
+
+    DistributedOptions options_;
+    int threads_;
+    std::string name_;
+};
+
+#endif // DISTRIBUTED_SWEEP_H
@@ -0,0 +1,60 @@
+#ifndef ENGINE_LANE_H
+#define ENGINE_LANE_H
+
+#include <memory>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "../data/DataHandler.h"
+#include "../event/Event.h"
+#include "../event/ThreadSafeQueue.h"
+#include "../execution/ExecutionHandler.h"
+#include "../risk/RiskManager.h"
+#include "../strategy/Strategy.h"
+#include "Portfolio.h"
+
+// Hands a market data event (market, trade, order book or regime change) to
+// the strategies; returns false for any other event type.
+bool dispatchToStrategies(const std::shared_ptr<Event>& event,
+                          const std::vector<std::shared_ptr<Strategy>>& strategies);
+
+// Routes one event to the components of an engine: market data to the
+// strategies, signals to risk, orders to execution, fills to the portfolio.
+// Shared by Backtester and EngineLane so both trade identically.
+void dispatchEvent(const std::shared_ptr<Event>& event,
+                   const std::vector<std::shared_ptr<Strategy>>& strategies,
+                   Portfolio& portfolio,
+                   RiskManager& risk_manager,
+                   ExecutionHandler& execution_handler);
+
+// The trading state of one engine (active strategies of `config`, portfolio,
+// risk manager and simulated execution) on its own event queue. Lanes fed by
+// the same replay share the DataHandler, which they only read, and nothing else.
+class EngineLane {
+public:
+    EngineLane(const nlohmann::json& config, std::shared_ptr<DataHandler> data_handler);
+
+    // Handles one market data event and everything it sets off in this lane
+    // (signals, orders, fills) before returning.
+    void process(const std::shared_ptr<Event>& event);
+
+    std::shared_ptr<Portfolio> getPortfolio() const { return portfolio_; }
+    // Events handled, counted as Backtester::eventCount() counts them.
+    long long eventCount() const { return event_count_; }
+    bool isActive() const { return active_; }
+    void retire() { active_ = false; } // Stop feeding the lane (e.g. on a hard stop)
+
+private:
+    void handle(const std::shared_ptr<Event>& event);
+
+    std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> event_queue_;
+    std::shared_ptr<DataHandler> data_handler_;
+    std::vector<std::shared_ptr<Strategy>> strategies_;
+    std::shared_ptr<Portfolio> portfolio_;
+    std::shared_ptr<ExecutionHandler> execution_handler_;
+    std::shared_ptr<RiskManager> risk_manager_;
+    long long event_count_ = 0;
+    bool active_ = true;
+};
+
+#endif // ENGINE_LANE_H
@@ -0,0 +1,83 @@
+#ifndef EQUITY_RECORDER_H
+#define EQUITY_RECORDER_H
+
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "../data/DataTypes.h"
+#include "Checkpoint.h"
+
+using json = nlohmann::json;
+
+using EquityPoint = std::tuple<long long, double, MarketState>; // (time, equity, market state)
+
+// Which equity points a run keeps ("equity_curve" config block).
+struct EquityResolution {
+    enum class Mode {
+        EVERY_EVENT, // "every_event": all of them (default)
+        EVERY_N,     // "every_n": one in every_n
+        INTERVAL,    // "interval": at most one per interval_ms of event time
+        ON_CHANGE    // "on_change": when equity moves more than min_change (relative)
+    };
+    Mode mode = Mode::EVERY_EVENT;
+    long long every_n = 1;
+    long long interval_ms = 1000;
+    double min_change = 0.0;
+    size_t export_points = 0; // > 0: CSV exports are LTTB-downsampled to this many points
+
+    static EquityResolution fromConfig(const json& config);
+};
+
+// An equity curve that does not grow by a tuple per tick. Points are kept at
+// the configured resolution, always including market state changes and the
+// latest point, and stored delta-encoded: the time as a varint delta, the
+// equity as the XOR of its bits with the previous value's (zero for an
+// unchanged equity, short when only low mantissa bits move), the market
+// state only when it changes. Typically 3-6 bytes a point instead of 40.
+// Peak and drawdown are left to Portfolio's RunMetricsAccumulator, which
+// sees every point, kept or not.
+class EquityRecorder {
+public:
+    explicit EquityRecorder(const EquityResolution& resolution = EquityResolution());
+
+    void setResolution(const EquityResolution& resolution) { resolution_ = resolution; }
+    const EquityResolution& resolution() const { return resolution_; }
+
+    void record(long long time, double equity, const MarketState& state);
+    void clear();
+
+    size_t size() const { return kept_ + (has_tail_ ? 1 : 0); }
+    long long offered() const { return offered_; }
+    size_t encodedBytes() const { return data_.bytes().size(); }
+
+    // The kept points, decoded.
+    std::vector<EquityPoint> points() const;
+    // The kept points reduced to `threshold` for plotting (Largest Triangle
+    // Three Buckets); all of them if there are no more than that.
+    std::vector<EquityPoint> downsample(size_t threshold) const;
+    static std::vector<EquityPoint> lttb(const std::vector<EquityPoint>& points, size_t threshold);
+
+    void saveState(StateWriter& out) const;
+    void loadState(StateReader& in);
+
+private:
+    bool keep(long long time, double equity, const MarketState& state) const;
+    void append(long long time, double equity, const MarketState& state);
+
+    EquityResolution resolution_;
+    StateWriter data_;
+    size_t kept_ = 0;
+    long long offered_ = 0;
+    // Last kept point, the base of the next delta
+    long long last_time_ = 0;
+    double last_equity_ = 0.0;
+    MarketState last_state_;
+    // Latest point offered but not kept
+    bool has_tail_ = false;
+    EquityPoint tail_;
+};
+
+#endif // EQUITY_RECORDER_H
@@ -0,0 +1,54 @@
+#ifndef FAN_OUT_ENGINE_H
+#define FAN_OUT_ENGINE_H
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "EngineLane.h"
+#include "Optimizer.h"
+
+// Sweeps many parameter sets of one strategy in a single pass over the data:
+// one historical replay is decoded and merged once, and every market event
+// is handed to one EngineLane per parameter set. Lanes keep their own
+// strategies, portfolio, risk and execution state, so each lane trades
+// exactly as a separate Backtester with those parameters would, but the
+// replay cost is paid once for all of them.
+//
+// Lanes run one after another on the calling thread; to use more cores,
+// give each thread its own FanOutEngine over a share of the parameter sets.
+class FanOutEngine {
+public:
+    FanOutEngine(const json& base_config,
+                 const std::string& strategy_name,
+                 const std::vector<json>& parameter_sets);
+
+    // Checked every `every_events` replayed events for each active lane;
+    // returning true retires that lane (it keeps its results so far).
+    void setStopCondition(std::function<bool(size_t lane, const Portfolio&)> condition, long long every_events);
+
+    void run();
+
+    size_t size() const { return lanes_.size(); }
+    const EngineLane* lane(size_t i) const { return lanes_[i].get(); } // Null if it failed to build
+    long long eventsReplayed() const { return events_replayed_; }
+
+    // One result per parameter set, in order: Sharpe ratio and total return
+    // of each lane, or the error that kept it from running.
+    std::vector<ParameterResult> results() const;
+
+private:
+    std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> feed_;
+    std::shared_ptr<DataHandler> data_handler_;
+    std::vector<std::unique_ptr<EngineLane>> lanes_;
+    std::vector<json> parameter_sets_;
+    std::vector<std::string> errors_;
+    std::vector<bool> stopped_;
+    std::function<bool(size_t, const Portfolio&)> stop_condition_;
+    long long stop_check_interval_ = 0;
+    long long events_replayed_ = 0;
+};
+
+#endif // FAN_OUT_ENGINE_H
@@ -11,6 +11,11 @@ public:
     MonteCarloSimulator(const json& config);
     void run(int num_simulations);
 
+    // Parameters of each simulation, drawn from the "monte_carlo" block's
+    // randomization_ranges around base_params. Simulation i uses Philox
+    // stream i of "seed", so the draws don't depend on who runs them.
+    static std::vector<json> parameterSets(const json& mc_params, int num_simulations);
+
 private:
     json config_;
     json mc_params_;
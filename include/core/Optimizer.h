@@ -1,6 +1,8 @@
 #ifndef OPTIMIZER_H
 #define OPTIMIZER_H
 
+#include "ParameterSearch.h"
+#include "RunMetrics.h"
 #include <nlohmann/json.hpp>
 #include <string>
 #include <vector>
@@ -9,6 +11,33 @@
 
 using json = nlohmann::json;
 
+// Outcome of one backtest in a parameter sweep.
+struct ParameterResult {
+    json params;
+    double metric = -std::numeric_limits<double>::infinity(); // Sharpe ratio
+    bool ok = false;
+    bool stopped_early = false; // Abandoned on a hard stop
+    double fidelity = 1.0;      // Fraction of the data range the metric covers
+    double total_return = 0.0;
+    RunMetrics metrics;         // Of the full run, when ok
+    std::string error;
+};
+
+// How each backtest of a sweep is run.
+struct EvaluationOptions {
+    int max_threads = 0;             // <= 0: all cores
+    long long window_start_ms = 0;   // Replay window within the date range; 0 = open
+    long long window_end_ms = 0;
+    // Hard stops, checked every check_every_events events; 0 disables a check.
+    double max_drawdown = 0.0;
+    double min_sharpe = -std::numeric_limits<double>::infinity();
+    long long min_points_for_sharpe = 500; // Interim Sharpe is noise before this
+    long long check_every_events = 5000;
+    // Replay the data once per thread and feed every parameter set of that
+    // thread's share from it (FanOutEngine), instead of once per set.
+    bool fan_out = false;
+};
+
 class Optimizer {
 public:
     Optimizer(const json& config);
@@ -16,14 +45,72 @@ public:
     json getBestParams() const;
     double getBestMetric() const;
 
-private:
-    void generate_param_combinations(
-        json::const_iterator current_param,
-        json::const_iterator end_param,
-        json& current_combination,
-        std::vector<json>& all_combinations
-    );
+    // One backtest of `base_config` with `params` applied to `strategy_name`.
+    // Errors are reported in the result rather than thrown.
+    static ParameterResult evaluate(
+        const json& base_config,
+        const std::string& strategy_name,
+        const json& params,
+        const EvaluationOptions& options = EvaluationOptions());
+
+    // Backtests `base_config` once per parameter set, with the params applied
+    // to `strategy_name`, on up to `max_threads` threads (<= 0: all cores).
+    // Each run gets its own engine; market data is shared through the
+    // DatasetCache. Results come back in the order of `parameter_sets`.
+    static std::vector<ParameterResult> evaluateParameterSets(
+        const json& base_config,
+        const std::string& strategy_name,
+        const std::vector<json>& parameter_sets,
+        int max_threads = 0);
+    static std::vector<ParameterResult> evaluateParameterSets(
+        const json& base_config,
+        const std::string& strategy_name,
+        const std::vector<json>& parameter_sets,
+        const EvaluationOptions& options);
 
+    // Searches `space` with the method named by the "search" key of the
+    // optimization block: "grid" (default) and "successive_halving" evaluate
+    // the whole grid; "random", "lhs", "bayesian" and "cmaes" sample it
+    // adaptively (see adaptiveSearch). "fan_out": true evaluates each batch
+    // with one data replay per thread.
+    static std::vector<ParameterResult> search(
+        const json& base_config,
+        const std::string& strategy_name,
+        const ParameterSpace& space,
+        const json& optimization_config);
+
+    // Successive halving over time slices: every candidate runs on the first
+    // 1/eta^R of the data, the best 1/eta move on to eta times as much, and so
+    // on until the survivors run on the full range. Runs that breach a hard
+    // stop are abandoned on the spot; the surviving-quantile cut is made at
+    // the end of each rung, not mid-run. Settings come from the optional
+    // "successive_halving" block: eta, rungs, max_drawdown, min_sharpe,
+    // check_every_events.
+    static std::vector<ParameterResult> successiveHalving(
+        const json& base_config,
+        const std::string& strategy_name,
+        const std::vector<json>& parameter_sets,
+        const json& optimization_config);
+
+    // Ask/tell loop of a SearchStrategy: each batch of proposals is backtested
+    // in parallel and the scores are fed back before the next batch. Points
+    // that decode to parameters already tried reuse the earlier score. Stops
+    // after "max_evaluations" backtests (default: 10% of the grid, or 20 per
+    // parameter for continuous ranges). Other settings: "batch_size" (default:
+    // thread count), "seed", and strategy options in a block named after the
+    // method, e.g. "bayesian": {"initial_points": 8}. Results come back in
+    // evaluation order.
+    static std::vector<ParameterResult> adaptiveSearch(
+        const json& base_config,
+        const std::string& strategy_name,
+        const ParameterSpace& space,
+        const json& optimization_config);
+
+    // Index of the best successful result at the highest fidelity reached
+    // (first one on ties), or -1.
+    static int bestResultIndex(const std::vector<ParameterResult>& results);
+
+private:
     json config_;
     json optimization_params_;
     json best_params_;
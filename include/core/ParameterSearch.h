@@ -0,0 +1,68 @@
+#ifndef PARAMETER_SEARCH_H
+#define PARAMETER_SEARCH_H
+
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+using json = nlohmann::json;
+
+// The parameters an optimisation may vary, parsed from "param_ranges". Each
+// parameter can be written as
+//   "name": [v1, v2, ...]                         listed values
+//   "name": {"min": a, "max": b}                  continuous range
+//   "name": {"min": a, "max": b, "step": s}       stepped range
+//   "name": {"min": a, "max": b, "integer": true} integer range
+//   "name_start"/"name_end"/"name_step": ...      stepped range (UI format)
+//   "p1_name"/"p1_start"/"p1_end"/"p1_step", p2_... (legacy format)
+// Search strategies work on the unit cube; decode() maps a point of it to
+// parameter values.
+class ParameterSpace {
+public:
+    struct Dimension {
+        std::string name;
+        std::vector<json> values; // Discrete choices; empty for a continuous range
+        double low = 0.0;
+        double high = 0.0;
+        bool integer = false;
+    };
+
+    static ParameterSpace fromConfig(const json& param_ranges);
+
+    size_t size() const { return dimensions_.size(); }
+    const std::vector<Dimension>& dimensions() const { return dimensions_; }
+
+    json decode(const std::vector<double>& point) const;
+    // Canonical point of the values `point` decodes to (centre of a discrete
+    // choice's cell), so that equal parameters have equal points.
+    std::vector<double> snap(const std::vector<double>& point) const;
+
+    // Every combination, first parameter outermost. Empty if a range is continuous.
+    std::vector<json> grid() const;
+    // Number of grid points; 0 if a range is continuous.
+    size_t gridSize() const;
+
+private:
+    std::vector<Dimension> dimensions_;
+};
+
+// Ask/tell interface of a black-box search over the unit cube. Scores are
+// maximised; NaN marks a failed evaluation.
+class SearchStrategy {
+public:
+    virtual ~SearchStrategy() = default;
+    virtual std::string name() const = 0;
+    // Proposes up to `batch` points to evaluate together. Population-based
+    // strategies (CMA-ES) return their own population size instead.
+    virtual std::vector<std::vector<double>> ask(size_t batch) = 0;
+    virtual void tell(const std::vector<std::vector<double>>& points, const std::vector<double>& scores) = 0;
+};
+
+// "random", "lhs" (Latin hypercube), "bayesian" (Gaussian process with
+// expected improvement) or "cmaes". Throws std::invalid_argument otherwise.
+std::unique_ptr<SearchStrategy> makeSearchStrategy(const std::string& name, size_t dimensions,
+                                                   uint64_t seed, const json& options = json::object());
+
+#endif // PARAMETER_SEARCH_H
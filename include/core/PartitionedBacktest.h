@@ -0,0 +1,52 @@
+#ifndef PARTITIONED_BACKTEST_H
+#define PARTITIONED_BACKTEST_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "Portfolio.h"
+
+using json = nlohmann::json;
+
+// Splits a multi-symbol backtest into groups of symbols that no strategy
+// spans, replays every group on its own thread with its own Backtester and
+// sub-portfolio, and merges the sub-portfolios by market time
+// (Portfolio::merge). A strategy that trades several symbols, such as
+// PAIRS_TRADING, keeps all of them in one group.
+//
+// Each group trades its share of the capital on its own, so position
+// sizing follows the group's equity rather than the whole account's.
+class PartitionedBacktest {
+public:
+    struct Partition {
+        std::vector<std::string> symbols;    // In the order of the config's "symbols"
+        json strategies = json::array();     // Active strategy configs trading them
+        double initial_capital = 0.0;        // Split in proportion to the strategies
+    };
+
+    // Union-find over `config`'s symbols: each active strategy joins its
+    // "symbol" and "symbols". Groups without an active strategy are dropped.
+    // Groups are ordered by their first symbol in "symbols".
+    static std::vector<Partition> partition(const json& config);
+
+    // "partitioned": {"max_threads": N} caps the threads (default: all cores).
+    explicit PartitionedBacktest(const json& config);
+
+    // Runs every partition and returns the merged portfolio. Throws if a
+    // partition fails.
+    std::shared_ptr<Portfolio> run();
+
+    const std::vector<Partition>& partitions() const { return partitions_; }
+    const std::vector<std::shared_ptr<Portfolio>>& partitionPortfolios() const { return portfolios_; }
+    long long eventCount() const { return event_count_; }
+
+private:
+    json config_;
+    std::vector<Partition> partitions_;
+    std::vector<std::shared_ptr<Portfolio>> portfolios_;
+    long long event_count_ = 0;
+};
+
+#endif // PARTITIONED_BACKTEST_H
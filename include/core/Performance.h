@@ -1,6 +1,7 @@
 #ifndef PERFORMANCE_H
 #define PERFORMANCE_H
 
+#include <cstdint>
 #include <vector>
 #include <numeric>   // For std::accumulate
 #include <cmath>     // For std::sqrt
@@ -8,6 +9,17 @@
 #include <map>       // Required for correlation
 #include "data/DataTypes.h" // <-- FIX: Changed path from "DataTypes.h" to "data/DataTypes.h"
 
+// Distribution of bootstrapped equity paths
+struct MonteCarloSummary {
+    size_t paths = 0;
+    double mean_return = 0.0;
+    double p5_return = 0.0;
+    double p50_return = 0.0;
+    double p95_return = 0.0;
+    double p50_max_drawdown = 0.0;
+    double p95_max_drawdown = 0.0;
+};
+
 class Performance {
 public:
     // Constructor takes the equity curve and initial capital.
@@ -28,7 +40,8 @@ public:
     double calculateVaR(double confidence_level = 0.95) const;
     double calculateBeta(const std::vector<double>& benchmark_returns) const;
     double calculateCorrelation(const std::vector<double>& other_returns) const;
-    void runMonteCarloSimulation(int num_simulations) const;
+    // Same seed, same result, on any number of threads (<= 0: all cores)
+    MonteCarloSummary runMonteCarloSimulation(int num_simulations, uint64_t seed = 42, int max_threads = 0) const;
 
 private:
     std::vector<double> equity_curve_;
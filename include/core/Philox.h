@@ -0,0 +1,77 @@
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <array>
+#include <cstdint>
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel random
+// numbers: as easy as 1, 2, 3"). Output is a pure function of (seed, stream,
+// position), so giving every Monte Carlo path its own stream makes results
+// independent of how paths are spread over threads.
+//
+// uniform() and below() are defined here rather than through <random>
+// distributions, whose algorithms differ between standard libraries, so
+// results are bit-identical on every platform.
+class Philox4x32 {
+public:
+    using result_type = uint32_t;
+    using Block = std::array<uint32_t, 4>;
+
+    Philox4x32(uint64_t seed, uint64_t stream)
+        : key_{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)},
+          counter_{0, 0, static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32)} {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT32_MAX; }
+
+    result_type operator()() {
+        if (index_ == 4) {
+            block_ = generate(counter_, key_);
+            if (++counter_[0] == 0) ++counter_[1];
+            index_ = 0;
+        }
+        return block_[index_++];
+    }
+
+    // Uniform double in [0, 1) with 53 random bits
+    double uniform() {
+        const uint64_t hi = (*this)();
+        const uint64_t lo = (*this)();
+        return static_cast<double>(((hi << 32) | lo) >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // Uniform integer in [0, n), unbiased (Lemire's multiply-and-reject)
+    uint32_t below(uint32_t n) {
+        uint64_t m = static_cast<uint64_t>((*this)()) * n;
+        uint32_t low = static_cast<uint32_t>(m);
+        if (low < n) {
+            const uint32_t threshold = static_cast<uint32_t>(-n) % n;
+            while (low < threshold) {
+                m = static_cast<uint64_t>((*this)()) * n;
+                low = static_cast<uint32_t>(m);
+            }
+        }
+        return static_cast<uint32_t>(m >> 32);
+    }
+
+    // The ten-round bijection itself
+    static Block generate(Block counter, std::array<uint32_t, 2> key) {
+        for (int round = 0; round < 10; ++round) {
+            const uint64_t p0 = static_cast<uint64_t>(0xD2511F53u) * counter[0];
+            const uint64_t p1 = static_cast<uint64_t>(0xCD9E8D57u) * counter[2];
+            counter = {static_cast<uint32_t>(p1 >> 32) ^ counter[1] ^ key[0], static_cast<uint32_t>(p1),
+                       static_cast<uint32_t>(p0 >> 32) ^ counter[3] ^ key[1], static_cast<uint32_t>(p0)};
+            key[0] += 0x9E3779B9u;
+            key[1] += 0xBB67AE85u;
+        }
+        return counter;
+    }
+
+private:
+    std::array<uint32_t, 2> key_;
+    Block counter_;
+    Block block_{};
+    int index_ = 4;
+};
+
+#endif // PHILOX_H
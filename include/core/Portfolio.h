@@ -11,6 +11,9 @@
 #include "../data/DataHandler.h"
 #include "../core/Performance.h"
 #include "../strategy/MarketRegimeDetector.h"
+#include "Checkpoint.h"
+#include "EquityRecorder.h"
+#include "RunMetrics.h"
 
 // Represents our holding in a single asset.
 struct Position {
@@ -37,7 +40,39 @@ public:
     void onFill(const FillEvent& fill);
     void onMarket(const MarketEvent& market);
     void onMarketRegimeChanged(const MarketRegimeChangedEvent& event);
+    // Records an equity point. Positions are marked incrementally: each keeps
+    // its last market value and a running total of them is kept, so this is
+    // O(1) however many positions are open.
     void updateTimeIndex();
+    // Re-marks the position in `symbol` at its latest price, if there is one.
+    void markPosition(const std::string& symbol);
+    // Handles one engine event's market data: stamps the time, re-marks the
+    // symbol whose price it moved and records an equity point.
+    void markToMarket(const Event& event);
+    // Time of the latest market data handled; equity points are stamped with
+    // it instead of the wall clock once set. Values <= 0 are ignored.
+    void setMarketTime(long long timestamp_ms) { if (timestamp_ms > 0) market_time_ = timestamp_ms; }
+
+    // Combines the portfolios of independent partitions of one backtest
+    // (disjoint symbols and strategies) into one. Equity points are merged by
+    // market time, partition order breaking ties; each point carries the sum
+    // of every partition's latest equity. Trades are merged by entry time.
+    // The result is for reporting only: it has no queue or data handler.
+    static std::shared_ptr<Portfolio> merge(const std::vector<std::shared_ptr<Portfolio>>& parts);
+
+    // Cash, holdings, equity curve and trade logs, for checkpoints.
+    void saveState(StateWriter& out) const;
+    void loadState(StateReader& in);
+    long long marketTime() const { return market_time_; }
+
+    // Headless runs only need runMetrics(): without the curve, memory stays
+    // flat however long the replay. Reports and checkpoints need the curve.
+    void setEquityCurveEnabled(bool enabled) { equity_curve_enabled_ = enabled; }
+    // Which points the curve keeps ("equity_curve" config block).
+    void setEquityResolution(const EquityResolution& resolution) { equity_curve_.setResolution(resolution); }
+    const EquityRecorder& equityRecorder() const { return equity_curve_; }
+    // Kept up to date with every equity point, curve or no curve.
+    RunMetrics runMetrics() const { return metrics_.metrics(initial_capital_, trade_log_.size()); }
 
     // --- Performance & Reporting ---
     void generateReport();
@@ -47,7 +82,8 @@ public:
     // --- Getters ---
     double get_total_equity() const;
     double getInitialCapital() const { return initial_capital_; }
-    const std::vector<std::tuple<long long, double, MarketState>>& getEquityCurve() const;
+    // The kept points, decoded from the recorder.
+    std::vector<EquityPoint> getEquityCurve() const;
     std::string getPositionDirection(const std::string& symbol) const;
     double get_position(const std::string& symbol) const;
     double get_last_price(const std::string& symbol) const;
@@ -63,17 +99,19 @@ private:
     double initial_capital_;
     double current_cash_;
     double total_equity_;
-    double peak_equity_;
-    double max_drawdown_;
+    double holdings_value_ = 0.0; // Sum of the positions' market values
 
     std::map<std::string, Position> holdings_;
-    std::vector<std::tuple<long long, double, MarketState>> equity_curve_;
+    EquityRecorder equity_curve_;
     std::vector<Trade> trade_log_; 
     std::map<std::string, std::vector<Trade>> strategy_trade_log_;
 
     std::shared_ptr<DataHandler> data_handler_;
     std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> event_queue_;
     MarketState current_market_state_;
+    long long market_time_ = 0;
+    bool equity_curve_enabled_ = true;
+    RunMetricsAccumulator metrics_;
 
     void generateTradeLevelReport() const;
 };
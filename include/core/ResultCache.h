@@ -0,0 +1,77 @@
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <cstdint>
+#include <ios>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#include "RunMetrics.h"
+
+using json = nlohmann::json;
+
+class Backtester;
+class EngineLane;
+
+// What a finished run leaves in the ResultCache.
+struct CachedRun {
+    RunMetrics metrics;
+    long long events = 0;
+    std::vector<std::pair<long long, double>> equity; // (timestamp, equity); only with store_equity
+};
+
+// Results of earlier backtests, so that a sweep meeting a run it (or an
+// earlier session) has already done gets the answer without a replay.
+//
+// A run is keyed by the SHA-256 of its effective config, less the settings
+// that only decide how it executes (threads, logging, checkpoints, the sweep
+// blocks), together with the size and modification time of every data file
+// it reads, so edited data misses. Entries are appended as JSON lines to a
+// local file that any number of runs and processes share; a process picks up
+// the others' entries when it misses.
+//
+// "result_cache" config block: "enabled", "path" (default
+// result_cache.jsonl), "store_equity" (also keep the equity curve; runs then
+// record it, which costs memory).
+class ResultCache {
+public:
+    // The cache named by the result_cache block of `config`, shared by every
+    // caller in the process with the same path and store_equity; null when
+    // disabled.
+    static ResultCache* forConfig(const json& config);
+
+    explicit ResultCache(const std::string& path, bool store_equity = false);
+
+    // Hex SHA-256 identifying what a run of `run_config` computes.
+    static std::string key(const json& run_config);
+    // Outcome of a finished run; its equity curve if the run recorded one.
+    static CachedRun capture(const Backtester& backtester);
+    static CachedRun capture(const EngineLane& lane);
+
+    // The equity curve is only read back if asked for.
+    std::optional<CachedRun> find(const std::string& key, bool with_equity = false);
+    void store(const std::string& key, const CachedRun& run);
+
+    bool storesEquity() const { return store_equity_; }
+    uint64_t hits() const;
+    uint64_t misses() const;
+    size_t size() const;
+
+private:
+    void scan(); // Caller holds mutex_; indexes lines appended since the last scan
+
+    std::string path_;
+    bool store_equity_;
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::streamoff> index_; // Key -> offset of its line
+    std::streamoff scanned_ = 0;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
+
+#endif // RESULT_CACHE_H
@@ -0,0 +1,95 @@
+#ifndef RUN_METRICS_H
+#define RUN_METRICS_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+#include "Checkpoint.h"
+
+// The scalars a parameter sweep needs from a run. Same definitions as
+// Performance: per-point returns, sample standard deviation, Sharpe ratio
+// annualised with sqrt(252), drawdown from the first point's peak.
+struct RunMetrics {
+    long long points = 0;      // Equity points
+    double final_equity = 0.0;
+    double total_return = 0.0;
+    double max_drawdown = 0.0;
+    double sharpe = 0.0;
+    size_t trades = 0;
+};
+
+// Builds RunMetrics one equity point at a time (Welford's update for the
+// return variance), so nothing has to keep the equity curve around.
+class RunMetricsAccumulator {
+public:
+    void add(double equity) {
+        if (points_ == 0) {
+            peak_ = equity;
+        } else if (last_ != 0.0) {
+            const double r = equity / last_ - 1.0;
+            ++returns_;
+            const double delta = r - mean_;
+            mean_ += delta / returns_;
+            m2_ += delta * (r - mean_);
+        }
+        ++points_;
+        last_ = equity;
+        if (equity > peak_) {
+            peak_ = equity;
+        } else if (peak_ > 0.0) {
+            max_drawdown_ = std::max(max_drawdown_, (peak_ - equity) / peak_);
+        }
+    }
+
+    void reset() { *this = RunMetricsAccumulator(); }
+
+    void saveState(StateWriter& out) const {
+        out.put(points_);
+        out.put(returns_);
+        out.put(last_);
+        out.put(peak_);
+        out.put(max_drawdown_);
+        out.put(mean_);
+        out.put(m2_);
+    }
+    void loadState(StateReader& in) {
+        points_ = in.get<long long>();
+        returns_ = in.get<long long>();
+        last_ = in.get<double>();
+        peak_ = in.get<double>();
+        max_drawdown_ = in.get<double>();
+        mean_ = in.get<double>();
+        m2_ = in.get<double>();
+    }
+
+    long long points() const { return points_; }
+    double maxDrawdown() const { return max_drawdown_; }
+    double sharpe() const {
+        if (returns_ < 2) return 0.0;
+        const double std_dev = std::sqrt(m2_ / (returns_ - 1));
+        return std_dev < 1e-9 ? 0.0 : mean_ / std_dev * std::sqrt(252.0);
+    }
+
+    RunMetrics metrics(double initial_capital, size_t trades) const {
+        RunMetrics metrics;
+        metrics.points = points_;
+        metrics.final_equity = points_ > 0 ? last_ : initial_capital;
+        metrics.total_return = points_ > 0 && initial_capital != 0.0 ? last_ / initial_capital - 1.0 : 0.0;
+        metrics.max_drawdown = max_drawdown_;
+        metrics.sharpe = sharpe();
+        metrics.trades = trades;
+        return metrics;
+    }
+
+private:
+    long long points_ = 0;
+    long long returns_ = 0;
+    double last_ = 0.0;
+    double peak_ = 0.0;
+    double max_drawdown_ = 0.0;
+    double mean_ = 0.0;
+    double m2_ = 0.0;
+};
+
+#endif // RUN_METRICS_H
@@ -0,0 +1,86 @@
+#ifndef STRATEGY_RUNTIME_H
+#define STRATEGY_RUNTIME_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "../event/Event.h"
+#include "../event/SpscQueue.h"
+#include "../event/ThreadSafeQueue.h"
+#include "../strategy/Strategy.h"
+
+// Runs every strategy on its own worker thread, pinned to its own core when
+// asked. The engine publishes market data into each worker's bounded SPSC
+// inbox, so a slow strategy no longer holds up the others.
+//
+// Deterministic mode (backtests): every strategy was built with a private
+// outbox queue. collect() waits until the workers have handled everything
+// published so far, then pushes their output to the engine queue in the
+// order the serial engine would have produced it: by event, then by
+// strategy. A full inbox makes publish() wait.
+//
+// Async mode (live): strategies were built with the engine queue itself
+// and push their signals straight into it (it is MPSC). A full inbox drops
+// the event for that strategy and counts it.
+class StrategyRuntime {
+public:
+    enum class Mode { Deterministic, Async };
+
+    using EventQueuePtr = std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>>;
+
+    // outboxes[i] is the queue strategies[i] was constructed with.
+    StrategyRuntime(const std::vector<std::shared_ptr<Strategy>>& strategies,
+                    const std::vector<EventQueuePtr>& outboxes,
+                    Mode mode,
+                    size_t inbox_capacity = 4096,
+                    bool pin_threads = true);
+    ~StrategyRuntime();
+
+    StrategyRuntime(const StrategyRuntime&) = delete;
+    StrategyRuntime& operator=(const StrategyRuntime&) = delete;
+
+    // Engine thread only. Ignores events that are not market data.
+    void publish(const std::shared_ptr<Event>& event);
+
+    // Deterministic mode: the barrier described above. Returns whether any
+    // event was pushed to `engine_queue`. A no-op in async mode.
+    bool collect(ThreadSafeQueue<std::shared_ptr<Event>>& engine_queue);
+    // Waits until every worker has handled everything published so far, so
+    // the engine thread may touch strategy state (pause/resume) safely.
+    void drain();
+
+    void stop();
+    size_t size() const { return workers_.size(); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Item {
+        uint64_t sequence = 0;
+        std::shared_ptr<Event> event;
+    };
+
+    struct Worker {
+        explicit Worker(size_t inbox_capacity) : inbox(inbox_capacity) {}
+        std::vector<std::shared_ptr<Strategy>> strategy; // One element, for dispatchToStrategies
+        EventQueuePtr outbox;
+        SpscQueue<Item> inbox;
+        std::vector<Item> produced;            // Deterministic output; read by the engine after the barrier
+        alignas(64) std::atomic<uint64_t> handled{0};
+        uint64_t published = 0;                // Engine side
+        std::thread thread;
+    };
+
+    void worker_loop(Worker& worker, size_t index);
+
+    Mode mode_;
+    bool pin_threads_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<bool> stopping_{false};
+    std::atomic<uint64_t> dropped_{0};
+    uint64_t next_sequence_ = 0;
+};
+
+#endif // STRATEGY_RUNTIME_H
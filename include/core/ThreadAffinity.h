@@ -0,0 +1,55 @@
+#ifndef THREAD_AFFINITY_H
+#define THREAD_AFFINITY_H
+
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// Pins the calling thread to one core (modulo the cores available). A no-op
+// where the platform has no affinity call.
+inline void pinCurrentThread(size_t core) {
+#if defined(_WIN32)
+    SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << (core % (sizeof(DWORD_PTR) * 8)));
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core % CPU_SETSIZE, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#else
+    (void)core;
+#endif
+}
+
+// Wait strategy for lock-free consumers and producers: spin briefly, then
+// yield, then sleep, so an idle thread doesn't burn a core while a busy
+// one still answers within nanoseconds.
+class Backoff {
+public:
+    void pause() {
+        ++idle_;
+        if (idle_ < 64) {
+            return;
+        }
+        if (idle_ < 1024) {
+            std::this_thread::yield();
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+    void reset() { idle_ = 0; }
+
+private:
+    unsigned idle_ = 0;
+};
+
+#endif // THREAD_AFFINITY_H
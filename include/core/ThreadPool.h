@@ -0,0 +1,106 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Work-stealing thread pool for coarse, independent tasks such as whole
+// backtests. Every worker has its own deque: it runs its own tasks newest
+// first and, when it runs dry, steals the oldest task from another worker.
+// Tasks submitted from outside the pool are spread round-robin.
+//
+// With quiet_workers set, workers run under a ScopedLogMute and their
+// std::cout output is dropped, so parallel engines don't flood the console.
+class ThreadPool {
+public:
+    // threads == 0 uses every hardware thread.
+    explicit ThreadPool(size_t threads = 0, bool quiet_workers = false);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers_.size(); }
+
+    template <typename F>
+    auto submit(F&& task) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+        using Result = std::invoke_result_t<std::decay_t<F>>;
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> future = packaged->get_future();
+        enqueue([packaged]() { (*packaged)(); });
+        return future;
+    }
+
+    // Runs body(i) for every i in [0, count) and waits for all of them. The
+    // first exception thrown by a task is rethrown here once all have ended.
+    // Callable from inside a task: the waiting worker keeps running tasks.
+    template <typename F>
+    void parallelFor(size_t count, F&& body) {
+        std::vector<std::future<void>> futures;
+        futures.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            futures.push_back(submit([&body, i]() { body(i); }));
+        }
+        std::exception_ptr first_error;
+        for (auto& future : futures) {
+            wait(future);
+            try {
+                future.get();
+            } catch (...) {
+                if (!first_error) first_error = std::current_exception();
+            }
+        }
+        if (first_error) {
+            std::rethrow_exception(first_error);
+        }
+    }
+
+    // Waits for a future of this pool; a worker thread helps out meanwhile
+    // instead of blocking, so nested waits cannot deadlock the pool.
+    template <typename T>
+    void wait(std::future<T>& future) {
+        while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            if (current_pool_ != this || !run_one(current_index_)) {
+                future.wait_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+
+    // Thread count for a "max_threads" setting: <= 0 means all hardware threads.
+    static size_t resolveThreadCount(int requested);
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void enqueue(std::function<void()> task);
+    bool pop_task(size_t index, std::function<void()>& task);
+    bool run_one(size_t index);
+    void worker_loop(size_t index);
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cond_;
+    std::atomic<size_t> pending_{0};
+    std::atomic<size_t> next_queue_{0};
+    std::atomic<bool> stopping_{false};
+    bool quiet_workers_;
+
+    static thread_local ThreadPool* current_pool_;
+    static thread_local size_t current_index_;
+};
+
+#endif // THREAD_POOL_H
@@ -2,17 +2,53 @@
 #define WALK_FORWARD_ANALYZER_H
 
 #include <nlohmann/json.hpp>
+#include <limits>
+#include <string>
+#include <vector>
 
 using json = nlohmann::json;
 
+// In-sample and out-of-sample date ranges (YYYY-MM-DD) of one split.
+struct WalkForwardSplit {
+    std::string in_sample_start;
+    std::string in_sample_end;
+    std::string out_of_sample_start;
+    std::string out_of_sample_end;
+};
+
+struct WalkForwardResult {
+    WalkForwardSplit split;
+    json best_params;
+    double in_sample_sharpe = std::numeric_limits<double>::quiet_NaN();
+    double out_of_sample_sharpe = std::numeric_limits<double>::quiet_NaN();
+    double out_of_sample_return = 0.0;
+    bool ok = false;
+    std::string error;
+};
+
 class WalkForwardAnalyzer {
 public:
     WalkForwardAnalyzer(const json& config);
     void run();
 
+    // Optimises `strategy_name` on every split's in-sample range and backtests
+    // the winner out of sample. With a grid search all (split x parameter set)
+    // runs go to one thread pool at once, and a split's out-of-sample run
+    // starts as soon as its last in-sample run ends. Every run slices the
+    // same parsed dataset from the DatasetCache, so the data is read once.
+    // Adaptive searches run split by split, each parallel internally.
+    // Results come back in the order of `splits`.
+    static std::vector<WalkForwardResult> runSplits(
+        const json& base_config,
+        const std::string& strategy_name,
+        const std::vector<WalkForwardSplit>& splits,
+        const json& optimization_config);
+
+    static void printReport(const std::vector<WalkForwardResult>& results);
+
 private:
     json config_;
     json walk_forward_params_;
 };
 
-#endif // WALK_FORWARD_ANALYZER_H 
\ No newline at end of file
+#endif // WALK_FORWARD_ANALYZER_H
@@ -0,0 +1,53 @@
+#ifndef BINANCE_MESSAGE_PARSER_H
+#define BINANCE_MESSAGE_PARSER_H
+
+#include <cstddef>
+#include <string_view>
+
+// Specialised scanner for the two Binance stream payloads we consume
+// (depthUpdate and trade). It walks the raw frame in place: no DOM, no string
+// copies, decimals parsed with std::from_chars. Both raw payloads and the
+// combined-stream envelope {"stream":..., "data":{...}} are accepted.
+
+enum class BinanceMessageType {
+    UNKNOWN,       // Anything else (e.g. subscription acks)
+    DEPTH_UPDATE,
+    TRADE,
+    MALFORMED
+};
+
+struct BinanceDepthHeader {
+    std::string_view symbol;        // Points into the message buffer
+    long long event_time = 0;       // "E", ms
+    long long first_update_id = 0;  // "U"
+    long long final_update_id = 0;  // "u"
+};
+
+struct BinanceTrade {
+    std::string_view symbol;        // Points into the message buffer
+    long long event_time = 0;       // "E", ms
+    long long trade_time = 0;       // "T", ms
+    long long trade_id = 0;         // "t"
+    double price = 0.0;             // "p"
+    double quantity = 0.0;          // "q"
+    bool buyer_is_maker = false;    // "m": true means the aggressor sold
+};
+
+// Receives the decoded fields. For a depth update the calls are
+// onDepthBegin, every bid level, every ask level, then onDepthEnd; a
+// malformed depth update reaches the sink not at all.
+class BinanceMessageSink {
+public:
+    virtual ~BinanceMessageSink() = default;
+    virtual void onDepthBegin(const BinanceDepthHeader& header) = 0;
+    virtual void onBidLevel(double price, double quantity) = 0;
+    virtual void onAskLevel(double price, double quantity) = 0;
+    virtual void onDepthEnd() = 0;
+    virtual void onTrade(const BinanceTrade& trade) = 0;
+};
+
+// Parses one message and forwards its contents to the sink. The string_views
+// handed to the sink are only valid during the call.
+BinanceMessageType parse_binance_message(const char* data, std::size_t size, BinanceMessageSink& sink);
+
+#endif // BINANCE_MESSAGE_PARSER_H
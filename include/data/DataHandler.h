@@ -11,6 +11,9 @@
 
 using namespace std;
 
+class StateWriter;
+class StateReader;
+
 // The DataHandler is responsible for managing and providing market data.
 // In a multi-asset system, its key job is to update the main event queue
 // with new MarketEvents in correct chronological order.
@@ -42,6 +45,16 @@ public:
     // For event-driven systems, allows external components to know when new data is ready.
     virtual void notifyOnNewData(std::function<void()> callback) = 0;
 
+    // Whether the data arrives in real time rather than from a replay.
+    virtual bool isLiveFeed() const { return false; }
+
+    // Replay position and the state derived from it, for checkpoints
+    // (core/Checkpoint.h). Handlers that cannot be rewound, such as live
+    // feeds, keep these defaults.
+    virtual bool supportsCheckpoints() const { return false; }
+    virtual void saveState(StateWriter&) const {}
+    virtual void loadState(StateReader&) {}
+
 protected:
     std::function<void()> on_new_data_;
 };
@@ -2,8 +2,10 @@
 #define DATATYPES_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <map>
+#include <cstddef>
 
 // Represents the direction of an order/trade
 enum class OrderDirection { BUY, SELL, NONE };
@@ -38,6 +40,35 @@ struct Bar {
     long long volume = 0;
 };
 
+// Read-only columnar view over the bars of one symbol. The columns are not
+// owned; they usually point straight into a memory-mapped bar file and stay
+// valid for as long as that mapping is alive.
+struct BarSeries {
+    std::string_view symbol;
+    const long long* timestamp = nullptr;
+    const double* open = nullptr;
+    const double* high = nullptr;
+    const double* low = nullptr;
+    const double* close = nullptr;
+    const long long* volume = nullptr;
+    size_t size = 0;
+
+    bool empty() const { return size == 0; }
+
+    // Materialises row i as a Bar (copies the symbol and formats the timestamp).
+    Bar bar(size_t i) const {
+        Bar b;
+        b.symbol = std::string(symbol);
+        b.timestamp = std::to_string(timestamp[i]);
+        b.open = open[i];
+        b.high = high[i];
+        b.low = low[i];
+        b.close = close[i];
+        b.volume = volume[i];
+        return b;
+    }
+};
+
 // Represents a single executed trade from the exchange.
 struct Trade {
     std::string symbol;
@@ -5,16 +5,25 @@
 #include "../../include/event/Event.h"
 #include "../../include/event/ThreadSafeQueue.h"
 #include <pqxx/pqxx>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <map>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 #include <memory>
 #include <optional>
 
+// Replays bars from Postgres. Each symbol reads through its own server-side
+// cursor; a background thread fetches chunk N+1 into a columnar buffer while
+// chunk N is being replayed, so updateBars() normally never waits on the database.
 class DatabaseDataHandler : public DataHandler {
 public:
-    DatabaseDataHandler(std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> event_queue, 
+    DatabaseDataHandler(std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> event_queue,
                         const std::string& connection_string,
-                        const std::vector<std::string>& symbols, 
+                        const std::vector<std::string>& symbols,
                         const std::string& start_date,
                         const std::string& end_date);
     ~DatabaseDataHandler();
@@ -25,22 +34,61 @@ public:
     std::optional<Bar> getLatestBar(const std::string& symbol) const override;
     double getLatestBarValue(const std::string& symbol, const std::string& val_type) override;
     std::vector<Bar> getLatestBars(const std::string& symbol, int n = 1) override;
+    std::optional<OrderBook> getLatestOrderBook(const std::string& symbol) const override;
+    const std::vector<std::string>& getSymbols() const override;
+    void notifyOnNewData(std::function<void()> callback) override { on_new_data_ = std::move(callback); }
 
 private:
-    void load_chunk(const std::string& symbol); // Method to load the next batch of data for a symbol
+    // One chunk of bars for a symbol, decoded column by column.
+    struct BarChunk {
+        std::vector<long long> timestamp;
+        std::vector<double> open;
+        std::vector<double> high;
+        std::vector<double> low;
+        std::vector<double> close;
+        std::vector<long long> volume;
+
+        size_t size() const { return timestamp.size(); }
+        void clear();
+        void reserve(size_t n);
+    };
+
+    // Double-buffered read position for one symbol.
+    struct SymbolCursor {
+        std::string cursor_name;
+        BarChunk active;           // Chunk being replayed
+        size_t position = 0;       // Next row in `active`
+        BarChunk prefetched;       // Chunk fetched ahead by the prefetch thread
+        bool prefetched_ready = false;
+        bool exhausted = false;    // The server-side cursor has no more rows
+        std::optional<Bar> latest_bar;
+        std::vector<Bar> history;  // Replayed bars, ring indexed by count; outlives chunk swaps
+        size_t replayed = 0;
+    };
+
+    void prefetch_loop();
+    BarChunk fetch_chunk(pqxx::work& txn, const std::string& cursor_name);
+    // Makes sure `cursor.active` has an unread row, swapping in the prefetched
+    // chunk (and waiting for it if necessary). Caller holds cursors_mutex_.
+    // Rethrows a prefetch failure rather than reporting the end of the data.
+    bool ensure_row(SymbolCursor& cursor, std::unique_lock<std::mutex>& lock);
 
     std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> event_queue_;
     std::unique_ptr<pqxx::connection> conn;
     std::vector<std::string> symbols_;
     std::string start_date_;
     std::string end_date_;
-    
-    // Per-symbol data chunks and iterators
-    std::map<std::string, pqxx::result> data_chunks_;
-    std::map<std::string, pqxx::result::const_iterator> data_iterators_;
-    
-    std::string last_loaded_timestamp_;
+
+    std::map<std::string, SymbolCursor> cursors_;
+    mutable std::mutex cursors_mutex_;
+    std::condition_variable cursors_cond_;
+
+    std::thread prefetch_thread_;
+    std::atomic<bool> stop_prefetch_{false};
+    std::exception_ptr prefetch_error_; // Set by a failed fetch, rethrown to the replay; guarded by cursors_mutex_
+
     const int CHUNK_SIZE = 10000; // Load 10,000 events at a time
+    static constexpr size_t BAR_HISTORY = 256; // Bars kept per symbol for getLatestBars()
 };
 
-#endif // DATABASE_DATA_HANDLER_H
\ No newline at end of file
+#endif // DATABASE_DATA_HANDLER_H
@@ -0,0 +1,114 @@
+#ifndef DATASET_CACHE_H
+#define DATASET_CACHE_H
+
+#include "DataTypes.h"
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Immutable, columnar trades of one symbol as parsed from a trades CSV,
+// sorted by timestamp. Shared read-only between every run that uses the file.
+// The columns live either in this process's heap or in a shared-memory
+// segment published by another process; `storage` keeps them alive.
+struct TradeSeries {
+    std::string symbol;
+    const long long* timestamp = nullptr;
+    const double* price = nullptr;
+    const double* quantity = nullptr;
+    const uint8_t* buyer_aggressor = nullptr; // 1 = "BUY", 0 = "SELL"
+    size_t count = 0;
+    size_t storage_bytes = 0;
+    bool shared = false; // Mapped from a shared segment
+    std::shared_ptr<const void> storage;
+
+    size_t size() const { return count; }
+    size_t bytes() const { return sizeof(TradeSeries) + storage_bytes; }
+    Trade trade(size_t i) const;
+
+    // First index with timestamp >= t
+    size_t lowerBound(long long t) const;
+};
+
+// A [begin, end) range of a shared TradeSeries. Holding the slice keeps the
+// series alive; copying it is cheap.
+struct TradeSlice {
+    std::shared_ptr<const TradeSeries> series;
+    size_t begin = 0;
+    size_t end = 0;
+
+    bool empty() const { return begin >= end; }
+    size_t size() const { return end - begin; }
+    long long timestamp(size_t i) const { return series->timestamp[begin + i]; }
+    double price(size_t i) const { return series->price[begin + i]; }
+    double quantity(size_t i) const { return series->quantity[begin + i]; }
+    bool buyerAggressor(size_t i) const { return series->buyer_aggressor[begin + i] != 0; }
+    Trade trade(size_t i) const { return series->trade(begin + i); }
+};
+
+// Process-wide cache of parsed datasets, so that the many Backtesters built by
+// the optimizer, Monte Carlo and walk-forward parse each file only once.
+//
+// Entries are keyed by path, modification time and size; a changed file is
+// parsed again. A date range selects a sub-range of the shared arrays, so
+// different ranges of one file share a single parse. Series stay alive while
+// any run holds them, and the most recently used ones are kept resident up to
+// a byte budget so that back-to-back runs hit the cache too.
+//
+// With a shared directory set (e.g. /dev/shm, or a hugetlbfs mount), parsed
+// series are also published there as read-only segments plus a JSON manifest,
+// and other processes map them instead of parsing, so a multi-process sweep
+// keeps one copy of the data in memory however many workers it runs.
+class DatasetCache {
+public:
+    static DatasetCache& instance();
+
+    // Trades of `symbol` from the CSV at `path` (timestamp,price,quantity,side;
+    // timestamps in ms), restricted to [start_date, end_date] (YYYY-MM-DD, UTC,
+    // both inclusive, empty = unbounded). Returns an empty slice with a null
+    // series if the file cannot be read.
+    TradeSlice trades(const std::string& symbol, const std::string& path,
+                      const std::string& start_date = "", const std::string& end_date = "");
+
+    void setCapacityBytes(size_t bytes);
+    void setSharedDirectory(const std::string& dir); // Empty disables sharing
+    void clear(); // Releases resident entries; series still held by runs stay alive
+
+    uint64_t hits() const;
+    uint64_t misses() const;
+
+    // Midnight UTC of a YYYY-MM-DD date in ms since epoch; throws on bad input.
+    static long long dateToEpochMs(const std::string& date);
+
+private:
+    DatasetCache() = default;
+
+    struct Key {
+        std::string path;
+        std::string symbol;
+        long long mtime = 0;
+        uintmax_t size = 0;
+        bool operator<(const Key& other) const;
+    };
+
+    static std::shared_ptr<const TradeSeries> parse_trades(const std::string& symbol, const std::string& path);
+    std::shared_ptr<const TradeSeries> map_shared(const Key& key) const;
+    bool publish_shared(const Key& key, const TradeSeries& series) const;
+    std::string segment_name(const Key& key) const;
+    void retain(const std::shared_ptr<const TradeSeries>& series); // Caller holds mutex_
+    void enforce_capacity();                                       // Caller holds mutex_
+
+    mutable std::mutex mutex_;
+    std::map<Key, std::weak_ptr<const TradeSeries>> entries_;
+    std::list<std::shared_ptr<const TradeSeries>> resident_; // Most recently used first
+    size_t resident_bytes_ = 0;
+    size_t capacity_bytes_ = size_t(2) * 1024 * 1024 * 1024;
+    std::string shared_dir_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
+
+#endif // DATASET_CACHE_H
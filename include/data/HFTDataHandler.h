@@ -3,8 +3,10 @@
 
 #include "data/DataHandler.h"
 #include "data/DataTypes.h"
+#include "data/DatasetCache.h"
 #include "../event/ThreadSafeQueue.h"
 #include "../event/Event.h"
+#include <deque>
 #include <fstream>
 #include <unordered_map>
 #include <vector>
@@ -58,6 +60,19 @@ public:
     OrderBook getLatestOrderBookNonOptional(const std::string& symbol);
     Trade getLatestTrade(const std::string& symbol);
 
+    // Restricts replay to trades with start_ms <= timestamp < end_ms (0 leaves
+    // that side open). Call before the first updateBars().
+    void setTimeWindow(long long start_ms, long long end_ms);
+    // First and last trade timestamp over all symbols; {0, 0} if there are none.
+    std::pair<long long, long long> timeSpan() const;
+    // Trades file of `symbol` in a data directory.
+    static std::string tradeFilePath(const std::string& dir, const std::string& symbol);
+
+    bool isLiveFeed() const override { return is_live_feed_; }
+    bool supportsCheckpoints() const override { return !is_live_feed_; }
+    void saveState(StateWriter& out) const override;
+    void loadState(StateReader& in) override;
+
     void connectLiveFeed();
     bool isLive() const { return is_live_feed_.load(); }
     bool isConnected() const { return is_connected_.load(); }
@@ -75,12 +90,24 @@ private:
     std::string book_data_dir_;
     std::string historical_data_fallback_dir_;
 
-    std::unordered_map<std::string, std::vector<Trade>> all_trades_;
+    // Trades are shared through the DatasetCache; only the cursors and the
+    // bars built from the replayed trades belong to this run.
+    std::unordered_map<std::string, TradeSlice> all_trades_;
     std::unordered_map<std::string, std::vector<OrderBook>> all_orderbooks_;
     std::map<std::string, OrderBook> latest_orderbooks_;
 
     std::unordered_map<std::string, size_t> trade_indices_;
     std::unordered_map<std::string, size_t> orderbook_indices_;
+
+    struct TradeBars {
+        std::deque<Bar> bars; // Last one still forming
+        long long bar_open_time = 0;
+        double volume = 0.0;
+    };
+    static constexpr long long BAR_INTERVAL_MS = 60000;
+    static constexpr size_t BAR_HISTORY = 256; // Trade bars kept per symbol, as live
+    std::unordered_map<std::string, TradeBars> trade_bars_;
+    void update_bars_from_trade(const std::string& symbol, long long timestamp, double price, double quantity);
     
     mutable Spinlock data_spinlock_; // STAGE 3: Using spinlock
 
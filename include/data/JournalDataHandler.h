@@ -0,0 +1,73 @@
+#ifndef JOURNAL_DATA_HANDLER_H
+#define JOURNAL_DATA_HANDLER_H
+
+#include "../data/DataHandler.h"
+#include "../data/BinanceMessageParser.h"
+#include "../data/MarketDataJournal.h"
+#include "../event/ThreadSafeQueue.h"
+#include "../event/Event.h"
+#include <deque>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Replays a MarketDataJournal recorded by WebSocketDataHandler. Every record
+// goes through the same Binance parser as the live session and produces the
+// same OrderBookEvent / TradeEvent, stamped with the recorded receive time,
+// so a live session can be reproduced exactly in a backtest.
+class JournalDataHandler : public DataHandler, private BinanceMessageSink {
+public:
+    JournalDataHandler(std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> event_queue,
+                       const std::vector<std::string>& symbols,
+                       const std::string& journal_path,
+                       long long bar_interval_ms = 60000);
+
+    void updateBars() override;
+    bool isFinished() const override;
+    std::optional<Bar> getLatestBar(const std::string& symbol) const override;
+    double getLatestBarValue(const std::string& symbol, const std::string& val_type) override;
+    std::vector<Bar> getLatestBars(const std::string& symbol, int n = 1) override;
+    std::optional<OrderBook> getLatestOrderBook(const std::string& symbol) const override;
+    const std::vector<std::string>& getSymbols() const override;
+    void notifyOnNewData(std::function<void()> callback) override { on_new_data_ = std::move(callback); }
+
+    static constexpr size_t BAR_HISTORY = 256; // Trade bars kept per symbol, as live
+
+private:
+    struct SymbolState {
+        std::map<double, double, std::greater<double>> bids; // Full book, best first
+        std::map<double, double> asks;
+        long long book_timestamp = 0;
+        std::deque<Bar> bars;   // Rolling trade bars, the last one still forming
+        long long bar_open_time = 0;
+        double bar_volume = 0.0;
+    };
+
+    const std::string* find_symbol(std::string_view symbol) const;
+
+    // BinanceMessageSink
+    void onDepthBegin(const BinanceDepthHeader& header) override;
+    void onBidLevel(double price, double quantity) override;
+    void onAskLevel(double price, double quantity) override;
+    void onDepthEnd() override;
+    void onTrade(const BinanceTrade& trade) override;
+
+    std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> event_queue_;
+    std::vector<std::string> symbols_;
+    MarketDataJournalReader reader_;
+    long long bar_interval_ms_;
+    bool finished_ = false;
+
+    std::unordered_map<std::string, SymbolState> states_;
+
+    // Record being replayed
+    long long receive_time_ms_ = 0;
+    const std::string* depth_symbol_ = nullptr;
+    SymbolState* depth_state_ = nullptr;
+    std::shared_ptr<OrderBookEvent> depth_event_;
+    std::shared_ptr<Event> pending_event_;
+};
+
+#endif // JOURNAL_DATA_HANDLER_H
@@ -0,0 +1,131 @@
+#ifndef MARKET_DATA_JOURNAL_H
+#define MARKET_DATA_JOURNAL_H
+
+#include "mio/mio.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+// Append-only binary journal of raw market data messages, as received.
+//
+// Layout: JournalFileHeader, then records of JournalRecordHeader + payload,
+// each padded to 8 bytes. A zero length marks the end of the written data.
+// Records keep the raw frame bytes, so a replay goes through exactly the same
+// parser as the live session.
+
+constexpr uint32_t JOURNAL_MAGIC = 0x4C4A444D; // "MDJL" little-endian
+constexpr uint32_t JOURNAL_VERSION = 1;
+
+enum class JournalRecordKind : uint16_t {
+    BINANCE_RAW = 1 // Raw Binance WebSocket frame (depthUpdate, trade, acks)
+};
+
+struct JournalFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    int64_t created_ns;     // Wall clock, ns since epoch
+    uint64_t reserved[6];
+};
+
+struct JournalRecordHeader {
+    uint32_t length;        // Payload bytes
+    uint16_t kind;          // JournalRecordKind
+    uint16_t flags;
+    uint64_t sequence;      // Per-journal message number; gaps mean dropped messages
+    int64_t receive_time_ns; // Wall clock at receipt, ns since epoch
+};
+
+static_assert(sizeof(JournalFileHeader) == 64, "Journal file header layout changed");
+static_assert(sizeof(JournalRecordHeader) == 24, "Journal record header layout changed");
+
+struct JournalRecord {
+    uint64_t sequence = 0;
+    int64_t receive_time_ns = 0;
+    JournalRecordKind kind = JournalRecordKind::BINANCE_RAW;
+    std::string_view payload; // Points into the mapped file
+};
+
+// Records messages from the network thread without blocking it: append()
+// copies into an in-memory staging ring and a background thread moves the
+// records into the memory-mapped file, growing it one segment at a time.
+// If the ring is full the message is dropped and counted instead.
+class MarketDataJournalWriter {
+public:
+    explicit MarketDataJournalWriter(const std::string& path,
+                                     size_t staging_bytes = 16 * 1024 * 1024,
+                                     size_t segment_bytes = 64 * 1024 * 1024);
+    ~MarketDataJournalWriter();
+
+    MarketDataJournalWriter(const MarketDataJournalWriter&) = delete;
+    MarketDataJournalWriter& operator=(const MarketDataJournalWriter&) = delete;
+
+    // Single producer. Returns false if the message was dropped.
+    bool append(const char* data, size_t size, int64_t receive_time_ns,
+                JournalRecordKind kind = JournalRecordKind::BINANCE_RAW);
+
+    // Stops the writer thread after it has written everything staged, and
+    // trims the file to its written size.
+    void close();
+
+    uint64_t recorded() const { return recorded_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    const std::string& path() const { return path_; }
+
+private:
+    void writer_loop();
+    bool drain();
+    void write_bytes(const char* data, size_t size);
+    void map_segment(size_t min_bytes);
+
+    std::string path_;
+    size_t segment_bytes_;
+
+    // Staging ring: monotonically increasing byte positions, wrapped by mask.
+    std::unique_ptr<char[]> ring_;
+    size_t ring_size_;
+    alignas(64) std::atomic<uint64_t> ring_head_{0}; // Producer
+    alignas(64) std::atomic<uint64_t> ring_tail_{0}; // Writer thread
+    uint64_t next_sequence_ = 0;
+
+    // Mapped window of the file: [map_offset_, map_offset_ + map_.size())
+    mio::mmap_sink map_;
+    size_t map_offset_ = 0;
+    size_t file_size_ = 0;
+    size_t written_ = 0;   // Bytes of valid journal data
+
+    std::thread writer_;
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cond_;
+    std::atomic<bool> pending_{false};
+    std::atomic<bool> running_{true};
+
+    std::atomic<uint64_t> recorded_{0};
+    std::atomic<uint64_t> dropped_{0};
+};
+
+// Sequential reader over a journal file (memory-mapped, zero-copy payloads).
+class MarketDataJournalReader {
+public:
+    explicit MarketDataJournalReader(const std::string& path);
+
+    // Reads the next record; false at the end of the journal.
+    bool next(JournalRecord& record);
+    void rewind() { position_ = sizeof(JournalFileHeader); }
+
+    int64_t createdNs() const { return created_ns_; }
+
+    // True if the file starts with the journal magic.
+    static bool isJournal(const std::string& path);
+
+private:
+    mio::mmap_source map_;
+    size_t position_ = sizeof(JournalFileHeader);
+    int64_t created_ns_ = 0;
+};
+
+#endif // MARKET_DATA_JOURNAL_H
@@ -0,0 +1,59 @@
+#ifndef SNAPSHOT_DATA_HANDLER_H
+#define SNAPSHOT_DATA_HANDLER_H
+
+#include "../data/DataHandler.h"
+#include "../event/Event.h"
+#include <deque>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// What one symbol looked like in the source DataHandler right after an
+// updateBars() call.
+struct MarketSnapshot {
+    std::string symbol;
+    std::optional<Bar> bar;
+    std::optional<OrderBook> book; // Only taken when an order book event was produced
+};
+
+// Read-only DataHandler view for a pipeline stage that runs behind the
+// thread replaying the data. The replay thread captures the state of every
+// symbol it touched after each updateBars() call; the stage applies those
+// snapshots as it reaches the matching events, so its components read the
+// data exactly as a serial run would at that point, however far ahead the
+// replay has got. Each view belongs to one thread.
+class SnapshotDataHandler : public DataHandler {
+public:
+    explicit SnapshotDataHandler(const std::vector<std::string>& symbols);
+
+    // Snapshots of the symbols `events` refer to, read from `source`.
+    static std::vector<MarketSnapshot> capture(DataHandler& source,
+                                               const std::vector<std::shared_ptr<Event>>& events);
+    void apply(const std::vector<MarketSnapshot>& snapshots);
+    void markFinished() { finished_ = true; }
+
+    // Replay happens elsewhere; this view only moves through apply().
+    void updateBars() override {}
+    bool isFinished() const override { return finished_; }
+    std::optional<Bar> getLatestBar(const std::string& symbol) const override;
+    double getLatestBarValue(const std::string& symbol, const std::string& val_type) override;
+    std::vector<Bar> getLatestBars(const std::string& symbol, int n = 1) override;
+    std::optional<OrderBook> getLatestOrderBook(const std::string& symbol) const override;
+    const std::vector<std::string>& getSymbols() const override { return symbols_; }
+    void notifyOnNewData(std::function<void()> callback) override { on_new_data_ = std::move(callback); }
+
+private:
+    struct SymbolState {
+        std::deque<Bar> bars; // Last bars the source has formed; the last may still be forming
+        std::optional<OrderBook> book;
+    };
+
+    static constexpr size_t BAR_HISTORY = 256; // Bars kept per symbol, as the source handlers
+
+    std::vector<std::string> symbols_;
+    std::unordered_map<std::string, SymbolState> states_;
+    bool finished_ = false;
+};
+
+#endif // SNAPSHOT_DATA_HANDLER_H
@@ -17,6 +17,9 @@
 #include <boost/beast/websocket/ssl.hpp>
 
 #include "../data/DataHandler.h"
+#include "../data/BinanceMessageParser.h"
+#include "../data/MarketDataJournal.h"
+#include "../core/Seqlock.h"
 #include "../event/ThreadSafeQueue.h"
 #include "../event/Event.h"
 
@@ -27,14 +30,18 @@ namespace net = boost::asio;
 namespace ssl = boost::asio::ssl;
 using tcp = boost::asio::ip::tcp;
 
-class WebSocketDataHandler : public DataHandler, public std::enable_shared_from_this<WebSocketDataHandler> {
+class WebSocketDataHandler : public DataHandler,
+                             public std::enable_shared_from_this<WebSocketDataHandler>,
+                             private BinanceMessageSink {
 public:
     WebSocketDataHandler(
         std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> event_queue,
         const std::vector<std::string>& symbols,
         const std::string& host,
         const std::string& port,
-        const std::string& target
+        const std::string& target,
+        bool tls_verify = true, // false accepts self-signed certificates (local feed_replayer)
+        bool tls = true         // false connects over plain ws:// (feed_replayer --plain)
     );
     
     ~WebSocketDataHandler();
@@ -43,10 +50,13 @@ public:
     void connect();
     void stop();
     void setOnNewDataCallback(std::function<void()> callback);
+    // Records every received frame to a binary journal (call before connect()).
+    void enableJournal(const std::string& path);
     
     // DataHandler interface implementation
     void updateBars() override;
     bool isFinished() const override;
+    bool isLiveFeed() const override { return true; }
     std::optional<Bar> getLatestBar(const std::string& symbol) const override;
     double getLatestBarValue(const std::string& symbol, const std::string& val_type) override;
     std::vector<Bar> getLatestBars(const std::string& symbol, int n = 1) override;
@@ -55,19 +65,31 @@ public:
     std::optional<OrderBook> getLatestOrderBook(const std::string& symbol) const override;
     const std::vector<std::string>& getSymbols() const override;
     void notifyOnNewData(std::function<void()> callback) override;
+
+    static constexpr long long BAR_INTERVAL_MS = 60000; // Rolling bars are built from trades
+    static constexpr size_t BAR_HISTORY = 256;           // Completed bars kept per symbol
     
 private:
     // WebSocket callbacks
     void on_resolve(beast::error_code ec, tcp::resolver::results_type results);
     void on_connect(beast::error_code ec, tcp::resolver::results_type::endpoint_type);
-    void on_ssl_handshake(beast::error_code ec);
+    void on_ssl_handshake(beast::error_code ec); // Also the next step after connecting without TLS
     void on_handshake(beast::error_code ec);
     void on_write(beast::error_code ec, std::size_t);
     void on_read(beast::error_code ec, std::size_t);
+    void read_next();
     void on_close(beast::error_code ec);
     
-    // Message processing
-    void process_message(const std::string& message);
+    // Message processing: the frame is parsed in place, straight out of buffer_
+    void process_message(const char* data, std::size_t size, int64_t receive_time_ns);
+    const std::string* find_symbol(std::string_view symbol) const;
+
+    // BinanceMessageSink
+    void onDepthBegin(const BinanceDepthHeader& header) override;
+    void onBidLevel(double price, double quantity) override;
+    void onAskLevel(double price, double quantity) override;
+    void onDepthEnd() override;
+    void onTrade(const BinanceTrade& trade) override;
     
     // Member variables
     std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> event_queue_;
@@ -80,15 +102,44 @@ private:
     net::io_context ioc_;
     ssl::context ctx_{ssl::context::tlsv12_client};
     tcp::resolver resolver_;
-    websocket::stream<beast::ssl_stream<beast::tcp_stream>> ws_;
+    bool tls_;
+    websocket::stream<beast::ssl_stream<beast::tcp_stream>> ws_;  // wss://
+    websocket::stream<beast::tcp_stream> plain_ws_;               // ws://
     beast::flat_buffer buffer_;
+
+    // Calls f with whichever of the two streams is in use.
+    template <class F>
+    void with_stream(F&& f) {
+        if (tls_) f(ws_);
+        else f(plain_ws_);
+    }
     
     // Thread management
     std::thread ioc_thread_;
     std::atomic<bool> finished_{true};
     
-    // Data storage
-    mutable std::unordered_map<std::string, Bar> latest_bars_map_;
+    // Trade-derived state for one symbol. Written only by the io_context thread
+    // and published through seqlocks, so engine threads read it without locking.
+    struct LiveBar {
+        long long open_time = 0;  // ms, start of the bar interval; 0 = no trades yet
+        long long last_trade_time = 0;
+        double open = 0.0;
+        double high = 0.0;
+        double low = 0.0;
+        double close = 0.0;       // Last traded price
+        double volume = 0.0;
+    };
+    struct SymbolSlot {
+        Seqlock<LiveBar> current;                   // Bar being formed, close = last price
+        Seqlock<LiveBar> history[BAR_HISTORY];      // Completed bars, ring indexed by count
+        std::atomic<uint64_t> completed{0};         // Completed bars published so far
+        LiveBar building;                           // Writer-side copy of `current`
+    };
+    static Bar to_bar(const std::string& symbol, const LiveBar& bar);
+
+    // Data storage. The map itself is built in the constructor and never
+    // modified afterwards, so lookups from any thread are safe.
+    std::unordered_map<std::string, std::unique_ptr<SymbolSlot>> symbol_slots_;
     std::unordered_map<std::string, int> trade_counts_;
     
     // Callback for new data
@@ -104,6 +155,16 @@ private:
     };
     std::unordered_map<std::string, StoredOrderBook> orderbooks_;
 
+    // Optional recording of the raw feed
+    std::unique_ptr<MarketDataJournalWriter> journal_;
+    long long receive_time_ms_ = 0; // Receipt time of the frame being processed
+    long long receive_stamp_ = 0;   // The same on the high_resolution_clock, for Event::timestamp_received
+
+    // Depth update currently being applied by the parser callbacks
+    const std::string* depth_symbol_ = nullptr;
+    StoredOrderBook* depth_book_ = nullptr;
+    std::shared_ptr<OrderBookEvent> depth_event_;
+
     std::string subscribe_message_;  // Add this line
 };
 
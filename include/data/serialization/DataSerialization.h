@@ -2,14 +2,69 @@
 #define DATA_SERIALIZATION_H
 
 #include "data/DataTypes.h"
+#include "mio/mio.hpp"
+#include <cstdint>
+#include <optional>
 #include <vector>
 #include <string>
 
 namespace serialization {
 
+// Binary bar file layout (native byte order, every section 8-byte aligned):
+//
+//   BarFileHeader
+//   BarFileSymbolEntry[symbol_count]
+//   for each symbol, row_count values per column in this order:
+//     timestamp (int64), open, high, low, close (double), volume (int64)
+//
+// Nothing in the file is a pointer, so it can be mapped and read in place.
+constexpr uint32_t BAR_FILE_MAGIC = 0x53524142; // "BARS"
+constexpr uint32_t BAR_FILE_VERSION = 1;
+constexpr size_t BAR_FILE_MAX_SYMBOL_LEN = 31;
+
+struct BarFileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t symbol_count;
+    uint32_t column_count;
+    uint64_t row_count; // Total bars across all symbols
+};
+
+struct BarFileSymbolEntry {
+    char symbol[BAR_FILE_MAX_SYMBOL_LEN + 1]; // NUL-terminated
+    uint64_t columns_offset; // Byte offset of this symbol's timestamp column
+    uint64_t row_count;
+};
+
+// Writes bars grouped by symbol (first-seen order; row order is kept within a
+// symbol). Bar timestamps must be integers, as the data handlers already assume.
 void serialize_bars(const std::vector<Bar>& bars, const std::string& file_path);
+
+// Reads a bar file back into owning Bar objects. Prefer MappedBarFile when the
+// data only needs to be read.
 std::vector<Bar> deserialize_bars(const std::string& file_path);
 
+// Memory-maps a bar file and exposes each symbol's columns as a BarSeries
+// without copying. Views are invalidated when the MappedBarFile is destroyed.
+class MappedBarFile {
+public:
+    explicit MappedBarFile(const std::string& file_path);
+
+    MappedBarFile(const MappedBarFile&) = delete;
+    MappedBarFile& operator=(const MappedBarFile&) = delete;
+
+    uint32_t version() const { return version_; }
+    uint64_t rowCount() const { return row_count_; }
+    const std::vector<BarSeries>& allSeries() const { return series_; }
+    std::optional<BarSeries> series(const std::string& symbol) const;
+
+private:
+    mio::mmap_source mmap_;
+    uint32_t version_ = 0;
+    uint64_t row_count_ = 0;
+    std::vector<BarSeries> series_;
+};
+
 } // namespace serialization
 
 #endif // DATA_SERIALIZATION_H
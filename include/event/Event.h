@@ -1,6 +1,7 @@
 #ifndef EVENT_H
 #define EVENT_H
 
+#include <atomic>
 #include <string>
 #include <vector>
 #include <chrono>
@@ -93,7 +94,7 @@ struct OrderEvent : public Event {
     OrderEvent(std::string symbol, long long timestamp, OrderDirection direction, double quantity, OrderType order_type, std::string strategy_name)
         : symbol(std::move(symbol)), timestamp(timestamp), direction(direction), quantity(quantity), order_type(order_type), strategy_name(std::move(strategy_name)) {
         this->type = EventType::ORDER;
-        static long id_counter = 0;
+        static std::atomic<long> id_counter{0}; // Engines may run on several threads
         this->order_id = ++id_counter;
     }
 };
@@ -148,4 +149,32 @@ struct OrderFailureEvent : public Event {
     }
 };
 
+// Exchange time of a market data event (market, trade or order book), or 0
+// for any other event.
+inline long long marketEventTime(const Event& event) {
+    switch (event.type) {
+        case EventType::MARKET:
+            return static_cast<const MarketEvent&>(event).timestamp;
+        case EventType::TRADE:
+            return static_cast<const TradeEvent&>(event).timestamp;
+        case EventType::ORDER_BOOK:
+            return static_cast<const OrderBookEvent&>(event).timestamp_;
+        default:
+            return 0;
+    }
+}
+
+// Symbol whose traded price a market data event moves (market or trade
+// event), or nullptr. Order books do not move it.
+inline const std::string* pricedEventSymbol(const Event& event) {
+    switch (event.type) {
+        case EventType::MARKET:
+            return &static_cast<const MarketEvent&>(event).symbol;
+        case EventType::TRADE:
+            return &static_cast<const TradeEvent&>(event).symbol;
+        default:
+            return nullptr;
+    }
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,84 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Bounded single-producer, single-consumer ring buffer. One thread may
+// push and one other thread may pop, without locks. The capacity is
+// rounded up to a power of two. Head and tail live on separate cache
+// lines, and each side caches the other's index so the shared line is
+// only read when the ring looks full or empty.
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity) {
+        size_t size = 2;
+        while (size < capacity) size <<= 1;
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    size_t capacity() const { return slots_.size(); }
+
+    // Producer side; false if the ring is full
+    bool try_push(const T& value) {
+        if (full()) {
+            return false;
+        }
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        slots_[tail & mask_] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Producer side; leaves `value` untouched if the ring is full
+    bool try_push(T&& value) {
+        if (full()) {
+            return false;
+        }
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        slots_[tail & mask_] = std::move(value);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side; false if the ring is empty
+    bool try_pop(T& out) {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head == cached_tail_) {
+                return false;
+            }
+        }
+        out = std::move(slots_[head & mask_]);
+        slots_[head & mask_] = T(); // Release what the slot held
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    bool full() {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - cached_head_ == slots_.size()) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            return tail - cached_head_ == slots_.size();
+        }
+        return false;
+    }
+
+    std::vector<T> slots_;
+    size_t mask_ = 0;
+    alignas(64) std::atomic<size_t> head_{0}; // Next slot to pop
+    size_t cached_tail_ = 0;                  // Consumer's view of tail_
+    alignas(64) std::atomic<size_t> tail_{0}; // Next slot to push
+    size_t cached_head_ = 0;                  // Producer's view of head_
+};
+
+#endif // SPSC_QUEUE_H
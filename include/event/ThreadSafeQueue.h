@@ -5,24 +5,28 @@
 #include <memory>
 #include <optional>
 
+// Unbounded multi-producer, single-consumer queue (Dmitry Vyukov's
+// intrusive MPSC design). push() is wait-free and may be called from any
+// thread; try_pop() must only ever be called from one thread at a time.
+// A pop racing with a push that has not finished linking its node may
+// report the queue empty; the item shows up on a later pop.
 template <typename T>
 class ThreadSafeQueue {
 private:
     struct Node {
         std::shared_ptr<T> data;
-        std::atomic<Node*> next;
-        Node(std::shared_ptr<T> data) : data(std::move(data)), next(nullptr) {}
+        std::atomic<Node*> next{nullptr};
     };
 
-    std::atomic<Node*> head;
-    std::atomic<Node*> tail;
+    std::atomic<Node*> head_; // Most recently pushed node; producers swap it
+    Node* tail_;              // Consumer-owned stub; the next node holds the oldest item
 
 public:
-    ThreadSafeQueue() : head(new Node(nullptr)), tail(head.load()) {}
+    ThreadSafeQueue() : head_(new Node), tail_(head_.load()) {}
     ~ThreadSafeQueue() {
-        while (Node* const old_head = head.load()) {
-            head.store(old_head->next);
-            delete old_head;
+        while (Node* node = tail_) {
+            tail_ = node->next.load(std::memory_order_relaxed);
+            delete node;
         }
     }
 
@@ -30,21 +34,23 @@ public:
     ThreadSafeQueue& operator=(const ThreadSafeQueue&) = delete;
 
     void push(std::shared_ptr<T> new_value) {
-        auto new_data = std::make_shared<T>(std::move(*new_value));
-        Node* new_node = new Node(new_data);
-        Node* old_tail = tail.load();
-        while (!tail.compare_exchange_weak(old_tail, new_node)) {}
-        old_tail->next = new_node;
+        Node* node = new Node;
+        node->data = std::move(new_value);
+        Node* previous = head_.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
     }
 
     std::optional<std::shared_ptr<T>> try_pop() {
-        Node* old_head = head.load();
-        while (old_head != tail.load() && !head.compare_exchange_weak(old_head, old_head->next)) {}
-        if (old_head == tail.load()) {
+        Node* tail = tail_;
+        Node* next = tail->next.load(std::memory_order_acquire);
+        if (!next) {
             return std::nullopt;
         }
-        return old_head->next.load()->data;
+        std::shared_ptr<T> data = std::move(next->data);
+        tail_ = next; // `next` becomes the new stub
+        delete tail;
+        return data;
     }
 };
 
-#endif // THREAD_SAFE_QUEUE_H
\ No newline at end of file
+#endif // THREAD_SAFE_QUEUE_H
@@ -28,6 +28,10 @@ public:
     void onDataSourceStatus(const DataSourceStatusEvent& event);
     void monitorRealTimeRisk();
 
+    // Circuit breaker state, for checkpoints.
+    void saveState(StateWriter& out) const;
+    void loadState(StateReader& in);
+
 private:
     std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> event_queue_;
     std::shared_ptr<Portfolio> portfolio_;
@@ -26,6 +26,8 @@ public:
     void onTrade(const TradeEvent& event) override;
     void onOrderBook(const OrderBookEvent& event) override;
     void onFill(const FillEvent& event) override;
+    void saveState(StateWriter& out) const override;
+    void loadState(StateReader& in) override;
 
 private:
     enum class PositionState { FLAT, LONG_PAIR, SHORT_PAIR };
@@ -21,9 +21,12 @@ public:
     void onTrade(const TradeEvent& event) override;
     void onOrderBook(const OrderBookEvent& event) override;
     void onFill(const FillEvent& event) override;
+    void saveState(StateWriter& out) const override;
+    void loadState(StateReader& in) override;
     void onMarketRegimeChanged(const MarketRegimeChangedEvent& event) override;
 
 private:
+    void on_price(double price);
     void generate_signal(OrderDirection direction);
     double calculate_sma(int period);
 
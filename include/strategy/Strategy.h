@@ -5,6 +5,7 @@
 #include "../data/DataHandler.h"
 #include "../data/DataTypes.h"
 #include "../event/ThreadSafeQueue.h"
+#include "../core/Checkpoint.h"
 
 #include <memory>
 #include <string>
@@ -39,14 +40,35 @@ public:
     bool isPaused() const { return paused_; }
     void pause() { paused_ = true; }
     void resume() { paused_ = false; }
+    // Receipt time of the market data being handled (Event::timestamp_received),
+    // passed on to the signals it triggers; set by the dispatcher.
+    void setSourceReceived(long long received) { source_received_ = received; }
+
+    // Everything the strategy has learnt from the data so far, for
+    // checkpoints. Overrides call the base version first.
+    virtual void saveState(StateWriter& out) const {
+        out.put(paused_);
+        out.put(market_state_);
+    }
+    virtual void loadState(StateReader& in) {
+        paused_ = in.get<uint8_t>() != 0;
+        market_state_ = in.getMarketState();
+    }
 
 protected:
+    // Queues a signal, stamped with the receipt of the data that triggered it.
+    void emitSignal(const std::shared_ptr<SignalEvent>& signal) {
+        signal->timestamp_received = source_received_;
+        event_queue_->push(std::make_shared<std::shared_ptr<Event>>(signal));
+    }
+
     std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> event_queue_;
     std::shared_ptr<DataHandler> data_handler_;
     std::string name;
     std::string symbol;
     bool paused_ = false;
     MarketState market_state_;
+    long long source_received_ = 0;
 };
 
 #endif // STRATEGY_H
\ No newline at end of file
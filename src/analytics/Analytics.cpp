@@ -1,4 +1,5 @@
 #include "../../include/analytics/Analytics.h"
+#include "../../include/core/AsyncLogger.h"
 #include <iostream>
 #include <numeric>
 #include <cmath>
@@ -9,6 +10,8 @@
 #include <windows.h>
 #include <psapi.h>
 
+static const LogComponent kLog("Analytics");
+
 // Helper function to convert VolatilityLevel enum to string
 std::string volatilityLevelToString(VolatilityLevel level) {
     switch (level) {
@@ -356,8 +359,7 @@ void Analytics::detect_anomalies(std::shared_ptr<DataHandler> data_handler) {
         if(std_dev > 1e-9){
             double z_score = (price - mean) / std_dev;
             if(std::abs(z_score) > anomaly_z_score_threshold_){
-                std::cerr << "!!! MARKET ANOMALY DETECTED !!! Symbol: " << symbol 
-                          << ", Price: " << price << ", Z-Score: " << z_score << std::endl;
+                LOG_WARN(kLog, "!!! MARKET ANOMALY DETECTED !!! Symbol: {}, Price: {}, Z-Score: {}", symbol, price, z_score);
             }
         }
     }
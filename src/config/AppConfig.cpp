@@ -113,6 +113,27 @@ AppConfig AppConfig::loadFromFile(const std::string& filename) {
                 config.risk.max_drawdown_pct = risk["max_drawdown_pct"].get<double>();
         }
         
+        // Parse logging config safely
+        if (j.contains("logging") && j["logging"].is_object()) {
+            auto& logging = j["logging"];
+            
+            if (logging.contains("level") && logging["level"].is_string())
+                config.logging.level = logging["level"].get<std::string>();
+            
+            if (logging.contains("file") && logging["file"].is_string())
+                config.logging.file = logging["file"].get<std::string>();
+            
+            if (logging.contains("rate_limit_per_sec") && logging["rate_limit_per_sec"].is_number_unsigned())
+                config.logging.rate_limit_per_sec = logging["rate_limit_per_sec"].get<unsigned>();
+            
+            if (logging.contains("components") && logging["components"].is_object()) {
+                for (const auto& [name, level] : logging["components"].items()) {
+                    if (level.is_string())
+                        config.logging.component_levels[name] = level.get<std::string>();
+                }
+            }
+        }
+        
         // If there are no strategies but strategy name is defined at top level, create one
         if (config.strategies.empty() && j.contains("strategy") && j["strategy"].is_string()) {
             StrategyConfig strategy;
@@ -185,6 +206,14 @@ void AppConfig::saveToFile(const std::string& filename) const {
         {"max_drawdown_pct", risk.max_drawdown_pct}
     };
     
+    // Save logging config
+    j["logging"] = {
+        {"level", logging.level},
+        {"file", logging.file},
+        {"rate_limit_per_sec", logging.rate_limit_per_sec},
+        {"components", logging.component_levels}
+    };
+    
     // Write to file
     try {
         std::ofstream file(filename);
@@ -0,0 +1,444 @@
+#include "../../include/core/AsyncLogger.h"
+#include <algorithm>
+#include <ctime>
+#include <iostream>
+#include <streambuf>
+
+thread_local bool AsyncLogger::thread_muted_ = false;
+
+namespace {
+
+// Owns the calling thread's ring; marks it orphaned when the thread exits so
+// the formatter can retire it once drained.
+struct ThreadRingHandle {
+    std::shared_ptr<void> ring;
+    std::atomic<bool>* orphaned = nullptr;
+    ~ThreadRingHandle() {
+        if (orphaned) orphaned->store(true, std::memory_order_release);
+    }
+};
+
+thread_local ThreadRingHandle thread_ring_handle;
+
+// Unbuffered pass-through to the original std::cout buffer that swallows
+// whatever muted threads write.
+class MutedThreadStreambuf : public std::streambuf {
+public:
+    MutedThreadStreambuf(std::streambuf* target, const bool& (*muted)()) : target_(target), muted_(muted) {}
+
+protected:
+    int_type overflow(int_type ch) override {
+        if (muted_() || traits_type::eq_int_type(ch, traits_type::eof())) {
+            return traits_type::not_eof(ch);
+        }
+        return target_->sputc(traits_type::to_char_type(ch));
+    }
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        return muted_() ? n : target_->sputn(s, n);
+    }
+    int sync() override {
+        return muted_() ? 0 : target_->pubsync();
+    }
+
+private:
+    std::streambuf* target_;
+    const bool& (*muted_)();
+};
+
+void append_timestamp(std::string& out, int64_t timestamp_ns) {
+    std::time_t seconds = static_cast<std::time_t>(timestamp_ns / 1000000000);
+    int millis = static_cast<int>((timestamp_ns / 1000000) % 1000);
+    std::tm tm_buf{};
+#ifdef _WIN32
+    localtime_s(&tm_buf, &seconds);
+#else
+    localtime_r(&seconds, &tm_buf);
+#endif
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%02d:%02d:%02d.%03d ", tm_buf.tm_hour, tm_buf.tm_min, tm_buf.tm_sec, millis);
+    out += buf;
+}
+
+} // namespace
+
+LogComponent::LogComponent(const char* name) : id_(AsyncLogger::instance().registerComponent(name)) {}
+
+ScopedLogMute::ScopedLogMute() : previous_(AsyncLogger::thread_muted_) {
+    AsyncLogger::thread_muted_ = true;
+}
+
+ScopedLogMute::~ScopedLogMute() {
+    AsyncLogger::thread_muted_ = previous_;
+}
+
+void ScopedLogMute::muteStdout() {
+    static std::once_flag installed;
+    std::call_once(installed, [] {
+        // Lives for the rest of the process, like std::cout itself.
+        static MutedThreadStreambuf filter(std::cout.rdbuf(), []() -> const bool& { return AsyncLogger::thread_muted_; });
+        std::cout.flush();
+        std::cout.rdbuf(&filter);
+    });
+}
+
+AsyncLogger& AsyncLogger::instance() {
+    static AsyncLogger logger;
+    return logger;
+}
+
+AsyncLogger::AsyncLogger() {
+    component_names_.push_back("General");
+    formatter_ = std::thread(&AsyncLogger::formatter_loop, this);
+}
+
+AsyncLogger::~AsyncLogger() {
+    shutdown();
+}
+
+void AsyncLogger::shutdown() {
+    if (!running_.exchange(false)) return;
+    wake_cond_.notify_all();
+    if (formatter_.joinable()) {
+        formatter_.join();
+    }
+    std::lock_guard<std::mutex> lock(output_mutex_);
+    if (file_) {
+        std::fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+LogLevel AsyncLogger::parseLevel(const std::string& name, LogLevel fallback) {
+    if (name == "TRACE") return LogLevel::TRACE;
+    if (name == "DEBUG") return LogLevel::DEBUG;
+    if (name == "INFO") return LogLevel::INFO;
+    if (name == "WARN" || name == "WARNING") return LogLevel::WARN;
+    if (name == "ERROR") return LogLevel::ERR;
+    if (name == "OFF") return LogLevel::OFF;
+    return fallback;
+}
+
+const char* AsyncLogger::levelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::TRACE: return "TRACE";
+        case LogLevel::DEBUG: return "DEBUG";
+        case LogLevel::INFO: return "INFO";
+        case LogLevel::WARN: return "WARN";
+        case LogLevel::ERR: return "ERROR";
+        case LogLevel::OFF: return "OFF";
+        default: return "UNKNOWN";
+    }
+}
+
+void AsyncLogger::configure(const nlohmann::json& logging_config) {
+    if (!logging_config.is_object()) return;
+
+    setLevel(parseLevel(logging_config.value("level", std::string("INFO"))));
+    setRateLimit(logging_config.value("rate_limit_per_sec", 0u));
+    setOutputFile(logging_config.value("file", std::string()));
+
+    if (logging_config.contains("components") && logging_config["components"].is_object()) {
+        for (const auto& [name, level] : logging_config["components"].items()) {
+            if (level.is_string()) {
+                setComponentLevel(name, parseLevel(level.get<std::string>()));
+            }
+        }
+    }
+}
+
+void AsyncLogger::setLevel(LogLevel level) {
+    std::lock_guard<std::mutex> lock(components_mutex_);
+    default_level_ = level;
+    for (size_t id = 0; id < component_names_.size(); ++id) {
+        auto it = component_overrides_.find(component_names_[id]);
+        component_state_[id].level.store(it != component_overrides_.end() ? it->second : level, std::memory_order_relaxed);
+    }
+}
+
+void AsyncLogger::setComponentLevel(const std::string& component, LogLevel level) {
+    std::lock_guard<std::mutex> lock(components_mutex_);
+    component_overrides_[component] = level;
+    for (size_t id = 0; id < component_names_.size(); ++id) {
+        if (component_names_[id] == component) {
+            component_state_[id].level.store(level, std::memory_order_relaxed);
+        }
+    }
+}
+
+void AsyncLogger::setRateLimit(uint32_t records_per_sec) {
+    rate_limit_.store(records_per_sec, std::memory_order_relaxed);
+}
+
+void AsyncLogger::setOutputFile(const std::string& path) {
+    FILE* file = nullptr;
+    if (!path.empty()) {
+        file = std::fopen(path.c_str(), "a");
+        if (!file) {
+            std::cerr << "AsyncLogger: could not open log file " << path << ", logging to console." << std::endl;
+        }
+    }
+    std::lock_guard<std::mutex> lock(output_mutex_);
+    if (file_) {
+        std::fclose(file_);
+    }
+    file_ = file;
+}
+
+uint16_t AsyncLogger::registerComponent(const char* name) {
+    std::lock_guard<std::mutex> lock(components_mutex_);
+    for (size_t id = 0; id < component_names_.size(); ++id) {
+        if (component_names_[id] == name) return static_cast<uint16_t>(id);
+    }
+    if (component_names_.size() >= MAX_COMPONENTS) {
+        return 0; // Out of slots: share the "General" component
+    }
+    uint16_t id = static_cast<uint16_t>(component_names_.size());
+    component_names_.push_back(name);
+    auto it = component_overrides_.find(name);
+    component_state_[id].level.store(it != component_overrides_.end() ? it->second : default_level_, std::memory_order_relaxed);
+    return id;
+}
+
+bool AsyncLogger::admit(uint16_t component) {
+    uint32_t limit = rate_limit_.load(std::memory_order_relaxed);
+    if (limit == 0) return true;
+
+    ComponentState& state = component_state_[component];
+    int64_t now_s = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    int64_t window = state.window_start.load(std::memory_order_relaxed);
+    if (window != now_s && state.window_start.compare_exchange_strong(window, now_s, std::memory_order_relaxed)) {
+        state.window_count.store(0, std::memory_order_relaxed);
+    }
+    if (state.window_count.fetch_add(1, std::memory_order_relaxed) < limit) {
+        return true;
+    }
+    state.suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+AsyncLogger::Ring& AsyncLogger::thread_ring() {
+    if (!thread_ring_handle.ring) {
+        auto ring = std::make_shared<Ring>();
+        {
+            std::lock_guard<std::mutex> lock(rings_mutex_);
+            rings_.push_back(ring);
+        }
+        thread_ring_handle.orphaned = &ring->orphaned;
+        thread_ring_handle.ring = ring;
+    }
+    return *static_cast<Ring*>(thread_ring_handle.ring.get());
+}
+
+void AsyncLogger::wake_formatter() {
+    // Only the first record since the last drain pays for the notify.
+    if (!pending_.exchange(true, std::memory_order_acq_rel)) {
+        wake_cond_.notify_one();
+    }
+}
+
+void AsyncLogger::put(Record& record, ArgType type, const void* data, size_t size) {
+    if (record.truncated || record.size + 1 + size > sizeof(record.payload)) {
+        record.truncated = true; // The formatter prints "<?>" for the missing arguments
+        return;
+    }
+    record.payload[record.size++] = static_cast<unsigned char>(type);
+    std::memcpy(record.payload + record.size, data, size);
+    record.size += static_cast<uint16_t>(size);
+}
+
+void AsyncLogger::encode(Record& record, std::string_view value) {
+    const size_t header = 1 + sizeof(uint16_t);
+    if (record.truncated || record.size + header > sizeof(record.payload)) {
+        record.truncated = true;
+        return;
+    }
+    uint16_t length = static_cast<uint16_t>(std::min(value.size(), sizeof(record.payload) - record.size - header));
+    record.payload[record.size++] = static_cast<unsigned char>(ArgType::STRING);
+    std::memcpy(record.payload + record.size, &length, sizeof(length));
+    record.size += sizeof(length);
+    std::memcpy(record.payload + record.size, value.data(), length);
+    record.size += length;
+}
+
+void AsyncLogger::flush() {
+    if (!running_.load()) return;
+    std::unique_lock<std::mutex> lock(wake_mutex_);
+    // A pass already in progress may have gone past this thread's ring, so wait
+    // for the one after it to complete.
+    uint64_t target = drain_generation_ + 2;
+    flush_requested_ = true;
+    wake_cond_.notify_one();
+    drained_cond_.wait(lock, [&] { return drain_generation_ >= target || !running_.load(); });
+}
+
+void AsyncLogger::formatter_loop() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(wake_mutex_);
+            wake_cond_.wait_for(lock, std::chrono::milliseconds(100), [&] {
+                return pending_.load() || flush_requested_ || !running_.load();
+            });
+            flush_requested_ = false;
+        }
+        pending_.store(false, std::memory_order_release);
+
+        bool stopping = !running_.load();
+        while (drain_once()) {}
+        report_suppressed();
+
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            ++drain_generation_;
+        }
+        drained_cond_.notify_all();
+
+        if (stopping) break;
+    }
+}
+
+bool AsyncLogger::drain_once() {
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        rings = rings_;
+    }
+
+    bool any = false;
+    for (const auto& ring : rings) {
+        uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        for (; tail != head; ++tail) {
+            write_record(ring->slots[tail & (RING_CAPACITY - 1)]);
+            any = true;
+        }
+        ring->tail.store(tail, std::memory_order_release);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(output_mutex_);
+        std::fflush(file_ ? file_ : stdout);
+        std::fflush(stderr);
+    }
+
+    if (!any) {
+        // Retire rings whose thread has exited and which are fully drained.
+        std::lock_guard<std::mutex> lock(rings_mutex_);
+        rings_.erase(std::remove_if(rings_.begin(), rings_.end(), [](const std::shared_ptr<Ring>& ring) {
+            return ring->orphaned.load(std::memory_order_acquire) &&
+                   ring->tail.load(std::memory_order_relaxed) == ring->head.load(std::memory_order_acquire);
+        }), rings_.end());
+    }
+    return any;
+}
+
+void AsyncLogger::write_record(const Record& record) {
+    std::string line;
+    line.reserve(160);
+    append_timestamp(line, record.timestamp_ns);
+    line += levelName(record.level);
+    line += " [";
+    {
+        std::lock_guard<std::mutex> lock(components_mutex_);
+        line += record.component < component_names_.size() ? component_names_[record.component] : "General";
+    }
+    line += "] ";
+
+    size_t offset = 0;
+    char buf[64];
+    for (const char* p = record.fmt; *p; ++p) {
+        if (p[0] != '{') {
+            line += *p;
+            continue;
+        }
+        // "{}" or "{:.Nf}"
+        const char* close = std::strchr(p, '}');
+        if (!close) {
+            line += p;
+            break;
+        }
+        int precision = -1;
+        if (close - p >= 4 && p[1] == ':' && p[2] == '.') {
+            precision = std::atoi(p + 3);
+        }
+        p = close;
+
+        if (offset >= record.size) {
+            line += "<?>";
+            continue;
+        }
+        ArgType type = static_cast<ArgType>(record.payload[offset++]);
+        switch (type) {
+            case ArgType::INT: {
+                int64_t v;
+                std::memcpy(&v, record.payload + offset, sizeof(v));
+                offset += sizeof(v);
+                if (precision >= 0) std::snprintf(buf, sizeof(buf), "%.*f", precision, static_cast<double>(v));
+                else std::snprintf(buf, sizeof(buf), "%lld", static_cast<long long>(v));
+                line += buf;
+                break;
+            }
+            case ArgType::UINT: {
+                uint64_t v;
+                std::memcpy(&v, record.payload + offset, sizeof(v));
+                offset += sizeof(v);
+                if (precision >= 0) std::snprintf(buf, sizeof(buf), "%.*f", precision, static_cast<double>(v));
+                else std::snprintf(buf, sizeof(buf), "%llu", static_cast<unsigned long long>(v));
+                line += buf;
+                break;
+            }
+            case ArgType::DOUBLE: {
+                double v;
+                std::memcpy(&v, record.payload + offset, sizeof(v));
+                offset += sizeof(v);
+                if (precision >= 0) std::snprintf(buf, sizeof(buf), "%.*f", precision, v);
+                else std::snprintf(buf, sizeof(buf), "%g", v);
+                line += buf;
+                break;
+            }
+            case ArgType::BOOL:
+                line += record.payload[offset++] ? "true" : "false";
+                break;
+            case ArgType::CHAR:
+                line += static_cast<char>(record.payload[offset++]);
+                break;
+            case ArgType::STRING: {
+                uint16_t length;
+                std::memcpy(&length, record.payload + offset, sizeof(length));
+                offset += sizeof(length);
+                line.append(reinterpret_cast<const char*>(record.payload + offset), length);
+                offset += length;
+                break;
+            }
+        }
+    }
+    line += '\n';
+
+    std::lock_guard<std::mutex> lock(output_mutex_);
+    FILE* out = file_ ? file_ : (record.level >= LogLevel::WARN ? stderr : stdout);
+    std::fwrite(line.data(), 1, line.size(), out);
+}
+
+void AsyncLogger::report_suppressed() {
+    std::string report;
+    {
+        std::lock_guard<std::mutex> lock(components_mutex_);
+        for (size_t id = 0; id < component_names_.size(); ++id) {
+            uint64_t suppressed = component_state_[id].suppressed.exchange(0, std::memory_order_relaxed);
+            if (suppressed > 0) {
+                report += "WARN [" + component_names_[id] + "] " + std::to_string(suppressed) +
+                          " messages suppressed by rate limit\n";
+            }
+        }
+    }
+    uint64_t dropped = dropped_.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+        report += "WARN [AsyncLogger] " + std::to_string(dropped) + " messages dropped (ring full)\n";
+    }
+    if (report.empty()) return;
+
+    std::lock_guard<std::mutex> lock(output_mutex_);
+    FILE* out = file_ ? file_ : stderr;
+    std::fwrite(report.data(), 1, report.size(), out);
+    std::fflush(out);
+}
@@ -0,0 +1,143 @@
+#include "../../include/core/BacktestPipeline.h"
+#include "../../include/core/ThreadAffinity.h"
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+BacktestPipeline::BacktestPipeline(std::shared_ptr<DataHandler> source,
+                                   std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> source_queue,
+                                   std::shared_ptr<SnapshotDataHandler> strategy_view,
+                                   std::shared_ptr<SnapshotDataHandler> engine_view,
+                                   size_t capacity,
+                                   bool pin_threads)
+    : source_(std::move(source)),
+      source_queue_(std::move(source_queue)),
+      strategy_view_(std::move(strategy_view)),
+      engine_view_(std::move(engine_view)),
+      pin_threads_(pin_threads),
+      decoded_(capacity),
+      evaluated_(capacity) {}
+
+bool BacktestPipeline::push(SpscQueue<PipelineBatch>& ring, PipelineBatch&& batch) {
+    Backoff backoff;
+    while (!ring.try_push(std::move(batch))) {
+        if (stopping_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        backoff.pause();
+    }
+    return true;
+}
+
+void BacktestPipeline::decode_loop() {
+    if (pin_threads_) {
+        pinCurrentThread(1);
+    }
+    uint64_t sequence = 0;
+    while (!stopping_.load(std::memory_order_acquire)) {
+        PipelineBatch batch;
+        batch.sequence = sequence++;
+        if (source_->isFinished()) {
+            batch.last = true;
+            push(decoded_, std::move(batch));
+            return;
+        }
+        source_->updateBars();
+        while (auto event = source_queue_->try_pop()) {
+            batch.events.push_back(std::move(*event.value()));
+        }
+        batch.snapshots = SnapshotDataHandler::capture(*source_, batch.events);
+        if (!push(decoded_, std::move(batch))) {
+            return;
+        }
+    }
+}
+
+void BacktestPipeline::strategy_loop(const StrategyStage& strategy) {
+    if (pin_threads_) {
+        pinCurrentThread(2);
+    }
+    Backoff backoff;
+    uint64_t expected = 0;
+    PipelineBatch batch;
+    while (!stopping_.load(std::memory_order_acquire)) {
+        if (!decoded_.try_pop(batch)) {
+            backoff.pause();
+            continue;
+        }
+        backoff.reset();
+        if (batch.sequence != expected++) {
+            throw std::logic_error("BacktestPipeline: batch out of order in the strategy stage");
+        }
+        const bool last = batch.last;
+        if (!last) {
+            strategy_view_->apply(batch.snapshots);
+            strategy(batch);
+        } else {
+            strategy_view_->markFinished();
+        }
+        if (!push(evaluated_, std::move(batch)) || last) {
+            return;
+        }
+    }
+}
+
+void BacktestPipeline::fail(std::exception_ptr error) {
+    std::lock_guard<std::mutex> lock(error_mutex_);
+    if (!error_) {
+        error_ = error;
+    }
+    stopping_ = true;
+}
+
+uint64_t BacktestPipeline::run(const StrategyStage& strategy, const EngineStage& engine) {
+    // A stage that throws stops the others; the error is rethrown here.
+    auto guarded = [this](auto body) {
+        return [this, body] {
+            try {
+                body();
+            } catch (...) {
+                fail(std::current_exception());
+            }
+        };
+    };
+    std::thread decoder(guarded([this] { decode_loop(); }));
+    std::thread evaluator(guarded([this, &strategy] { strategy_loop(strategy); }));
+
+    Backoff backoff;
+    uint64_t handled = 0;
+    PipelineBatch batch;
+    try {
+        while (true) {
+            if (!evaluated_.try_pop(batch)) {
+                if (stopping_.load(std::memory_order_acquire)) {
+                    break;
+                }
+                backoff.pause();
+                continue;
+            }
+            backoff.reset();
+            if (batch.sequence != handled) {
+                throw std::logic_error("BacktestPipeline: batch out of order in the engine stage");
+            }
+            if (batch.last) {
+                engine_view_->markFinished();
+                break;
+            }
+            engine_view_->apply(batch.snapshots);
+            ++handled;
+            if (!engine(batch)) {
+                break;
+            }
+        }
+    } catch (...) {
+        fail(std::current_exception());
+    }
+    stopping_ = true;
+    decoder.join();
+    evaluator.join();
+    if (error_) {
+        std::rethrow_exception(error_);
+    }
+    return handled;
+}
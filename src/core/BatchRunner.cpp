@@ -0,0 +1,311 @@
+#include "../../include/core/BatchRunner.h"
+#include "../../include/core/Backtester.h"
+#include "../../include/core/ResultCache.h"
+#include "../../include/core/ThreadPool.h"
+#include "../../include/core/AsyncLogger.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// Quoted when it holds a separator, quote or line break.
+std::string csv_field(const std::string& value) {
+    if (value.find_first_of(",\"\n\r") == std::string::npos) {
+        return value;
+    }
+    std::string quoted = "\"";
+    for (char c : value) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+// First field of a CSV line, unquoted. `rest` is set to where the next
+// field starts (npos if there is none).
+std::string csv_first_field(const std::string& line, size_t& rest) {
+    if (line.empty() || line[0] != '"') {
+        const size_t comma = line.find(',');
+        rest = comma == std::string::npos ? comma : comma + 1;
+        return line.substr(0, comma);
+    }
+    std::string value;
+    rest = std::string::npos;
+    for (size_t i = 1; i < line.size(); ++i) {
+        if (line[i] == '"') {
+            if (i + 1 < line.size() && line[i + 1] == '"') {
+                value += '"';
+                ++i;
+            } else {
+                rest = i + 2 <= line.size() ? i + 2 : std::string::npos;
+                break;
+            }
+        } else {
+            value += line[i];
+        }
+    }
+    return value;
+}
+
+} // namespace
+
+BatchRunner::BatchRunner(const BatchOptions& options) : options_(options) {
+    if (options_.format != "jsonl" && options_.format != "csv") {
+        throw std::runtime_error("Batch: unknown result format '" + options_.format + "' (jsonl or csv)");
+    }
+    std::ifstream config_file(options_.config_path);
+    if (!config_file) {
+        throw std::runtime_error("Batch: cannot open config " + options_.config_path);
+    }
+    base_config_ = json::parse(config_file);
+}
+
+std::vector<BatchJob> BatchRunner::loadJobs(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Batch: cannot open job file " + path);
+    }
+    std::vector<BatchJob> jobs;
+    std::set<std::string> ids;
+    std::string line;
+    for (size_t number = 1; std::getline(file, line); ++number) {
+        const size_t start = line.find_first_not_of(" \t\r");
+        if (start == std::string::npos || line[start] == '#') {
+            continue;
+        }
+        BatchJob job;
+        try {
+            job.patch = json::parse(line);
+        } catch (const json::parse_error& e) {
+            throw std::runtime_error("Batch: line " + std::to_string(number) + " of " + path + ": " + e.what());
+        }
+        if (!job.patch.is_object()) {
+            throw std::runtime_error("Batch: line " + std::to_string(number) + " of " + path + " is not a JSON object");
+        }
+        job.id = "job-" + std::to_string(number);
+        if (job.patch.contains("id")) {
+            job.id = job.patch["id"].is_string() ? job.patch["id"].get<std::string>() : job.patch["id"].dump();
+            job.patch.erase("id");
+        }
+        if (!ids.insert(job.id).second) {
+            throw std::runtime_error("Batch: duplicate job id '" + job.id + "'");
+        }
+        jobs.push_back(std::move(job));
+    }
+    return jobs;
+}
+
+std::set<std::string> BatchRunner::completedJobs() const {
+    std::set<std::string> completed;
+    if (options_.out_path.empty() || !std::filesystem::exists(options_.out_path)) {
+        return completed;
+    }
+    std::string contents;
+    {
+        std::ifstream file(options_.out_path, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    // A line without its newline was cut off mid-write.
+    const size_t complete = contents.rfind('\n') == std::string::npos ? 0 : contents.rfind('\n') + 1;
+    if (complete < contents.size()) {
+        std::filesystem::resize_file(options_.out_path, complete);
+        contents.resize(complete);
+    }
+
+    std::istringstream lines(contents);
+    std::string line;
+    bool header = options_.format == "csv";
+    while (std::getline(lines, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        if (header) {
+            header = false;
+            continue;
+        }
+        // Failed jobs run again.
+        if (options_.format == "csv") {
+            size_t ok_field = 0;
+            const std::string id = csv_first_field(line, ok_field);
+            if (ok_field != std::string::npos && line.compare(ok_field, 5, "true,") == 0) {
+                completed.insert(id);
+            }
+            continue;
+        }
+        try {
+            const json result = json::parse(line);
+            if (result.contains("id") && result["id"].is_string() && result.value("ok", false)) {
+                completed.insert(result["id"].get<std::string>());
+            }
+        } catch (const json::parse_error&) {
+            // Not a result line; the job runs again.
+        }
+    }
+    return completed;
+}
+
+BatchResult BatchRunner::runJob(const json& base_config, const std::string& id, const json& patch) {
+    BatchResult result;
+    result.id = id;
+    const auto start_time = std::chrono::steady_clock::now();
+    try {
+        json patched = base_config;
+        patched.merge_patch(patch);
+        const json run_config = Backtester::headlessRunConfig(patched);
+
+        ResultCache* cache = ResultCache::forConfig(run_config);
+        const std::string cache_key = cache ? ResultCache::key(run_config) : "";
+        std::optional<CachedRun> run = cache ? cache->find(cache_key) : std::nullopt;
+        if (!run) {
+            Backtester backtester(run_config);
+            if (cache && cache->storesEquity()) {
+                backtester.getPortfolio()->setEquityCurveEnabled(true);
+            }
+            backtester.run();
+            run = ResultCache::capture(backtester);
+            if (cache) {
+                cache->store(cache_key, *run);
+            }
+        }
+        result.metrics = run->metrics;
+        result.events = run->events;
+        result.ok = true;
+    } catch (const std::exception& e) {
+        result.error = e.what();
+    }
+    result.duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
+    return result;
+}
+
+std::string BatchRunner::csvHeader() {
+    return "id,ok,sharpe,total_return,max_drawdown,final_equity,trades,points,events,duration_ms,error";
+}
+
+std::string BatchRunner::formatResult(const BatchResult& result, const std::string& format) {
+    const RunMetrics& m = result.metrics;
+    if (format == "csv") {
+        std::ostringstream line;
+        line.precision(10);
+        line << csv_field(result.id) << ',' << (result.ok ? "true" : "false") << ','
+             << m.sharpe << ',' << m.total_return << ',' << m.max_drawdown << ',' << m.final_equity << ','
+             << m.trades << ',' << m.points << ',' << result.events << ',' << result.duration_ms << ','
+             << csv_field(result.error);
+        return line.str();
+    }
+    return toJson(result).dump();
+}
+
+json BatchRunner::toJson(const BatchResult& result) {
+    const RunMetrics& m = result.metrics;
+    json line = {
+        {"id", result.id},
+        {"ok", result.ok},
+        {"sharpe", m.sharpe},
+        {"total_return", m.total_return},
+        {"max_drawdown", m.max_drawdown},
+        {"final_equity", m.final_equity},
+        {"trades", m.trades},
+        {"points", m.points},
+        {"events", result.events},
+        {"duration_ms", result.duration_ms}
+    };
+    if (!result.ok) {
+        line["error"] = result.error;
+    }
+    return line;
+}
+
+BatchResult BatchRunner::fromJson(const json& line) {
+    BatchResult result;
+    result.id = line.value("id", "");
+    result.ok = line.value("ok", false);
+    // NaN metrics come back as null
+    auto number = [&line](const char* key) {
+        return line.contains(key) && line[key].is_number() ? line[key].get<double>() : std::nan("");
+    };
+    result.metrics.sharpe = number("sharpe");
+    result.metrics.total_return = number("total_return");
+    result.metrics.max_drawdown = number("max_drawdown");
+    result.metrics.final_equity = number("final_equity");
+    result.metrics.trades = line.value("trades", size_t{0});
+    result.metrics.points = line.value("points", 0LL);
+    result.events = line.value("events", 0LL);
+    result.duration_ms = line.value("duration_ms", 0LL);
+    result.error = line.value("error", "");
+    return result;
+}
+
+size_t BatchRunner::run() {
+    const std::vector<BatchJob> jobs = loadJobs(options_.jobs_path);
+    const std::set<std::string> completed = options_.resume ? completedJobs() : std::set<std::string>();
+    std::vector<const BatchJob*> pending;
+    for (const auto& job : jobs) {
+        if (!completed.count(job.id)) {
+            pending.push_back(&job);
+        }
+    }
+
+    std::ofstream file;
+    const bool append = options_.resume && !options_.out_path.empty() && std::filesystem::exists(options_.out_path) &&
+                        std::filesystem::file_size(options_.out_path) > 0;
+    if (!options_.out_path.empty()) {
+        file.open(options_.out_path, append ? std::ios::app : std::ios::trunc);
+        if (!file) {
+            throw std::runtime_error("Batch: cannot write " + options_.out_path);
+        }
+    }
+    // Workers' std::cout is muted, so results go to stdout through a stream
+    // set up before the pool starts.
+    std::ostream& out = options_.out_path.empty() ? std::cout : file;
+    if (options_.format == "csv" && !append) {
+        out << csvHeader() << '\n' << std::flush;
+    }
+
+    const size_t threads = std::max<size_t>(1, std::min(ThreadPool::resolveThreadCount(options_.threads), pending.size()));
+    std::cerr << "Batch: " << jobs.size() << " jobs, " << jobs.size() - pending.size() << " already done, running "
+              << pending.size() << " on " << threads << " threads." << std::endl;
+
+    std::mutex out_mutex;
+    size_t finished = 0;
+    size_t failed = 0;
+    const auto start_time = std::chrono::steady_clock::now();
+    if (!pending.empty()) {
+        ScopedLogMute::muteStdout();
+        ThreadPool pool(threads, true);
+        pool.parallelFor(pending.size(), [&](size_t i) {
+            const BatchResult result = runJob(base_config_, pending[i]->id, pending[i]->patch);
+            const std::string line = formatResult(result, options_.format);
+            std::lock_guard<std::mutex> lock(out_mutex);
+            if (&out == &std::cout) {
+                // Written from a muted worker: bypass the filter.
+                std::fwrite(line.data(), 1, line.size(), stdout);
+                std::fputc('\n', stdout);
+                std::fflush(stdout);
+            } else {
+                out << line << '\n' << std::flush;
+            }
+            ++finished;
+            if (!result.ok) {
+                ++failed;
+                std::cerr << "Batch: job " << result.id << " failed: " << result.error << std::endl;
+            }
+        });
+    }
+    AsyncLogger::instance().flush();
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
+    std::cerr << "Batch: " << finished << " jobs in " << elapsed << " ms, " << failed << " failed." << std::endl;
+    if (ResultCache* cache = ResultCache::forConfig(base_config_)) {
+        std::cerr << "Batch: result cache " << cache->hits() << " hits, " << cache->misses() << " misses." << std::endl;
+    }
+    return failed;
+}
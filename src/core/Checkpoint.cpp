@@ -0,0 +1,87 @@
+#include "../../include/core/Checkpoint.h"
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace checkpoint {
+
+namespace {
+
+const char* const kPrefix = "checkpoint-";
+const char* const kExtension = ".ckpt";
+
+} // namespace
+
+std::string pathFor(const std::string& dir, long long market_time) {
+    return (fs::path(dir) / (kPrefix + std::to_string(market_time) + kExtension)).string();
+}
+
+void write(const std::string& path, const CheckpointHeader& header, const std::string& body) {
+    const fs::path target(path);
+    if (target.has_parent_path()) {
+        fs::create_directories(target.parent_path());
+    }
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Checkpoint: cannot write " + temporary);
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(body.data(), static_cast<std::streamsize>(body.size()));
+        if (!out) {
+            throw std::runtime_error("Checkpoint: write failed for " + temporary);
+        }
+    }
+    fs::rename(temporary, target);
+}
+
+Loaded read(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Checkpoint: cannot open " + path);
+    }
+    Loaded loaded;
+    if (!in.read(reinterpret_cast<char*>(&loaded.header), sizeof(loaded.header))) {
+        throw std::runtime_error("Checkpoint: truncated header in " + path);
+    }
+    if (loaded.header.magic != CHECKPOINT_MAGIC || loaded.header.version != CHECKPOINT_VERSION) {
+        throw std::runtime_error("Checkpoint: " + path + " is not a version " +
+                                 std::to_string(CHECKPOINT_VERSION) + " checkpoint");
+    }
+    std::ostringstream body;
+    body << in.rdbuf();
+    loaded.body = body.str();
+    return loaded;
+}
+
+std::optional<std::string> findAtOrBefore(const std::string& dir, long long market_time) {
+    std::error_code error;
+    if (!fs::is_directory(dir, error)) {
+        return std::nullopt;
+    }
+    std::optional<std::string> best;
+    long long best_time = 0;
+    const std::string prefix = kPrefix;
+    for (const auto& entry : fs::directory_iterator(dir, error)) {
+        const std::string name = entry.path().filename().string();
+        if (name.rfind(prefix, 0) != 0 || entry.path().extension() != kExtension) {
+            continue;
+        }
+        long long time = 0;
+        try {
+            time = std::stoll(name.substr(prefix.size()));
+        } catch (const std::exception&) {
+            continue;
+        }
+        if ((market_time < 0 || time <= market_time) && (!best || time > best_time)) {
+            best = entry.path().string();
+            best_time = time;
+        }
+    }
+    return best;
+}
+
+} // namespace checkpoint
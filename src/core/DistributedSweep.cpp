@@ -0,0 +1,842 @@
+#include "../../include/core/DistributedSweep.h"
+#include "../../include/core/AsyncLogger.h"
+#include "../../include/core/MonteCarloSimulator.h"
+#include "../../include/core/ParameterSearch.h"
+#include "../../include/core/ThreadPool.h"
+
+#include <boost/asio/buffers_iterator.hpp>
+#include <boost/asio/connect.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/host_name.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/write.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cctype>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace net = boost::asio;
+namespace fs = std::filesystem;
+using tcp = boost::asio::ip::tcp;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+long long current_pid() {
+#ifdef _WIN32
+    return _getpid();
+#else
+    return getpid();
+#endif
+}
+
+json jobs_to_json(const std::vector<BatchJob>& jobs) {
+    json array = json::array();
+    for (const auto& job : jobs) {
+        array.push_back({{"id", job.id}, {"patch", job.patch}});
+    }
+    return array;
+}
+
+std::vector<BatchJob> jobs_from_json(const json& array) {
+    std::vector<BatchJob> jobs;
+    for (const auto& job : array) {
+        jobs.push_back({job.at("id").get<std::string>(), job.value("patch", json::object())});
+    }
+    return jobs;
+}
+
+json results_to_json(const std::vector<BatchResult>& results) {
+    json array = json::array();
+    for (const auto& result : results) {
+        array.push_back(BatchRunner::toJson(result));
+    }
+    return array;
+}
+
+// `config`'s strategies with `params` applied to the one named `strategy`.
+json strategies_with_params(const json& config, const std::string& strategy, const json& params) {
+    json strategies = config.value("strategies", json::array());
+    for (auto& strategy_config : strategies) {
+        if (strategy_config.value("name", "") == strategy) {
+            strategy_config["params"] = params;
+            return strategies;
+        }
+    }
+    throw std::runtime_error("Sweep: no strategy named '" + strategy + "' in the config");
+}
+
+// Written next to `path` first, so readers never see a partial file.
+void write_atomically(const fs::path& path, const std::string& contents, const fs::path& scratch_dir) {
+    const fs::path temporary = scratch_dir / ("." + path.filename().string() + "." + std::to_string(current_pid()) + ".tmp");
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        file << contents;
+        if (!file) {
+            throw std::runtime_error("Sweep: cannot write " + temporary.string());
+        }
+    }
+    fs::rename(temporary, path);
+}
+
+json read_json_file(const fs::path& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Sweep: cannot read " + path.string());
+    }
+    return json::parse(file);
+}
+
+// Shard number of "shard-<k>.json" or "shard-<k>@<worker>.json", or nullopt.
+std::optional<size_t> shard_of(const fs::path& path) {
+    const std::string name = path.filename().string();
+    if (name.rfind("shard-", 0) != 0 || path.extension() != ".json") {
+        return std::nullopt;
+    }
+    try {
+        return std::stoul(name.substr(6));
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+std::string shard_file(size_t shard) {
+    return "shard-" + std::to_string(shard) + ".json";
+}
+
+// Which jobs make up each shard, which shards are still to run, and the
+// results so far. Used by both transports from one thread; `on_result`, if
+// set, sees each result as it is stored.
+class ShardBook {
+public:
+    ShardBook(const std::vector<BatchJob>& jobs, size_t shard_size, int max_attempts,
+              std::function<void(const BatchResult&)> on_result = {})
+        : jobs_(jobs), max_attempts_(std::max(1, max_attempts)), results_(jobs.size()), on_result_(std::move(on_result)) {
+        shard_size = std::max<size_t>(1, shard_size);
+        for (size_t begin = 0; begin < jobs.size(); begin += shard_size) {
+            Shard shard;
+            for (size_t i = begin; i < std::min(jobs.size(), begin + shard_size); ++i) {
+                shard.jobs.push_back(i);
+            }
+            pending_.push_back(shards_.size());
+            shards_.push_back(std::move(shard));
+        }
+        remaining_ = shards_.size();
+    }
+
+    size_t size() const { return shards_.size(); }
+    bool finished() const { return remaining_ == 0; }
+    bool isDone(size_t shard) const { return shard >= shards_.size() || shards_[shard].done; }
+    std::vector<BatchResult>& results() { return results_; }
+
+    std::vector<BatchJob> jobsOf(size_t shard) const {
+        std::vector<BatchJob> jobs;
+        for (size_t i : shards_.at(shard).jobs) {
+            jobs.push_back(jobs_[i]);
+        }
+        return jobs;
+    }
+
+    std::optional<size_t> next() {
+        if (pending_.empty()) {
+            return std::nullopt;
+        }
+        const size_t shard = pending_.front();
+        pending_.pop_front();
+        return shard;
+    }
+
+    // Stores a shard's results. False if the shard is unknown, already done,
+    // or the results don't match its jobs.
+    bool complete(size_t shard, const json& results) {
+        if (isDone(shard) || !results.is_array() || results.size() != shards_[shard].jobs.size()) {
+            return false;
+        }
+        for (size_t j = 0; j < results.size(); ++j) {
+            const size_t job = shards_[shard].jobs[j];
+            BatchResult result = BatchRunner::fromJson(results[j]);
+            if (result.id != jobs_[job].id) {
+                return false;
+            }
+            results_[job] = std::move(result);
+        }
+        markDone(shard);
+        return true;
+    }
+
+    // A worker failed on `shard`. Returns true if it goes back to the queue,
+    // false if it has used up its attempts and its jobs are now failed.
+    bool fail(size_t shard, const std::string& reason) {
+        if (isDone(shard)) {
+            return false;
+        }
+        Shard& s = shards_[shard];
+        if (++s.attempts < max_attempts_) {
+            pending_.push_back(shard);
+            return true;
+        }
+        failJobs(shard, "Shard " + std::to_string(shard) + " failed on " + std::to_string(s.attempts) + " workers, last: " + reason);
+        return false;
+    }
+
+    // Fails every shard not done yet.
+    void failRemaining(const std::string& reason) {
+        pending_.clear();
+        for (size_t shard = 0; shard < shards_.size(); ++shard) {
+            if (!shards_[shard].done) {
+                failJobs(shard, reason);
+            }
+        }
+    }
+
+    size_t doneCount() const { return shards_.size() - remaining_; }
+
+private:
+    struct Shard {
+        std::vector<size_t> jobs;
+        int attempts = 0;
+        bool done = false;
+    };
+
+    void failJobs(size_t shard, const std::string& error) {
+        for (size_t job : shards_[shard].jobs) {
+            results_[job] = BatchResult();
+            results_[job].id = jobs_[job].id;
+            results_[job].error = error;
+        }
+        markDone(shard);
+    }
+    void markDone(size_t shard) {
+        shards_[shard].done = true;
+        --remaining_;
+        if (on_result_) {
+            for (size_t job : shards_[shard].jobs) {
+                on_result_(results_[job]);
+            }
+        }
+    }
+
+    const std::vector<BatchJob>& jobs_;
+    int max_attempts_;
+    std::vector<Shard> shards_;
+    std::deque<size_t> pending_;
+    size_t remaining_ = 0;
+    std::vector<BatchResult> results_;
+    std::function<void(const BatchResult&)> on_result_;
+};
+
+// Starts the coordinator's local worker processes; `on_exit` runs on the
+// process's watcher thread when it ends.
+class LocalWorkers {
+public:
+    void start(const DistributedOptions& options, const std::string& worker_args, std::function<void()> on_exit) {
+        if (options.local_workers <= 0) {
+            return;
+        }
+        if (options.worker_executable.empty()) {
+            throw std::runtime_error("Sweep: local workers need the backtester executable");
+        }
+        const std::string command = "\"" + options.worker_executable + "\" " + worker_args +
+                                    " --threads " + std::to_string(options.local_worker_threads);
+        for (int i = 0; i < options.local_workers; ++i) {
+            threads_.emplace_back([command, on_exit]() {
+                const int status = std::system(command.c_str());
+                if (status != 0) {
+                    std::cerr << "Sweep: local worker exited with status " << status << std::endl;
+                }
+                on_exit();
+            });
+        }
+    }
+    ~LocalWorkers() {
+        for (auto& thread : threads_) {
+            thread.join();
+        }
+    }
+
+private:
+    std::vector<std::thread> threads_;
+};
+
+// The TCP side of a coordinator. Everything runs on one io_context thread.
+class TcpCoordinator {
+public:
+    TcpCoordinator(const json& base_config, const DistributedOptions& options, ShardBook& book)
+        : base_config_(base_config), options_(options), book_(book), acceptor_(io_), timer_(io_) {}
+
+    tcp::endpoint listen() {
+        const tcp::endpoint endpoint(net::ip::make_address(options_.address), options_.port);
+        acceptor_.open(endpoint.protocol());
+        acceptor_.set_option(tcp::acceptor::reuse_address(true));
+        acceptor_.bind(endpoint);
+        acceptor_.listen();
+        return acceptor_.local_endpoint();
+    }
+
+    void run(int local_workers) {
+        local_workers_ = local_workers;
+        if (book_.finished()) {
+            return;
+        }
+        accept();
+        watch();
+        io_.run();
+    }
+
+    // Called from a watcher thread when a local worker process ends.
+    void localWorkerExited() {
+        net::post(io_, [this]() {
+            --local_workers_;
+            check_workers_left();
+        });
+    }
+
+private:
+    struct Session {
+        explicit Session(tcp::socket s) : socket(std::move(s)), last_seen(Clock::now()) {}
+        tcp::socket socket;
+        net::streambuf buffer;
+        std::deque<std::string> outbox;
+        std::string name = "unnamed worker";
+        std::optional<size_t> shard;
+        Clock::time_point last_seen;
+        bool ready = false; // Has the config
+        bool closed = false;
+    };
+    using SessionPtr = std::shared_ptr<Session>;
+
+    void accept() {
+        acceptor_.async_accept([this](boost::system::error_code ec, tcp::socket socket) {
+            if (ec) {
+                return; // Closed by finish()
+            }
+            auto session = std::make_shared<Session>(std::move(socket));
+            sessions_.insert(session);
+            read(session);
+            accept();
+        });
+    }
+
+    void read(const SessionPtr& session) {
+        net::async_read_until(session->socket, session->buffer, '\n',
+            [this, session](boost::system::error_code ec, size_t bytes) {
+                if (ec) {
+                    drop(session, ec.message());
+                    return;
+                }
+                const auto data = session->buffer.data();
+                const std::string line(net::buffers_begin(data), net::buffers_begin(data) + bytes);
+                session->buffer.consume(bytes);
+                session->last_seen = Clock::now();
+                try {
+                    handle(session, json::parse(line));
+                } catch (const std::exception& e) {
+                    drop(session, std::string("bad message: ") + e.what());
+                    return;
+                }
+                if (!session->closed) {
+                    read(session);
+                }
+            });
+    }
+
+    void send(const SessionPtr& session, const json& message) {
+        session->outbox.push_back(message.dump() + "\n");
+        if (session->outbox.size() == 1) {
+            write(session);
+        }
+    }
+
+    void write(const SessionPtr& session) {
+        net::async_write(session->socket, net::buffer(session->outbox.front()),
+            [this, session](boost::system::error_code ec, size_t) {
+                if (ec) {
+                    drop(session, ec.message());
+                    return;
+                }
+                session->outbox.pop_front();
+                if (!session->outbox.empty()) {
+                    write(session);
+                } else if (finished_) {
+                    drop(session, "sweep done");
+                }
+            });
+    }
+
+    void handle(const SessionPtr& session, const json& message) {
+        const std::string type = message.value("type", "");
+        if (type == "hello") {
+            session->name = message.value("worker", session->name);
+            std::cerr << "Sweep: worker " << session->name << " joined with "
+                      << message.value("threads", 0) << " threads." << std::endl;
+            send(session, {{"type", "config"}, {"config", base_config_}, {"heartbeat_ms", options_.heartbeat_ms}});
+            session->ready = true;
+            assign(session);
+        } else if (type == "result") {
+            const size_t shard = message.value("shard", book_.size());
+            if (session->shard == shard) {
+                session->shard.reset();
+            }
+            if (book_.complete(shard, message.value("results", json::array()))) {
+                std::cerr << "Sweep: shard " << shard << " done by " << session->name << " ("
+                          << book_.doneCount() << "/" << book_.size() << ")." << std::endl;
+            } else if (!book_.isDone(shard)) {
+                throw std::runtime_error("results don't match shard " + std::to_string(shard));
+            }
+            if (book_.finished()) {
+                finish();
+            } else {
+                assign(session);
+            }
+        } else if (type != "heartbeat") {
+            throw std::runtime_error("unknown message type '" + type + "'");
+        }
+    }
+
+    void assign(const SessionPtr& session) {
+        if (session->shard || !session->ready || session->closed || finished_) {
+            return;
+        }
+        if (auto shard = book_.next()) {
+            session->shard = shard;
+            send(session, {{"type", "shard"}, {"shard", *shard}, {"jobs", jobs_to_json(book_.jobsOf(*shard))}});
+        }
+    }
+
+    void drop(const SessionPtr& session, const std::string& reason) {
+        if (session->closed) {
+            return;
+        }
+        session->closed = true;
+        boost::system::error_code ignored;
+        session->socket.shutdown(tcp::socket::shutdown_both, ignored);
+        session->socket.close(ignored);
+        sessions_.erase(session);
+        if (session->shard) {
+            const size_t shard = *session->shard;
+            session->shard.reset();
+            const bool requeued = book_.fail(shard, session->name + ": " + reason);
+            std::cerr << "Sweep: lost " << session->name << " with shard " << shard << " (" << reason << ")"
+                      << (requeued ? "; reassigning it." : "; giving up on it.") << std::endl;
+            if (book_.finished()) {
+                finish();
+                return;
+            }
+            const auto idle = sessions_;
+            for (const auto& other : idle) {
+                assign(other);
+            }
+        }
+        check_workers_left();
+    }
+
+    // Drops workers that have gone quiet.
+    void watch() {
+        timer_.expires_after(std::chrono::milliseconds(std::max(50LL, options_.heartbeat_timeout_ms / 4)));
+        timer_.async_wait([this](boost::system::error_code ec) {
+            if (ec || finished_) {
+                return;
+            }
+            const auto cutoff = Clock::now() - std::chrono::milliseconds(options_.heartbeat_timeout_ms);
+            std::vector<SessionPtr> silent;
+            for (const auto& session : sessions_) {
+                if (session->last_seen < cutoff) {
+                    silent.push_back(session);
+                }
+            }
+            for (const auto& session : silent) {
+                drop(session, "no heartbeat for " + std::to_string(options_.heartbeat_timeout_ms) + " ms");
+            }
+            if (!finished_) {
+                watch();
+            }
+        });
+    }
+
+    // With only local workers, the sweep cannot go on once they are all gone.
+    void check_workers_left() {
+        if (!finished_ && local_workers_ == 0 && sessions_.empty() && options_.local_workers > 0) {
+            std::cerr << "Sweep: every local worker has exited." << std::endl;
+            book_.failRemaining("No workers left");
+            finish();
+        }
+    }
+
+    void finish() {
+        if (finished_) {
+            return;
+        }
+        finished_ = true;
+        boost::system::error_code ignored;
+        acceptor_.close(ignored);
+        timer_.cancel();
+        const auto sessions = sessions_;
+        for (const auto& session : sessions) {
+            send(session, {{"type", "done"}});
+        }
+    }
+
+    const json& base_config_;
+    const DistributedOptions& options_;
+    ShardBook& book_;
+    net::io_context io_;
+    tcp::acceptor acceptor_;
+    net::steady_timer timer_;
+    std::set<SessionPtr> sessions_;
+    int local_workers_ = 0;
+    bool finished_ = false;
+};
+
+std::string worker_name() {
+    return net::ip::host_name() + ":" + std::to_string(current_pid());
+}
+
+// Runs `body` while a thread calls `beat` every `period_ms`.
+template <typename Beat, typename Body>
+auto with_heartbeat(long long period_ms, Beat beat, Body body) {
+    std::mutex mutex;
+    std::condition_variable stop_cv;
+    bool stop = false;
+    std::thread heartbeat([&]() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!stop_cv.wait_for(lock, std::chrono::milliseconds(period_ms), [&]() { return stop; })) {
+            lock.unlock();
+            beat();
+            lock.lock();
+        }
+    });
+    auto stop_heartbeat = [&]() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        stop_cv.notify_one();
+        heartbeat.join();
+    };
+    try {
+        auto result = body();
+        stop_heartbeat();
+        return result;
+    } catch (...) {
+        stop_heartbeat();
+        throw;
+    }
+}
+
+} // namespace
+
+DistributedOptions DistributedOptions::fromConfig(const json& config) {
+    const json block = config.value("distributed", json::object());
+    DistributedOptions options;
+    options.address = block.value("address", options.address);
+    options.port = block.value("port", options.port);
+    options.shard_size = block.value("shard_size", options.shard_size);
+    options.heartbeat_ms = std::max(10LL, block.value("heartbeat_ms", options.heartbeat_ms));
+    options.heartbeat_timeout_ms = std::max(options.heartbeat_ms * 2, block.value("heartbeat_timeout_ms", options.heartbeat_timeout_ms));
+    options.max_attempts = block.value("max_attempts", options.max_attempts);
+    options.shared_dir = block.value("shared_dir", options.shared_dir);
+    options.local_workers = block.value("local_workers", options.local_workers);
+    options.local_worker_threads = block.value("local_worker_threads", options.local_worker_threads);
+    return options;
+}
+
+SweepCoordinator::SweepCoordinator(const json& base_config, std::vector<BatchJob> jobs, const DistributedOptions& options)
+    : base_config_(base_config), jobs_(std::move(jobs)), options_(options) {
+    std::set<std::string> ids;
+    for (const auto& job : jobs_) {
+        if (!ids.insert(job.id).second) {
+            throw std::runtime_error("Sweep: duplicate job id '" + job.id + "'");
+        }
+    }
+}
+
+std::vector<BatchJob> SweepCoordinator::optimizationJobs(const json& config) {
+    const json optimization = config.value("optimization", json::object());
+    const std::string strategy = optimization.value("strategy_to_optimize", "");
+    const ParameterSpace space = ParameterSpace::fromConfig(optimization.value("param_ranges", json::object()));
+    if (strategy.empty() || space.size() == 0) {
+        throw std::runtime_error("Sweep: optimization needs strategy_to_optimize and param_ranges");
+    }
+    if (space.gridSize() == 0) {
+        throw std::runtime_error("Sweep: distributed optimization needs a discrete grid");
+    }
+    std::vector<BatchJob> jobs;
+    for (const auto& params : space.grid()) {
+        jobs.push_back({params.dump(), {{"strategies", strategies_with_params(config, strategy, params)}}});
+    }
+    return jobs;
+}
+
+std::vector<BatchJob> SweepCoordinator::monteCarloJobs(const json& config, int num_simulations) {
+    const json monte_carlo = config.value("monte_carlo", json::object());
+    const std::string strategy = monte_carlo.value("strategy_to_test", "");
+    if (strategy.empty() || !monte_carlo.contains("base_params")) {
+        throw std::runtime_error("Sweep: monte_carlo needs strategy_to_test and base_params");
+    }
+    const auto parameter_sets = MonteCarloSimulator::parameterSets(monte_carlo, num_simulations);
+    std::vector<BatchJob> jobs;
+    for (size_t i = 0; i < parameter_sets.size(); ++i) {
+        jobs.push_back({"sim-" + std::to_string(i + 1), {{"strategies", strategies_with_params(config, strategy, parameter_sets[i])}}});
+    }
+    return jobs;
+}
+
+std::vector<BatchResult> SweepCoordinator::run() {
+    return options_.shared_dir.empty() ? runTcp() : runSharedDirectory();
+}
+
+std::vector<BatchResult> SweepCoordinator::runTcp() {
+    ShardBook book(jobs_, options_.shard_size, options_.max_attempts, on_result_);
+    TcpCoordinator coordinator(base_config_, options_, book);
+    const tcp::endpoint endpoint = coordinator.listen();
+    std::cerr << "Sweep: " << jobs_.size() << " jobs in " << book.size() << " shards; coordinator listening on "
+              << options_.address << ":" << endpoint.port() << "." << std::endl;
+    if (on_listening_) {
+        on_listening_(endpoint.port());
+    }
+    {
+        // Local workers reach the coordinator where it listens; the wildcard
+        // address is reachable through loopback.
+        net::ip::address host = endpoint.address();
+        if (host.is_unspecified()) {
+            host = host.is_v6() ? net::ip::address(net::ip::address_v6::loopback()) : net::ip::address(net::ip::address_v4::loopback());
+        }
+        LocalWorkers local;
+        local.start(options_, "--worker " + host.to_string() + ":" + std::to_string(endpoint.port()),
+                    [&coordinator]() { coordinator.localWorkerExited(); });
+        coordinator.run(options_.local_workers);
+    }
+    return std::move(book.results());
+}
+
+std::vector<BatchResult> SweepCoordinator::runSharedDirectory() {
+    const fs::path dir(options_.shared_dir);
+    const fs::path pending = dir / "pending", claimed = dir / "claimed", results = dir / "results";
+    // A fresh sweep: leftovers of an earlier one would be taken for this one's.
+    fs::remove(dir / "done");
+    for (const auto& sub : {pending, claimed, results}) {
+        fs::remove_all(sub);
+        fs::create_directories(sub);
+    }
+
+    ShardBook book(jobs_, options_.shard_size, options_.max_attempts, on_result_);
+    for (size_t shard = 0; shard < book.size(); ++shard) {
+        write_atomically(pending / shard_file(shard), jobs_to_json(book.jobsOf(shard)).dump(), dir);
+    }
+    write_atomically(dir / "sweep.json", json{{"config", base_config_}, {"heartbeat_ms", options_.heartbeat_ms}}.dump(), dir);
+    std::cerr << "Sweep: " << jobs_.size() << " jobs in " << book.size() << " shards under " << dir.string() << "." << std::endl;
+
+    std::atomic<int> local_running{options_.local_workers};
+    {
+        LocalWorkers local;
+        local.start(options_, "--worker-dir \"" + dir.string() + "\"", [&local_running]() { --local_running; });
+
+        const auto timeout = std::chrono::milliseconds(options_.heartbeat_timeout_ms);
+        while (!book.finished()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(std::min(200LL, options_.heartbeat_ms)));
+            for (const auto& entry : fs::directory_iterator(results)) {
+                const auto shard = shard_of(entry.path());
+                if (!shard || book.isDone(*shard)) {
+                    continue;
+                }
+                try {
+                    if (book.complete(*shard, read_json_file(entry.path()).value("results", json::array()))) {
+                        std::cerr << "Sweep: shard " << *shard << " done (" << book.doneCount() << "/" << book.size() << ")." << std::endl;
+                    }
+                } catch (const std::exception& e) {
+                    std::cerr << "Sweep: unreadable results " << entry.path().string() << ": " << e.what() << std::endl;
+                }
+            }
+            // A claim whose file hasn't been touched for the timeout belongs to a dead worker.
+            for (const auto& entry : fs::directory_iterator(claimed)) {
+                const auto shard = shard_of(entry.path());
+                std::error_code ec;
+                const auto touched = fs::last_write_time(entry.path(), ec);
+                if (!shard || book.isDone(*shard) || ec || fs::file_time_type::clock::now() - touched < timeout) {
+                    continue;
+                }
+                const std::string owner = entry.path().stem().string();
+                if (book.fail(*shard, owner + ": no heartbeat")) {
+                    fs::rename(entry.path(), pending / shard_file(*shard), ec);
+                    std::cerr << "Sweep: " << owner << " went quiet; reassigning shard " << *shard << "." << std::endl;
+                } else {
+                    fs::remove(entry.path(), ec);
+                    std::cerr << "Sweep: " << owner << " went quiet; giving up on shard " << *shard << "." << std::endl;
+                }
+            }
+            if (options_.local_workers > 0 && local_running == 0 && !book.finished()) {
+                std::cerr << "Sweep: every local worker has exited." << std::endl;
+                book.failRemaining("No workers left");
+            }
+        }
+        std::ofstream(dir / "done") << "done\n";
+    }
+    return std::move(book.results());
+}
+
+SweepWorker::SweepWorker(const DistributedOptions& options, int threads)
+    : options_(options), threads_(threads), name_(worker_name()) {}
+
+std::vector<BatchResult> SweepWorker::runShard(const json& base_config, const std::vector<BatchJob>& jobs) {
+    std::vector<BatchResult> results(jobs.size());
+    ScopedLogMute::muteStdout();
+    {
+        ThreadPool pool(std::max<size_t>(1, std::min(ThreadPool::resolveThreadCount(threads_), jobs.size())), true);
+        pool.parallelFor(jobs.size(), [&](size_t i) {
+            results[i] = BatchRunner::runJob(base_config, jobs[i].id, jobs[i].patch);
+        });
+    }
+    AsyncLogger::instance().flush();
+    return results;
+}
+
+void SweepWorker::runTcp(const std::string& host, unsigned short port, long long connect_timeout_ms) {
+    net::io_context io;
+    tcp::socket socket(io);
+    tcp::resolver resolver(io);
+    const auto deadline = Clock::now() + std::chrono::milliseconds(connect_timeout_ms);
+    for (;;) {
+        boost::system::error_code ec;
+        const auto endpoints = resolver.resolve(host, std::to_string(port), ec);
+        if (!ec) {
+            net::connect(socket, endpoints, ec);
+        }
+        if (!ec) {
+            break;
+        }
+        if (Clock::now() >= deadline) {
+            throw std::runtime_error("Worker: cannot reach coordinator at " + host + ":" + std::to_string(port) + ": " + ec.message());
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
+
+    std::mutex write_mutex;
+    auto send = [&](const json& message) {
+        const std::string line = message.dump() + "\n";
+        std::lock_guard<std::mutex> lock(write_mutex);
+        net::write(socket, net::buffer(line));
+    };
+    send({{"type", "hello"}, {"worker", name_}, {"threads", ThreadPool::resolveThreadCount(threads_)}});
+
+    net::streambuf buffer;
+    auto receive = [&]() {
+        const size_t bytes = net::read_until(socket, buffer, '\n');
+        const auto data = buffer.data();
+        const std::string line(net::buffers_begin(data), net::buffers_begin(data) + bytes);
+        buffer.consume(bytes);
+        return json::parse(line);
+    };
+
+    const json config_message = receive();
+    if (config_message.value("type", "") != "config") {
+        throw std::runtime_error("Worker: expected the sweep config from the coordinator");
+    }
+    const json base_config = config_message.at("config");
+    const long long heartbeat_ms = config_message.value("heartbeat_ms", options_.heartbeat_ms);
+    std::cerr << "Worker " << name_ << ": connected to " << host << ":" << port << "." << std::endl;
+
+    size_t shards = 0;
+    with_heartbeat(heartbeat_ms, [&]() {
+        try {
+            send({{"type", "heartbeat"}});
+        } catch (const std::exception&) {
+            // The read below sees the broken connection.
+        }
+    }, [&]() {
+        for (;;) {
+            const json message = receive();
+            const std::string type = message.value("type", "");
+            if (type == "done") {
+                return 0;
+            }
+            if (type != "shard") {
+                throw std::runtime_error("Worker: unexpected message '" + type + "'");
+            }
+            const auto results = runShard(base_config, jobs_from_json(message.at("jobs")));
+            send({{"type", "result"}, {"shard", message.at("shard")}, {"results", results_to_json(results)}});
+            ++shards;
+        }
+    });
+    std::cerr << "Worker " << name_ << ": sweep done after " << shards << " shards." << std::endl;
+}
+
+void SweepWorker::runSharedDirectory() {
+    const fs::path dir(options_.shared_dir);
+    const fs::path pending = dir / "pending", claimed = dir / "claimed", results = dir / "results";
+    std::string file_name = name_;
+    std::replace_if(file_name.begin(), file_name.end(), [](char c) { return !std::isalnum(static_cast<unsigned char>(c)) && c != '-'; }, '_');
+
+    // The coordinator may not have set the sweep up yet.
+    while (!fs::exists(dir / "sweep.json")) {
+        if (fs::exists(dir / "done")) {
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    }
+    const json sweep = read_json_file(dir / "sweep.json");
+    const json base_config = sweep.at("config");
+    const long long heartbeat_ms = sweep.value("heartbeat_ms", options_.heartbeat_ms);
+    std::cerr << "Worker " << name_ << ": taking shards from " << dir.string() << "." << std::endl;
+
+    size_t shards = 0;
+    while (!fs::exists(dir / "done")) {
+        // Claim a shard; rename is atomic, so only one worker gets each.
+        std::optional<size_t> shard;
+        fs::path claim;
+        std::error_code ec;
+        for (const auto& entry : fs::directory_iterator(pending, ec)) {
+            const auto candidate = shard_of(entry.path());
+            if (!candidate) {
+                continue;
+            }
+            claim = claimed / ("shard-" + std::to_string(*candidate) + "@" + file_name + ".json");
+            fs::rename(entry.path(), claim, ec);
+            if (!ec) {
+                // A rename keeps the pending file's age.
+                fs::last_write_time(claim, fs::file_time_type::clock::now(), ec);
+                shard = candidate;
+                break;
+            }
+        }
+        if (!shard) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(std::min(200LL, heartbeat_ms)));
+            continue;
+        }
+
+        const auto jobs = jobs_from_json(read_json_file(claim));
+        const auto shard_results = with_heartbeat(heartbeat_ms, [&claim]() {
+            std::error_code ignored;
+            fs::last_write_time(claim, fs::file_time_type::clock::now(), ignored);
+        }, [&]() {
+            return runShard(base_config, jobs);
+        });
+        write_atomically(results / shard_file(*shard), json{{"worker", name_}, {"results", results_to_json(shard_results)}}.dump(), dir);
+        fs::remove(claim, ec);
+        ++shards;
+    }
+    std::cerr << "Worker " << name_ << ": sweep done after " << shards << " shards." << std::endl;
+}
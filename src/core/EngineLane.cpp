@@ -0,0 +1,90 @@
+#include "../../include/core/EngineLane.h"
+#include "../../include/execution/SimulatedExecutionHandler.h"
+#include "../../include/strategy/StrategyFactory.h"
+
+bool dispatchToStrategies(const std::shared_ptr<Event>& event,
+                          const std::vector<std::shared_ptr<Strategy>>& strategies) {
+    switch (event->type) {
+        case EventType::MARKET:
+            for (auto& strategy : strategies) {
+                strategy->setSourceReceived(event->timestamp_received);
+                strategy->onMarket(static_cast<MarketEvent&>(*event));
+            }
+            return true;
+        case EventType::TRADE:
+            for (auto& strategy : strategies) {
+                strategy->setSourceReceived(event->timestamp_received);
+                strategy->onTrade(static_cast<TradeEvent&>(*event));
+            }
+            return true;
+        case EventType::ORDER_BOOK:
+            for (auto& strategy : strategies) {
+                strategy->setSourceReceived(event->timestamp_received);
+                strategy->onOrderBook(static_cast<OrderBookEvent&>(*event));
+            }
+            return true;
+        case EventType::MARKET_REGIME_CHANGED:
+            for (auto& strategy : strategies) {
+                strategy->onMarketRegimeChanged(static_cast<MarketRegimeChangedEvent&>(*event));
+            }
+            return true;
+        default:
+            return false;
+    }
+}
+
+void dispatchEvent(const std::shared_ptr<Event>& event,
+                   const std::vector<std::shared_ptr<Strategy>>& strategies,
+                   Portfolio& portfolio,
+                   RiskManager& risk_manager,
+                   ExecutionHandler& execution_handler) {
+    switch (event->type) {
+        case EventType::MARKET_REGIME_CHANGED:
+            portfolio.onMarketRegimeChanged(static_cast<MarketRegimeChangedEvent&>(*event));
+            dispatchToStrategies(event, strategies);
+            break;
+        case EventType::SIGNAL:
+            risk_manager.onSignal(static_cast<SignalEvent&>(*event));
+            break;
+        case EventType::ORDER:
+            execution_handler.onOrder(static_cast<OrderEvent&>(*event));
+            break;
+        case EventType::FILL:
+            portfolio.onFill(static_cast<FillEvent&>(*event));
+            break;
+        case EventType::DATA_SOURCE_STATUS:
+            risk_manager.onDataSourceStatus(static_cast<DataSourceStatusEvent&>(*event));
+            break;
+        default:
+            dispatchToStrategies(event, strategies);
+            break;
+    }
+}
+
+EngineLane::EngineLane(const nlohmann::json& config, std::shared_ptr<DataHandler> data_handler)
+    : event_queue_(std::make_shared<ThreadSafeQueue<std::shared_ptr<Event>>>()),
+      data_handler_(std::move(data_handler)) {
+    for (const auto& strategy_config : config.value("strategies", nlohmann::json::array())) {
+        if (strategy_config.value("active", false)) {
+            strategies_.push_back(StrategyFactory::createStrategy(strategy_config, event_queue_, data_handler_));
+        }
+    }
+    portfolio_ = std::make_shared<Portfolio>(event_queue_, config.value("initial_capital", 100000.0), data_handler_);
+    portfolio_->setEquityCurveEnabled(!config.value("headless", false));
+    portfolio_->setEquityResolution(EquityResolution::fromConfig(config));
+    execution_handler_ = std::make_shared<SimulatedExecutionHandler>(event_queue_, data_handler_);
+    risk_manager_ = std::make_shared<RiskManager>(event_queue_, portfolio_, config.value("risk", nlohmann::json::object()));
+}
+
+void EngineLane::process(const std::shared_ptr<Event>& event) {
+    handle(event);
+    while (auto queued = event_queue_->try_pop()) {
+        handle(*queued.value());
+    }
+}
+
+void EngineLane::handle(const std::shared_ptr<Event>& event) {
+    portfolio_->markToMarket(*event);
+    dispatchEvent(event, strategies_, *portfolio_, *risk_manager_, *execution_handler_);
+    ++event_count_;
+}
@@ -0,0 +1,224 @@
+#include "../../include/core/EquityRecorder.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+uint64_t bits_of(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double double_of(uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+int trailing_zeros(uint64_t value) {
+    if (value == 0) {
+        return 64;
+    }
+    int count = 0;
+    while (!(value & 1)) {
+        value >>= 1;
+        ++count;
+    }
+    return count;
+}
+
+bool same_state(const MarketState& a, const MarketState& b) {
+    return a.volatility == b.volatility && a.trend == b.trend && a.volatility_value == b.volatility_value;
+}
+
+// Point header byte: trailing zero bits of the equity XOR (64: unchanged) and
+// whether a market state follows.
+constexpr uint8_t kZerosMask = 0x7F;
+constexpr uint8_t kStateFlag = 0x80;
+
+} // namespace
+
+EquityResolution EquityResolution::fromConfig(const json& config) {
+    const json block = config.value("equity_curve", json::object());
+    EquityResolution resolution;
+    const std::string mode = block.value("mode", "every_event");
+    if (mode == "every_n") {
+        resolution.mode = Mode::EVERY_N;
+    } else if (mode == "interval") {
+        resolution.mode = Mode::INTERVAL;
+    } else if (mode == "on_change") {
+        resolution.mode = Mode::ON_CHANGE;
+    } else if (mode != "every_event") {
+        std::cerr << "Unknown equity_curve mode '" << mode << "', keeping every event." << std::endl;
+    }
+    resolution.every_n = std::max(1LL, block.value("every_n", resolution.every_n));
+    resolution.interval_ms = std::max(1LL, block.value("interval_ms", resolution.interval_ms));
+    resolution.min_change = std::max(0.0, block.value("min_change", resolution.min_change));
+    resolution.export_points = block.value("export_points", resolution.export_points);
+    return resolution;
+}
+
+EquityRecorder::EquityRecorder(const EquityResolution& resolution) : resolution_(resolution) {}
+
+bool EquityRecorder::keep(long long time, double equity, const MarketState& state) const {
+    if (kept_ == 0 || !same_state(state, last_state_)) {
+        return true;
+    }
+    switch (resolution_.mode) {
+        case EquityResolution::Mode::EVERY_N:
+            return offered_ % resolution_.every_n == 0;
+        case EquityResolution::Mode::INTERVAL:
+            return time - last_time_ >= resolution_.interval_ms;
+        case EquityResolution::Mode::ON_CHANGE:
+            return resolution_.min_change > 0.0 ? std::abs(equity - last_equity_) > resolution_.min_change * std::abs(last_equity_)
+                                                : equity != last_equity_;
+        default:
+            return true;
+    }
+}
+
+void EquityRecorder::append(long long time, double equity, const MarketState& state) {
+    const bool state_changed = kept_ == 0 || !same_state(state, last_state_);
+    const uint64_t delta = bits_of(equity) ^ bits_of(kept_ == 0 ? 0.0 : last_equity_);
+    const int zeros = trailing_zeros(delta);
+    data_.putSignedVarint(time - last_time_);
+    data_.put<uint8_t>(static_cast<uint8_t>(zeros) | (state_changed ? kStateFlag : 0));
+    if (delta != 0) {
+        data_.putVarint(delta >> zeros);
+    }
+    if (state_changed) {
+        data_.put(state);
+    }
+    ++kept_;
+    last_time_ = time;
+    last_equity_ = equity;
+    last_state_ = state;
+}
+
+void EquityRecorder::record(long long time, double equity, const MarketState& state) {
+    if (keep(time, equity, state)) {
+        append(time, equity, state);
+        has_tail_ = false;
+    } else {
+        tail_ = EquityPoint(time, equity, state);
+        has_tail_ = true;
+    }
+    ++offered_;
+}
+
+void EquityRecorder::clear() {
+    *this = EquityRecorder(resolution_);
+}
+
+std::vector<EquityPoint> EquityRecorder::points() const {
+    std::vector<EquityPoint> points;
+    points.reserve(size());
+    StateReader in(data_.bytes().data(), data_.bytes().size());
+    long long time = 0;
+    uint64_t bits = 0;
+    MarketState state;
+    for (size_t i = 0; i < kept_; ++i) {
+        time += in.getSignedVarint();
+        const uint8_t header = in.get<uint8_t>();
+        const int zeros = header & kZerosMask;
+        if (zeros < 64) {
+            bits ^= in.getVarint() << zeros;
+        }
+        if (header & kStateFlag) {
+            state = in.getMarketState();
+        }
+        points.emplace_back(time, double_of(bits), state);
+    }
+    if (has_tail_) {
+        points.push_back(tail_);
+    }
+    return points;
+}
+
+std::vector<EquityPoint> EquityRecorder::downsample(size_t threshold) const {
+    return lttb(points(), threshold);
+}
+
+std::vector<EquityPoint> EquityRecorder::lttb(const std::vector<EquityPoint>& points, size_t threshold) {
+    if (threshold >= points.size() || threshold < 3) {
+        return points;
+    }
+    std::vector<EquityPoint> sampled;
+    sampled.reserve(threshold);
+    sampled.push_back(points.front());
+    // Points between the first and the last, in threshold - 2 buckets
+    const double bucket = static_cast<double>(points.size() - 2) / (threshold - 2);
+    size_t selected = 0;
+    for (size_t b = 0; b < threshold - 2; ++b) {
+        const size_t begin = static_cast<size_t>(b * bucket) + 1;
+        const size_t end = static_cast<size_t>((b + 1) * bucket) + 1;
+        // Average of the next bucket (the last point for the last bucket)
+        const size_t next_begin = end;
+        const size_t next_end = std::min(points.size(), static_cast<size_t>((b + 2) * bucket) + 1);
+        double avg_x = 0.0, avg_y = 0.0;
+        for (size_t i = next_begin; i < next_end; ++i) {
+            avg_x += static_cast<double>(std::get<0>(points[i]));
+            avg_y += std::get<1>(points[i]);
+        }
+        if (next_begin < next_end) {
+            avg_x /= next_end - next_begin;
+            avg_y /= next_end - next_begin;
+        } else {
+            avg_x = static_cast<double>(std::get<0>(points.back()));
+            avg_y = std::get<1>(points.back());
+        }
+
+        // The point of this bucket spanning the largest triangle with the
+        // last selected point and that average
+        const double ax = static_cast<double>(std::get<0>(points[selected]));
+        const double ay = std::get<1>(points[selected]);
+        double max_area = -1.0;
+        size_t best = begin;
+        for (size_t i = begin; i < end; ++i) {
+            const double area = std::abs((ax - avg_x) * (std::get<1>(points[i]) - ay) -
+                                         (ax - static_cast<double>(std::get<0>(points[i]))) * (avg_y - ay));
+            if (area > max_area) {
+                max_area = area;
+                best = i;
+            }
+        }
+        sampled.push_back(points[best]);
+        selected = best;
+    }
+    sampled.push_back(points.back());
+    return sampled;
+}
+
+void EquityRecorder::saveState(StateWriter& out) const {
+    out.put<uint64_t>(kept_);
+    out.put(offered_);
+    out.put(data_.bytes());
+    out.put(last_time_);
+    out.put(last_equity_);
+    out.put(last_state_);
+    out.put(has_tail_);
+    if (has_tail_) {
+        out.put(std::get<0>(tail_));
+        out.put(std::get<1>(tail_));
+        out.put(std::get<2>(tail_));
+    }
+}
+
+void EquityRecorder::loadState(StateReader& in) {
+    kept_ = static_cast<size_t>(in.get<uint64_t>());
+    offered_ = in.get<long long>();
+    data_ = StateWriter();
+    data_.append(in.getString());
+    last_time_ = in.get<long long>();
+    last_equity_ = in.get<double>();
+    last_state_ = in.getMarketState();
+    has_tail_ = in.get<uint8_t>() != 0;
+    if (has_tail_) {
+        const long long time = in.get<long long>();
+        const double equity = in.get<double>();
+        tail_ = EquityPoint(time, equity, in.getMarketState());
+    }
+}
@@ -0,0 +1,95 @@
+#include "../../include/core/FanOutEngine.h"
+#include "../../include/core/Backtester.h"
+#include <algorithm>
+#include <cmath>
+
+FanOutEngine::FanOutEngine(const json& base_config,
+                           const std::string& strategy_name,
+                           const std::vector<json>& parameter_sets)
+    : feed_(std::make_shared<ThreadSafeQueue<std::shared_ptr<Event>>>()),
+      parameter_sets_(parameter_sets),
+      errors_(parameter_sets.size()),
+      stopped_(parameter_sets.size(), false) {
+    if (!base_config.contains("symbols") || !base_config["symbols"].is_array() || base_config["symbols"].empty()) {
+        throw std::runtime_error("Config error: 'symbols' must be a non-empty array");
+    }
+    data_handler_ = Backtester::createHistoricalDataHandler(base_config, feed_);
+
+    for (size_t i = 0; i < parameter_sets.size(); ++i) {
+        json lane_config = base_config;
+        for (auto& strategy_config : lane_config["strategies"]) {
+            if (strategy_config["name"] == strategy_name) {
+                strategy_config["params"] = parameter_sets[i];
+                break;
+            }
+        }
+        try {
+            lanes_.push_back(std::make_unique<EngineLane>(lane_config, data_handler_));
+        } catch (const std::exception& e) {
+            lanes_.push_back(nullptr);
+            errors_[i] = e.what();
+        }
+    }
+}
+
+void FanOutEngine::setStopCondition(std::function<bool(size_t, const Portfolio&)> condition, long long every_events) {
+    stop_condition_ = std::move(condition);
+    stop_check_interval_ = std::max(1LL, every_events);
+}
+
+void FanOutEngine::run() {
+    std::vector<EngineLane*> active;
+    for (auto& lane : lanes_) {
+        if (lane && lane->isActive()) active.push_back(lane.get());
+    }
+    long long next_stop_check = stop_check_interval_;
+
+    while (!active.empty() && !data_handler_->isFinished()) {
+        data_handler_->updateBars();
+        while (auto queued = feed_->try_pop()) {
+            const std::shared_ptr<Event> event = *queued.value();
+            for (EngineLane* lane : active) {
+                lane->process(event);
+            }
+            ++events_replayed_;
+        }
+
+        if (stop_condition_ && events_replayed_ >= next_stop_check) {
+            next_stop_check = events_replayed_ + stop_check_interval_;
+            for (size_t i = 0; i < lanes_.size(); ++i) {
+                if (lanes_[i] && lanes_[i]->isActive() && stop_condition_(i, *lanes_[i]->getPortfolio())) {
+                    lanes_[i]->retire();
+                    stopped_[i] = true;
+                }
+            }
+            active.erase(std::remove_if(active.begin(), active.end(),
+                                        [](EngineLane* lane) { return !lane->isActive(); }),
+                         active.end());
+        }
+    }
+}
+
+std::vector<ParameterResult> FanOutEngine::results() const {
+    std::vector<ParameterResult> results(lanes_.size());
+    for (size_t i = 0; i < lanes_.size(); ++i) {
+        ParameterResult& result = results[i];
+        result.params = parameter_sets_[i];
+        if (!lanes_[i]) {
+            result.error = errors_[i];
+            continue;
+        }
+        if (stopped_[i]) {
+            result.stopped_early = true;
+            result.error = "Abandoned on a hard stop";
+            continue;
+        }
+        result.metrics = lanes_[i]->getPortfolio()->runMetrics();
+        result.metric = result.metrics.sharpe;
+        result.total_return = result.metrics.total_return;
+        result.ok = !std::isnan(result.metric);
+        if (!result.ok) {
+            result.error = "Sharpe ratio is undefined";
+        }
+    }
+    return results;
+}
@@ -1,7 +1,12 @@
 #include "../../include/core/MonteCarloSimulator.h"
-#include "../../include/core/Backtester.h"
+#include "../../include/core/Optimizer.h"
+#include "../../include/core/Philox.h"
+#include "../../include/core/ThreadPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
 #include <iostream>
-#include <random>
+#include <numeric>
 #include <vector>
 
 MonteCarloSimulator::MonteCarloSimulator(const json& config) : config_(config) {
@@ -10,6 +15,32 @@ MonteCarloSimulator::MonteCarloSimulator(const json& config) : config_(config) {
     }
 }
 
+std::vector<json> MonteCarloSimulator::parameterSets(const json& mc_params, int num_simulations) {
+    json base_params = mc_params["base_params"];
+    const uint64_t seed = mc_params.value("seed", 42ULL);
+    const json ranges = mc_params.value("randomization_ranges", json::object());
+
+    // Simulation i draws its parameters from Philox stream i, so a run is
+    // reproducible from the seed whatever the thread count.
+    std::vector<json> parameter_sets(num_simulations > 0 ? num_simulations : 0);
+    for (size_t i = 0; i < parameter_sets.size(); ++i) {
+        Philox4x32 rng(seed, i);
+        json randomized_params = base_params;
+        for (auto& item : ranges.items()) {
+            const std::string& param_name = item.key();
+            double min_val = item.value()[0];
+            double max_val = item.value()[1];
+            if (randomized_params[param_name].is_number_integer()) {
+                randomized_params[param_name] = static_cast<int>(min_val + rng.uniform() * (max_val - min_val));
+            } else {
+                randomized_params[param_name] = min_val + rng.uniform() * (max_val - min_val);
+            }
+        }
+        parameter_sets[i] = std::move(randomized_params);
+    }
+    return parameter_sets;
+}
+
 void MonteCarloSimulator::run(int num_simulations) {
     if (!mc_params_.is_object() || !mc_params_.value("enabled", false)) {
         std::cout << "Monte Carlo simulation is disabled or not configured." << std::endl;
@@ -19,44 +50,37 @@ void MonteCarloSimulator::run(int num_simulations) {
     std::cout << "--- Starting Monte Carlo Simulation ---" << std::endl;
     std::cout << "Number of simulations: " << num_simulations << std::endl;
 
-    json base_params = mc_params_["base_params"];
     std::string strategy_to_test = mc_params_["strategy_to_test"];
-    
-    std::vector<double> results;
-    std::default_random_engine generator;
+    std::vector<json> parameter_sets = parameterSets(mc_params_, num_simulations);
 
-    for (int i = 0; i < num_simulations; ++i) {
-        json randomized_params = base_params;
-        
-        // Randomize parameters
-        for (auto& item : mc_params_["randomization_ranges"].items()) {
-            std::string param_name = item.key();
-            double min_val = item.value()[0];
-            double max_val = item.value()[1];
-            std::uniform_real_distribution<double> distribution(min_val, max_val);
-            
-            if (randomized_params[param_name].is_number_integer()) {
-                randomized_params[param_name] = static_cast<int>(distribution(generator));
-            } else {
-                randomized_params[param_name] = distribution(generator);
-            }
-        }
-        
-        std::cout << "\nRunning simulation " << i + 1 << " with params: " << randomized_params.dump() << std::endl;
-        
-        json run_config = config_;
-        for (auto& strategy_config : run_config["strategies"]) {
-            if (strategy_config["name"] == strategy_to_test) {
-                strategy_config["params"] = randomized_params;
-                break;
-            }
-        }
+    const size_t threads = std::max<size_t>(1, std::min(ThreadPool::resolveThreadCount(mc_params_.value("max_threads", 0)), parameter_sets.size()));
+    std::cout << "Running on " << threads << " threads..." << std::endl;
+    auto start_time = std::chrono::steady_clock::now();
 
-        Backtester backtester(run_config);
-        backtester.run();
-        double result = backtester.getPortfolio()->getRealTimePerformance().getSharpeRatio();
-        results.push_back(result);
-        std::cout << "Resulting Sharpe Ratio: " << result << std::endl;
+    std::vector<ParameterResult> runs(parameter_sets.size());
+    {
+        ThreadPool pool(threads, true);
+        pool.parallelFor(parameter_sets.size(), [&](size_t i) {
+            runs[i] = Optimizer::evaluate(config_, strategy_to_test, parameter_sets[i]);
+        });
+    }
+
+    std::vector<double> results;
+    for (size_t i = 0; i < runs.size(); ++i) {
+        if (runs[i].ok) {
+            results.push_back(runs[i].metric);
+            std::cout << "Simulation " << i + 1 << " with params " << runs[i].params.dump()
+                      << " -> Sharpe Ratio: " << runs[i].metric << std::endl;
+        } else {
+            std::cout << "Simulation " << i + 1 << " with params " << runs[i].params.dump()
+                      << " failed: " << runs[i].error << std::endl;
+        }
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
+    std::cout << runs.size() << " simulations in " << elapsed << " ms." << std::endl;
+    if (results.empty()) {
+        std::cout << "No simulation completed." << std::endl;
+        return;
     }
 
     std::cout << "\n--- Monte Carlo Simulation Complete ---" << std::endl;
@@ -1,7 +1,93 @@
 #include "../../include/core/Optimizer.h"
 #include "../../include/core/Backtester.h"
+#include "../../include/core/FanOutEngine.h"
 #include "../../include/core/Portfolio.h"
+#include "../../include/core/ResultCache.h"
+#include "../../include/core/ThreadPool.h"
+#include "../../include/core/AsyncLogger.h"
+#include "../../include/data/HFTDataHandler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
 #include <iostream>
+#include <numeric>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+// Whether a running backtest has breached a hard stop. The portfolio keeps
+// its drawdown and Sharpe up to date, so a check costs the same at any point.
+bool breaches_hard_stop(const EvaluationOptions& options, const Portfolio& portfolio) {
+    const RunMetrics metrics = portfolio.runMetrics();
+    if (options.max_drawdown > 0.0 && metrics.max_drawdown > options.max_drawdown) {
+        return true;
+    }
+    // Returns start at the second point
+    return std::isfinite(options.min_sharpe) && metrics.points > options.min_points_for_sharpe &&
+           metrics.points > 2 && metrics.sharpe < options.min_sharpe;
+}
+
+// `base_config` set up for one backtest of a sweep.
+json sweep_run_config(const json& base_config, const EvaluationOptions& options) {
+    json run_config = Backtester::headlessRunConfig(base_config);
+    if (options.window_start_ms > 0) run_config["data"]["window_start_ms"] = options.window_start_ms;
+    if (options.window_end_ms > 0) run_config["data"]["window_end_ms"] = options.window_end_ms;
+    return run_config;
+}
+
+// `run_config` with `params` applied to `strategy_name`.
+json with_params(const json& run_config, const std::string& strategy_name, const json& params) {
+    json config = run_config;
+    for (auto& strategy_config : config["strategies"]) {
+        if (strategy_config["name"] == strategy_name) {
+            strategy_config["params"] = params;
+            break;
+        }
+    }
+    return config;
+}
+
+// Fills in the score of a run that went to the end.
+void set_metrics(ParameterResult& result, const RunMetrics& metrics) {
+    result.metrics = metrics;
+    result.metric = metrics.sharpe;
+    result.total_return = metrics.total_return;
+    result.ok = !std::isnan(result.metric);
+    if (!result.ok) {
+        result.error = "Sharpe ratio is undefined";
+    }
+}
+
+bool has_hard_stops(const EvaluationOptions& options) {
+    return options.max_drawdown > 0.0 || std::isfinite(options.min_sharpe);
+}
+
+// Evaluation settings shared by every search method.
+EvaluationOptions sweep_options(const json& optimization_config) {
+    EvaluationOptions options;
+    options.max_threads = optimization_config.value("max_threads", 0);
+    options.fan_out = optimization_config.value("fan_out", false);
+    return options;
+}
+
+// First and last trade timestamps of the configured dataset, or {0, 0}.
+std::pair<long long, long long> dataset_time_span(const json& base_config) {
+    json probe_config = sweep_run_config(base_config, EvaluationOptions());
+    ScopedLogMute::muteStdout();
+    ScopedLogMute mute;
+    try {
+        Backtester probe(probe_config);
+        auto hft_handler = std::dynamic_pointer_cast<HFTDataHandler>(probe.getDataHandler());
+        return hft_handler ? hft_handler->timeSpan() : std::make_pair(0LL, 0LL);
+    } catch (const std::exception&) {
+        return {0, 0}; // The grid fallback reports the error per run
+    }
+}
+
+} // namespace
 
 Optimizer::Optimizer(const json& config) : config_(config) {
     if (config.contains("optimization")) {
@@ -17,47 +103,32 @@ json Optimizer::run() {
 
     std::cout << "--- Starting Strategy Optimization ---" << std::endl;
 
-    std::vector<json> param_combinations;
-    json current_combination;
-    generate_param_combinations(
-        optimization_params_["param_ranges"].begin(),
-        optimization_params_["param_ranges"].end(),
-        current_combination,
-        param_combinations
-    );
-
-    std::cout << "Generated " << param_combinations.size() << " parameter combinations." << std::endl;
-
-    double best_metric_ = -std::numeric_limits<double>::infinity();
-    json best_params_;
-
-    for (const auto& params : param_combinations) {
-        std::cout << "\nTesting parameters: " << params.dump() << std::endl;
-
-        json run_config = config_;
-        std::string strategy_to_optimize = optimization_params_["strategy_to_optimize"];
-        
-        for (auto& strategy_config : run_config["strategies"]) {
-            if (strategy_config["name"] == strategy_to_optimize) {
-                strategy_config["params"] = params;
-                break;
-            }
-        }
-        
-        Backtester backtester(run_config);
-        backtester.run();
-        
-        std::shared_ptr<Portfolio> portfolio = backtester.getPortfolio();
-        double current_metric = portfolio->getRealTimePerformance().getSharpeRatio();
+    ParameterSpace space = ParameterSpace::fromConfig(optimization_params_["param_ranges"]);
+    std::cout << "Parameter space: " << space.size() << " parameters, "
+              << space.gridSize() << " grid combinations." << std::endl;
 
-        std::cout << "Resulting Sharpe Ratio: " << current_metric << std::endl;
+    std::string strategy_to_optimize = optimization_params_["strategy_to_optimize"];
+    auto results = search(config_, strategy_to_optimize, space, optimization_params_);
 
-        if (current_metric > best_metric_) {
-            best_metric_ = current_metric;
-            best_params_ = params;
+    for (const auto& result : results) {
+        if (result.fidelity < 1.0) {
+            continue; // Pruned before the full range
+        }
+        if (result.ok) {
+            std::cout << "Parameters " << result.params.dump() << " -> Sharpe Ratio: " << result.metric << std::endl;
+        } else {
+            std::cout << "Parameters " << result.params.dump() << " failed: " << result.error << std::endl;
         }
     }
 
+    best_metric_ = -std::numeric_limits<double>::infinity();
+    best_params_ = json{};
+    int best = bestResultIndex(results);
+    if (best >= 0) {
+        best_metric_ = results[best].metric;
+        best_params_ = results[best].params;
+    }
+
     std::cout << "\n--- Optimization Complete ---" << std::endl;
     std::cout << "Best parameters found: " << best_params_.dump() << std::endl;
     std::cout << "Best Sharpe Ratio: " << best_metric_ << std::endl;
@@ -66,30 +137,360 @@ json Optimizer::run() {
     return best_params_;
 }
 
-json Optimizer::getBestParams() const {
-    return best_params_;
+std::vector<ParameterResult> Optimizer::evaluateParameterSets(
+    const json& base_config,
+    const std::string& strategy_name,
+    const std::vector<json>& parameter_sets,
+    int max_threads
+) {
+    EvaluationOptions options;
+    options.max_threads = max_threads;
+    return evaluateParameterSets(base_config, strategy_name, parameter_sets, options);
 }
 
-double Optimizer::getBestMetric() const {
-    return best_metric_;
+std::vector<ParameterResult> Optimizer::evaluateParameterSets(
+    const json& base_config,
+    const std::string& strategy_name,
+    const std::vector<json>& parameter_sets,
+    const EvaluationOptions& options
+) {
+    std::vector<ParameterResult> results(parameter_sets.size());
+    if (parameter_sets.empty()) {
+        return results;
+    }
+
+    size_t threads = std::min(ThreadPool::resolveThreadCount(options.max_threads), parameter_sets.size());
+    std::cout << "Evaluating " << parameter_sets.size() << " parameter sets on " << threads << " threads..." << std::endl;
+    auto start_time = std::chrono::steady_clock::now();
+
+    // Workers are muted: a thousand full reports are of no use to anyone.
+    ThreadPool pool(threads, true);
+    if (options.fan_out) {
+        // Sets the result cache already holds need no lane; as in evaluate(),
+        // a cached run went to the end, which one with hard stops might not have.
+        const json run_config = sweep_run_config(base_config, options);
+        ResultCache* cache = ResultCache::forConfig(run_config);
+        std::vector<std::string> cache_keys(parameter_sets.size());
+        std::vector<size_t> misses;
+        for (size_t i = 0; i < parameter_sets.size(); ++i) {
+            results[i].params = parameter_sets[i];
+            if (cache) {
+                cache_keys[i] = ResultCache::key(with_params(run_config, strategy_name, parameter_sets[i]));
+                if (!has_hard_stops(options)) {
+                    if (auto cached = cache->find(cache_keys[i])) {
+                        set_metrics(results[i], cached->metrics);
+                        continue;
+                    }
+                }
+            }
+            misses.push_back(i);
+        }
+
+        // One replay per thread, each feeding a contiguous share of the misses.
+        const size_t groups = std::min(threads, misses.size());
+        pool.parallelFor(groups, [&](size_t group) {
+            const size_t begin = misses.size() * group / groups;
+            const size_t end = misses.size() * (group + 1) / groups;
+            std::vector<json> share;
+            for (size_t k = begin; k < end; ++k) {
+                share.push_back(parameter_sets[misses[k]]);
+            }
+            try {
+                FanOutEngine engine(run_config, strategy_name, share);
+                if (has_hard_stops(options)) {
+                    engine.setStopCondition([&options](size_t, const Portfolio& portfolio) {
+                        return breaches_hard_stop(options, portfolio);
+                    }, options.check_every_events);
+                }
+                if (cache && cache->storesEquity()) {
+                    for (size_t lane = 0; lane < engine.size(); ++lane) {
+                        if (engine.lane(lane)) {
+                            engine.lane(lane)->getPortfolio()->setEquityCurveEnabled(true);
+                        }
+                    }
+                }
+                engine.run();
+                auto share_results = engine.results();
+                for (size_t lane = 0; lane < share_results.size(); ++lane) {
+                    const size_t i = misses[begin + lane];
+                    if (cache && engine.lane(lane) && !share_results[lane].stopped_early) {
+                        cache->store(cache_keys[i], ResultCache::capture(*engine.lane(lane)));
+                    }
+                    results[i] = std::move(share_results[lane]);
+                }
+            } catch (const std::exception& e) {
+                for (size_t k = begin; k < end; ++k) {
+                    results[misses[k]].error = e.what();
+                }
+            }
+        });
+    } else {
+        pool.parallelFor(parameter_sets.size(), [&](size_t i) {
+            results[i] = evaluate(base_config, strategy_name, parameter_sets[i], options);
+        });
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
+    std::cout << "Evaluated " << parameter_sets.size() << " parameter sets in " << elapsed << " ms." << std::endl;
+    return results;
+}
+
+ParameterResult Optimizer::evaluate(
+    const json& base_config,
+    const std::string& strategy_name,
+    const json& params,
+    const EvaluationOptions& options
+) {
+    ParameterResult result;
+    result.params = params;
+    try {
+        const json run_config = with_params(sweep_run_config(base_config, options), strategy_name, params);
+
+        ResultCache* cache = ResultCache::forConfig(run_config);
+        const std::string cache_key = cache ? ResultCache::key(run_config) : "";
+        // A cached run went to the end, which one with hard stops might not have.
+        std::optional<CachedRun> cached;
+        if (cache && !has_hard_stops(options)) {
+            cached = cache->find(cache_key);
+        }
+        if (cached) {
+            set_metrics(result, cached->metrics);
+        } else {
+            Backtester backtester(run_config);
+            if (cache && cache->storesEquity()) {
+                backtester.getPortfolio()->setEquityCurveEnabled(true);
+            }
+            if (has_hard_stops(options)) {
+                backtester.setStopCondition([&options](const Portfolio& portfolio) {
+                    return breaches_hard_stop(options, portfolio);
+                }, options.check_every_events);
+            }
+            backtester.run();
+            if (backtester.stoppedEarly()) {
+                result.stopped_early = true;
+                result.error = "Abandoned on a hard stop";
+                return result;
+            }
+            set_metrics(result, backtester.runMetrics());
+            if (cache) {
+                cache->store(cache_key, ResultCache::capture(backtester));
+            }
+        }
+    } catch (const std::exception& e) {
+        result.error = e.what();
+    }
+    return result;
+}
+
+std::vector<ParameterResult> Optimizer::search(
+    const json& base_config,
+    const std::string& strategy_name,
+    const ParameterSpace& space,
+    const json& optimization_config
+) {
+    std::string method = optimization_config.value("search", "grid");
+    if (method == "random" || method == "lhs" || method == "bayesian" || method == "cmaes") {
+        return adaptiveSearch(base_config, strategy_name, space, optimization_config);
+    }
+    if (space.gridSize() == 0 && space.size() > 0) {
+        throw std::runtime_error("Search '" + method + "' needs a discrete grid; use an adaptive search for continuous ranges");
+    }
+    if (method == "successive_halving") {
+        return successiveHalving(base_config, strategy_name, space.grid(), optimization_config);
+    }
+    if (method != "grid") {
+        std::cerr << "Unknown optimization search '" << method << "', using grid." << std::endl;
+    }
+    return evaluateParameterSets(base_config, strategy_name, space.grid(), sweep_options(optimization_config));
 }
 
-void Optimizer::generate_param_combinations(
-    json::const_iterator current_param,
-    json::const_iterator end_param,
-    json& current_combination,
-    std::vector<json>& all_combinations
+std::vector<ParameterResult> Optimizer::successiveHalving(
+    const json& base_config,
+    const std::string& strategy_name,
+    const std::vector<json>& parameter_sets,
+    const json& optimization_config
 ) {
-    if (current_param == end_param) {
-        all_combinations.push_back(current_combination);
-        return;
+    json sh_config = optimization_config.value("successive_halving", json::object());
+    const size_t n = parameter_sets.size();
+    const double eta = std::max(2.0, sh_config.value("eta", 3.0));
+
+    EvaluationOptions options = sweep_options(optimization_config);
+    options.max_drawdown = sh_config.value("max_drawdown", 0.0);
+    if (sh_config.contains("min_sharpe")) options.min_sharpe = sh_config["min_sharpe"].get<double>();
+    options.check_every_events = sh_config.value("check_every_events", 5000LL);
+
+    auto [first_ms, last_ms] = dataset_time_span(base_config);
+    if (n < 2 || last_ms <= first_ms) {
+        std::cout << "Successive halving needs a historical trade dataset and at least two candidates; running a full grid." << std::endl;
+        return evaluateParameterSets(base_config, strategy_name, parameter_sets, options);
+    }
+
+    // Enough rungs to get from n candidates down to about one.
+    int default_rungs = static_cast<int>(std::floor(std::log(static_cast<double>(n)) / std::log(eta)));
+    int rungs = std::max(0, sh_config.value("rungs", default_rungs));
+    const long long span_ms = last_ms - first_ms + 1;
+
+    std::vector<ParameterResult> results(n);
+    for (size_t i = 0; i < n; ++i) {
+        results[i].params = parameter_sets[i];
+        results[i].fidelity = 0.0;
+    }
+    std::vector<size_t> survivors(n);
+    std::iota(survivors.begin(), survivors.end(), 0);
+    double replay_work = 0.0; // In full-range runs
+
+    for (int rung = 0; rung <= rungs && !survivors.empty(); ++rung) {
+        const double fraction = std::pow(eta, rung - rungs);
+        EvaluationOptions rung_options = options;
+        if (rung < rungs) {
+            rung_options.window_end_ms = first_ms + static_cast<long long>(std::ceil(span_ms * fraction));
+        }
+
+        std::ostringstream rung_line;
+        rung_line << "Successive halving rung " << rung + 1 << "/" << rungs + 1 << ": "
+                  << survivors.size() << " candidates on " << std::fixed << std::setprecision(1)
+                  << fraction * 100.0 << "% of the data";
+        std::cout << rung_line.str() << std::endl;
+
+        std::vector<json> rung_sets;
+        for (size_t i : survivors) rung_sets.push_back(parameter_sets[i]);
+        auto rung_results = evaluateParameterSets(base_config, strategy_name, rung_sets, rung_options);
+        replay_work += fraction * survivors.size();
+
+        for (size_t k = 0; k < survivors.size(); ++k) {
+            results[survivors[k]] = rung_results[k];
+            results[survivors[k]].fidelity = fraction;
+        }
+        if (rung == rungs) {
+            break;
+        }
+
+        // Promote the best 1/eta of the runs that finished, in input order.
+        // The quantile is only known once the whole rung has run: cutting
+        // mid-run would compare candidates at whatever point the concurrent
+        // runs happen to have reached, and make the result depend on timing.
+        std::vector<size_t> ranked;
+        for (size_t i : survivors) {
+            if (results[i].ok) ranked.push_back(i);
+        }
+        std::stable_sort(ranked.begin(), ranked.end(), [&](size_t a, size_t b) {
+            return results[a].metric > results[b].metric;
+        });
+        size_t keep = std::min(ranked.size(), static_cast<size_t>(std::ceil(survivors.size() / eta)));
+        ranked.resize(keep);
+        std::sort(ranked.begin(), ranked.end());
+        survivors = std::move(ranked);
+    }
+
+    std::ostringstream summary;
+    summary << "Successive halving replayed " << std::fixed << std::setprecision(1) << replay_work
+            << " full-range equivalents for " << n << " candidates (grid: " << n << ").";
+    std::cout << summary.str() << std::endl;
+    return results;
+}
+
+std::vector<ParameterResult> Optimizer::adaptiveSearch(
+    const json& base_config,
+    const std::string& strategy_name,
+    const ParameterSpace& space,
+    const json& optimization_config
+) {
+    const std::string method = optimization_config.value("search", "random");
+    const EvaluationOptions options = sweep_options(optimization_config);
+    const int max_threads = options.max_threads;
+    const size_t grid_size = space.gridSize();
+    std::vector<ParameterResult> results;
+    if (space.size() == 0) {
+        return evaluateParameterSets(base_config, strategy_name, {json::object()}, options);
+    }
+
+    size_t default_budget = grid_size > 0
+        ? std::max<size_t>(2 * space.size() + 2, static_cast<size_t>(std::ceil(grid_size * 0.1)))
+        : 20 * space.size();
+    size_t budget = optimization_config.value("max_evaluations", default_budget);
+    if (grid_size > 0) budget = std::min(budget, grid_size);
+    const size_t batch_size = std::max<size_t>(1, optimization_config.value("batch_size", ThreadPool::resolveThreadCount(max_threads)));
+    const uint64_t seed = optimization_config.value("seed", 42ULL);
+
+    json strategy_options = optimization_config.value(method, json::object());
+    if (method == "cmaes" && !strategy_options.contains("population")) {
+        // Keep every thread busy with one generation
+        const size_t default_population = 4 + static_cast<size_t>(3.0 * std::log(static_cast<double>(space.size())));
+        strategy_options["population"] = std::max(default_population, batch_size);
     }
+    auto strategy = makeSearchStrategy(method, space.size(), seed, strategy_options);
+
+    std::cout << "Adaptive search '" << strategy->name() << "': up to " << budget << " evaluations";
+    if (grid_size > 0) std::cout << " of a " << grid_size << "-point grid";
+    std::cout << ", batches of " << batch_size << "." << std::endl;
+
+    std::map<std::string, size_t> seen; // params.dump() -> index in results
+    int idle_rounds = 0;
+    int round = 0;
+    while (results.size() < budget && idle_rounds < 5) {
+        auto points = strategy->ask(std::min(batch_size, budget - results.size()));
+        if (points.empty()) {
+            break;
+        }
+
+        // Decode, and only backtest parameters not tried before
+        std::vector<std::string> keys;
+        std::vector<json> new_sets;
+        for (const auto& point : points) {
+            json params = space.decode(space.snap(point));
+            std::string key = params.dump();
+            if (!seen.count(key) && results.size() + new_sets.size() < budget) {
+                seen[key] = results.size() + new_sets.size();
+                new_sets.push_back(std::move(params));
+            }
+            keys.push_back(std::move(key));
+        }
+
+        auto batch_results = evaluateParameterSets(base_config, strategy_name, new_sets, options);
+        results.insert(results.end(), batch_results.begin(), batch_results.end());
+        idle_rounds = new_sets.empty() ? idle_rounds + 1 : 0;
 
-    const std::string& param_name = current_param.key();
-    const json& values = current_param.value();
+        std::vector<double> scores;
+        for (const auto& key : keys) {
+            auto it = seen.find(key);
+            const ParameterResult* result = it != seen.end() && it->second < results.size() ? &results[it->second] : nullptr;
+            scores.push_back(result && result->ok ? result->metric : std::numeric_limits<double>::quiet_NaN());
+        }
+        strategy->tell(points, scores);
 
-    for (const auto& value : values) {
-        current_combination[param_name] = value;
-        generate_param_combinations(current_param + 1, end_param, current_combination, all_combinations);
+        int best = bestResultIndex(results);
+        std::ostringstream progress;
+        progress << "Search round " << ++round << ": " << results.size() << "/" << budget << " evaluated";
+        if (best >= 0) {
+            progress << ", best Sharpe " << std::fixed << std::setprecision(4) << results[best].metric
+                     << " at " << results[best].params.dump();
+        }
+        std::cout << progress.str() << std::endl;
+
+        if (grid_size > 0 && seen.size() >= grid_size) {
+            break; // Every grid point has been tried
+        }
     }
-} 
\ No newline at end of file
+    return results;
+}
+
+int Optimizer::bestResultIndex(const std::vector<ParameterResult>& results) {
+    int best = -1;
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (!results[i].ok) continue;
+        if (best < 0 || results[i].fidelity > results[best].fidelity ||
+            (results[i].fidelity == results[best].fidelity && results[i].metric > results[best].metric)) {
+            best = static_cast<int>(i);
+        }
+    }
+    return best;
+}
+
+json Optimizer::getBestParams() const {
+    return best_params_;
+}
+
+double Optimizer::getBestMetric() const {
+    return best_metric_;
+}
+
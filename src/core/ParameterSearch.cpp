@@ -0,0 +1,641 @@
+#include "../../include/core/ParameterSearch.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+
+namespace {
+
+constexpr double kPi = 3.14159265358979323846; // M_PI is not standard C++
+
+bool ends_with(const std::string& s, const std::string& suffix) {
+    return s.size() > suffix.size() && s.compare(s.size() - suffix.size(), suffix.size(), suffix) == 0;
+}
+
+ParameterSpace::Dimension stepped_range(const std::string& name, const json& start, const json& end, const json& step) {
+    const double first = start.get<double>();
+    const double last = end.get<double>();
+    const double increment = step.get<double>();
+    if (!(increment > 0.0)) {
+        throw std::invalid_argument("Parameter '" + name + "' needs a positive step");
+    }
+    ParameterSpace::Dimension dim;
+    dim.name = name;
+    dim.integer = start.is_number_integer() && step.is_number_integer();
+    for (long long k = 0;; ++k) {
+        double v = first + k * increment; // No accumulated drift
+        if (v > last + 1e-9 * increment) break;
+        v = std::round(v * 1e9) / 1e9;     // 3.9, not 3.9000000000000004
+        dim.values.push_back(dim.integer ? json(static_cast<long long>(std::llround(v))) : json(v));
+    }
+    if (dim.values.empty()) {
+        throw std::invalid_argument("Parameter '" + name + "' has an empty range");
+    }
+    dim.low = first;
+    dim.high = dim.values.back().get<double>();
+    return dim;
+}
+
+double clamp01(double u) {
+    return std::min(1.0, std::max(0.0, u));
+}
+
+size_t choice_index(double u, size_t n) {
+    return std::min(n - 1, static_cast<size_t>(clamp01(u) * n));
+}
+
+using Point = std::vector<double>;
+
+// --- Random and Latin hypercube ---------------------------------------------
+
+class RandomSearch : public SearchStrategy {
+public:
+    RandomSearch(size_t dims, uint64_t seed) : dims_(dims), rng_(seed) {}
+    std::string name() const override { return "random"; }
+
+    std::vector<Point> ask(size_t batch) override {
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        std::vector<Point> points(batch, Point(dims_));
+        for (auto& p : points) {
+            for (auto& u : p) u = uniform(rng_);
+        }
+        return points;
+    }
+    void tell(const std::vector<Point>&, const std::vector<double>&) override {}
+
+private:
+    size_t dims_;
+    std::mt19937_64 rng_;
+};
+
+// One stratified design per batch: every dimension's [0, 1] is cut into
+// `batch` strata and each stratum is used exactly once.
+std::vector<Point> latin_hypercube(size_t dims, size_t batch, std::mt19937_64& rng) {
+    std::uniform_real_distribution<double> uniform(0.0, 1.0);
+    std::vector<Point> points(batch, Point(dims));
+    std::vector<size_t> strata(batch);
+    for (size_t d = 0; d < dims; ++d) {
+        std::iota(strata.begin(), strata.end(), 0);
+        std::shuffle(strata.begin(), strata.end(), rng);
+        for (size_t i = 0; i < batch; ++i) {
+            points[i][d] = (strata[i] + uniform(rng)) / batch;
+        }
+    }
+    return points;
+}
+
+class LatinHypercubeSearch : public SearchStrategy {
+public:
+    LatinHypercubeSearch(size_t dims, uint64_t seed) : dims_(dims), rng_(seed) {}
+    std::string name() const override { return "lhs"; }
+    std::vector<Point> ask(size_t batch) override { return latin_hypercube(dims_, batch, rng_); }
+    void tell(const std::vector<Point>&, const std::vector<double>&) override {}
+
+private:
+    size_t dims_;
+    std::mt19937_64 rng_;
+};
+
+// --- Gaussian-process Bayesian optimisation ---------------------------------
+
+// Lower Cholesky factor of a symmetric positive definite matrix (row-major).
+bool cholesky(std::vector<double>& a, size_t n) {
+    for (size_t j = 0; j < n; ++j) {
+        double diag = a[j * n + j];
+        for (size_t k = 0; k < j; ++k) diag -= a[j * n + k] * a[j * n + k];
+        if (diag <= 0.0) return false;
+        diag = std::sqrt(diag);
+        a[j * n + j] = diag;
+        for (size_t i = j + 1; i < n; ++i) {
+            double v = a[i * n + j];
+            for (size_t k = 0; k < j; ++k) v -= a[i * n + k] * a[j * n + k];
+            a[i * n + j] = v / diag;
+        }
+        for (size_t k = j + 1; k < n; ++k) a[j * n + k] = 0.0;
+    }
+    return true;
+}
+
+void forward_solve(const std::vector<double>& l, size_t n, std::vector<double>& x) {
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t k = 0; k < i; ++k) x[i] -= l[i * n + k] * x[k];
+        x[i] /= l[i * n + i];
+    }
+}
+
+void backward_solve(const std::vector<double>& l, size_t n, std::vector<double>& x) {
+    for (size_t i = n; i-- > 0;) {
+        for (size_t k = i + 1; k < n; ++k) x[i] -= l[k * n + i] * x[k];
+        x[i] /= l[i * n + i];
+    }
+}
+
+class GaussianProcess {
+public:
+    void fit(const std::vector<Point>& x, const std::vector<double>& y, double lengthscale) {
+        x_ = x;
+        lengthscale_ = lengthscale;
+        n_ = x.size();
+        mean_ = std::accumulate(y.begin(), y.end(), 0.0) / n_;
+        double var = 0.0;
+        for (double v : y) var += (v - mean_) * (v - mean_);
+        scale_ = n_ > 1 ? std::sqrt(var / (n_ - 1)) : 1.0;
+        if (scale_ < 1e-12) scale_ = 1.0;
+
+        chol_.assign(n_ * n_, 0.0);
+        for (size_t i = 0; i < n_; ++i) {
+            for (size_t j = 0; j <= i; ++j) {
+                chol_[i * n_ + j] = chol_[j * n_ + i] = kernel(x_[i], x_[j]);
+            }
+            chol_[i * n_ + i] += NOISE;
+        }
+        if (!cholesky(chol_, n_)) {
+            // Add jitter until it factors; duplicate points are the usual cause.
+            for (size_t i = 0; i < n_; ++i) chol_[i * n_ + i] += 1e-3;
+            cholesky(chol_, n_);
+        }
+        alpha_.resize(n_);
+        for (size_t i = 0; i < n_; ++i) alpha_[i] = (y[i] - mean_) / scale_;
+        forward_solve(chol_, n_, alpha_);
+        log_det_ = 0.0;
+        for (size_t i = 0; i < n_; ++i) log_det_ += 2.0 * std::log(chol_[i * n_ + i]);
+        fit_ = 0.0;
+        for (double a : alpha_) fit_ += a * a;
+        backward_solve(chol_, n_, alpha_);
+    }
+
+    // Log marginal likelihood of the normalised targets (up to a constant).
+    double logLikelihood() const { return -0.5 * fit_ - 0.5 * log_det_; }
+
+    void predict(const Point& p, double& mu, double& sigma) const {
+        std::vector<double> k(n_);
+        for (size_t i = 0; i < n_; ++i) k[i] = kernel(p, x_[i]);
+        double m = 0.0;
+        for (size_t i = 0; i < n_; ++i) m += k[i] * alpha_[i];
+        forward_solve(chol_, n_, k);
+        double var = 1.0;
+        for (double v : k) var -= v * v;
+        mu = mean_ + scale_ * m;
+        sigma = scale_ * std::sqrt(std::max(var, 1e-12));
+    }
+
+private:
+    static constexpr double NOISE = 1e-4;
+
+    // Matern 5/2
+    double kernel(const Point& a, const Point& b) const {
+        double d2 = 0.0;
+        for (size_t i = 0; i < a.size(); ++i) d2 += (a[i] - b[i]) * (a[i] - b[i]);
+        const double r = std::sqrt(5.0 * d2) / lengthscale_;
+        return (1.0 + r + r * r / 3.0) * std::exp(-r);
+    }
+
+    std::vector<Point> x_;
+    std::vector<double> chol_;
+    std::vector<double> alpha_;
+    size_t n_ = 0;
+    double lengthscale_ = 0.3;
+    double mean_ = 0.0;
+    double scale_ = 1.0;
+    double log_det_ = 0.0;
+    double fit_ = 0.0;
+};
+
+class BayesianSearch : public SearchStrategy {
+public:
+    BayesianSearch(size_t dims, uint64_t seed, const json& options)
+        : dims_(dims), rng_(seed),
+          initial_points_(options.value("initial_points", std::max<size_t>(5, 2 * dims + 1))),
+          candidates_(options.value("candidates", 2000)),
+          xi_(options.value("xi", 0.01)) {}
+
+    std::string name() const override { return "bayesian"; }
+
+    std::vector<Point> ask(size_t batch) override {
+        if (x_.size() < initial_points_) {
+            return latin_hypercube(dims_, std::min(batch, initial_points_ - x_.size()), rng_);
+        }
+
+        // Failed runs count as the worst score seen so the model steers away.
+        std::vector<Point> x = x_;
+        std::vector<double> y = y_;
+        const double worst = *std::min_element(finite_.begin(), finite_.end());
+        for (auto& v : y) if (std::isnan(v)) v = worst;
+
+        GaussianProcess gp;
+        const double lengthscale = select_lengthscale(x, y);
+        gp.fit(x, y, lengthscale);
+        const double best = *std::max_element(finite_.begin(), finite_.end());
+
+        // Batch by "kriging believer": pretend each pick scored its predicted
+        // mean and refit before choosing the next one.
+        std::vector<Point> picks;
+        for (size_t b = 0; b < batch; ++b) {
+            Point choice;
+            double choice_ei = -1.0;
+            double choice_mu = 0.0;
+            for (const auto& p : candidate_points(x, y)) {
+                double mu, sigma;
+                gp.predict(p, mu, sigma);
+                const double ei = expected_improvement(mu, sigma, best);
+                if (ei > choice_ei) {
+                    choice_ei = ei;
+                    choice = p;
+                    choice_mu = mu;
+                }
+            }
+            if (choice.empty() || !std::isfinite(choice_mu)) {
+                // No finite expected improvement: the fit is degenerate (e.g.
+                // infinite scores), so explore instead of trusting it.
+                for (auto& p : latin_hypercube(dims_, batch - b, rng_)) {
+                    picks.push_back(std::move(p));
+                }
+                break;
+            }
+            picks.push_back(choice);
+            x.push_back(choice);
+            y.push_back(choice_mu);
+            gp.fit(x, y, lengthscale);
+        }
+        return picks;
+    }
+
+    void tell(const std::vector<Point>& points, const std::vector<double>& scores) override {
+        for (size_t i = 0; i < points.size(); ++i) {
+            x_.push_back(points[i]);
+            y_.push_back(scores[i]);
+            if (!std::isnan(scores[i])) finite_.push_back(scores[i]);
+        }
+        if (finite_.empty()) {
+            // Nothing to model yet: keep sampling the initial design.
+            x_.clear();
+            y_.clear();
+        }
+    }
+
+private:
+    double expected_improvement(double mu, double sigma, double best) const {
+        const double improvement = mu - best - xi_;
+        const double z = improvement / sigma;
+        const double cdf = 0.5 * std::erfc(-z / std::sqrt(2.0));
+        const double pdf = std::exp(-0.5 * z * z) / std::sqrt(2.0 * kPi);
+        return improvement * cdf + sigma * pdf;
+    }
+
+    double select_lengthscale(const std::vector<Point>& x, const std::vector<double>& y) const {
+        double best_ll = -std::numeric_limits<double>::infinity();
+        double best_l = 0.3;
+        for (double l : {0.05, 0.1, 0.2, 0.35, 0.6, 1.0}) {
+            GaussianProcess gp;
+            gp.fit(x, y, l * std::sqrt(static_cast<double>(dims_)));
+            if (gp.logLikelihood() > best_ll) {
+                best_ll = gp.logLikelihood();
+                best_l = l * std::sqrt(static_cast<double>(dims_));
+            }
+        }
+        return best_l;
+    }
+
+    // Uniform samples plus local perturbations of the best points so far.
+    std::vector<Point> candidate_points(const std::vector<Point>& x, const std::vector<double>& y) {
+        std::uniform_real_distribution<double> uniform(0.0, 1.0);
+        std::normal_distribution<double> local(0.0, 0.05);
+        std::vector<Point> points(candidates_, Point(dims_));
+        for (auto& p : points) {
+            for (auto& u : p) u = uniform(rng_);
+        }
+        std::vector<size_t> order(x.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return y[a] > y[b]; });
+        for (size_t r = 0; r < std::min<size_t>(5, order.size()); ++r) {
+            for (int k = 0; k < 100; ++k) {
+                Point p = x[order[r]];
+                for (auto& u : p) u = clamp01(u + local(rng_));
+                points.push_back(std::move(p));
+            }
+        }
+        return points;
+    }
+
+    size_t dims_;
+    std::mt19937_64 rng_;
+    size_t initial_points_;
+    size_t candidates_;
+    double xi_;
+    std::vector<Point> x_;
+    std::vector<double> y_;
+    std::vector<double> finite_;
+};
+
+// --- CMA-ES -----------------------------------------------------------------
+
+// Eigen-decomposition of a symmetric matrix by cyclic Jacobi rotations:
+// a = v * diag(w) * v^T, columns of v are the eigenvectors.
+void symmetric_eigen(std::vector<double> a, size_t n, std::vector<double>& w, std::vector<double>& v) {
+    v.assign(n * n, 0.0);
+    for (size_t i = 0; i < n; ++i) v[i * n + i] = 1.0;
+    for (int sweep = 0; sweep < 50; ++sweep) {
+        double off = 0.0;
+        for (size_t p = 0; p < n; ++p)
+            for (size_t q = p + 1; q < n; ++q) off += a[p * n + q] * a[p * n + q];
+        if (off < 1e-20) break;
+        for (size_t p = 0; p < n; ++p) {
+            for (size_t q = p + 1; q < n; ++q) {
+                const double apq = a[p * n + q];
+                if (std::abs(apq) < 1e-30) continue;
+                const double theta = (a[q * n + q] - a[p * n + p]) / (2.0 * apq);
+                const double t = (theta >= 0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+                const double c = 1.0 / std::sqrt(t * t + 1.0);
+                const double s = t * c;
+                for (size_t k = 0; k < n; ++k) {
+                    const double akp = a[k * n + p], akq = a[k * n + q];
+                    a[k * n + p] = c * akp - s * akq;
+                    a[k * n + q] = s * akp + c * akq;
+                }
+                for (size_t k = 0; k < n; ++k) {
+                    const double apk = a[p * n + k], aqk = a[q * n + k];
+                    a[p * n + k] = c * apk - s * aqk;
+                    a[q * n + k] = s * apk + c * aqk;
+                }
+                for (size_t k = 0; k < n; ++k) {
+                    const double vkp = v[k * n + p], vkq = v[k * n + q];
+                    v[k * n + p] = c * vkp - s * vkq;
+                    v[k * n + q] = s * vkp + c * vkq;
+                }
+            }
+        }
+    }
+    w.resize(n);
+    for (size_t i = 0; i < n; ++i) w[i] = a[i * n + i];
+}
+
+// (mu/mu_w, lambda)-CMA-ES on the unit cube, following Hansen's tutorial.
+// Samples outside the cube are repaired by clipping.
+class CmaesSearch : public SearchStrategy {
+public:
+    CmaesSearch(size_t dims, uint64_t seed, const json& options)
+        : n_(dims), rng_(seed) {
+        const size_t default_lambda = 4 + static_cast<size_t>(3.0 * std::log(static_cast<double>(n_)));
+        lambda_ = std::max<size_t>(4, options.value("population", default_lambda));
+        mu_ = lambda_ / 2;
+        weights_.resize(mu_);
+        for (size_t i = 0; i < mu_; ++i) weights_[i] = std::log(mu_ + 0.5) - std::log(i + 1.0);
+        const double sum = std::accumulate(weights_.begin(), weights_.end(), 0.0);
+        double sum_sq = 0.0;
+        for (auto& w : weights_) {
+            w /= sum;
+            sum_sq += w * w;
+        }
+        mueff_ = 1.0 / sum_sq;
+
+        const double n = static_cast<double>(n_);
+        cc_ = (4.0 + mueff_ / n) / (n + 4.0 + 2.0 * mueff_ / n);
+        cs_ = (mueff_ + 2.0) / (n + mueff_ + 5.0);
+        c1_ = 2.0 / ((n + 1.3) * (n + 1.3) + mueff_);
+        cmu_ = std::min(1.0 - c1_, 2.0 * (mueff_ - 2.0 + 1.0 / mueff_) / ((n + 2.0) * (n + 2.0) + mueff_));
+        damps_ = 1.0 + 2.0 * std::max(0.0, std::sqrt((mueff_ - 1.0) / (n + 1.0)) - 1.0) + cs_;
+        chi_n_ = std::sqrt(n) * (1.0 - 1.0 / (4.0 * n) + 1.0 / (21.0 * n * n));
+
+        mean_.assign(n_, 0.5);
+        sigma_ = options.value("sigma", 0.3);
+        pc_.assign(n_, 0.0);
+        ps_.assign(n_, 0.0);
+        c_.assign(n_ * n_, 0.0);
+        b_.assign(n_ * n_, 0.0);
+        for (size_t i = 0; i < n_; ++i) c_[i * n_ + i] = b_[i * n_ + i] = 1.0;
+        d_.assign(n_, 1.0);
+    }
+
+    std::string name() const override { return "cmaes"; }
+
+    std::vector<Point> ask(size_t) override {
+        std::normal_distribution<double> normal(0.0, 1.0);
+        std::vector<Point> population(lambda_, Point(n_));
+        for (auto& x : population) {
+            Point z(n_);
+            for (auto& v : z) v = normal(rng_);
+            for (size_t i = 0; i < n_; ++i) {
+                double y = 0.0;
+                for (size_t j = 0; j < n_; ++j) y += b_[i * n_ + j] * d_[j] * z[j];
+                x[i] = clamp01(mean_[i] + sigma_ * y);
+            }
+        }
+        return population;
+    }
+
+    void tell(const std::vector<Point>& points, const std::vector<double>& scores) override {
+        if (points.size() < mu_) return;
+        std::vector<size_t> order(points.size());
+        std::iota(order.begin(), order.end(), 0);
+        auto key = [&](size_t i) { return std::isnan(scores[i]) ? -std::numeric_limits<double>::infinity() : scores[i]; };
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return key(a) > key(b); });
+
+        // Steps of the selected points, in units of sigma
+        std::vector<Point> steps(mu_, Point(n_));
+        Point step_w(n_, 0.0);
+        for (size_t k = 0; k < mu_; ++k) {
+            for (size_t i = 0; i < n_; ++i) {
+                steps[k][i] = (points[order[k]][i] - mean_[i]) / sigma_;
+                step_w[i] += weights_[k] * steps[k][i];
+            }
+        }
+        for (size_t i = 0; i < n_; ++i) mean_[i] += sigma_ * step_w[i];
+
+        // C^{-1/2} * step_w = B * D^{-1} * B^T * step_w
+        Point bt(n_, 0.0), c_inv_sqrt_step(n_, 0.0);
+        for (size_t j = 0; j < n_; ++j)
+            for (size_t i = 0; i < n_; ++i) bt[j] += b_[i * n_ + j] * step_w[i];
+        for (size_t i = 0; i < n_; ++i)
+            for (size_t j = 0; j < n_; ++j) c_inv_sqrt_step[i] += b_[i * n_ + j] * bt[j] / d_[j];
+
+        ++generation_;
+        double ps_norm = 0.0;
+        for (size_t i = 0; i < n_; ++i) {
+            ps_[i] = (1.0 - cs_) * ps_[i] + std::sqrt(cs_ * (2.0 - cs_) * mueff_) * c_inv_sqrt_step[i];
+            ps_norm += ps_[i] * ps_[i];
+        }
+        ps_norm = std::sqrt(ps_norm);
+        const bool hsig = ps_norm / std::sqrt(1.0 - std::pow(1.0 - cs_, 2.0 * generation_)) / chi_n_
+                          < 1.4 + 2.0 / (n_ + 1.0);
+        for (size_t i = 0; i < n_; ++i) {
+            pc_[i] = (1.0 - cc_) * pc_[i] + (hsig ? std::sqrt(cc_ * (2.0 - cc_) * mueff_) * step_w[i] : 0.0);
+        }
+
+        for (size_t i = 0; i < n_; ++i) {
+            for (size_t j = 0; j <= i; ++j) {
+                double rank_mu = 0.0;
+                for (size_t k = 0; k < mu_; ++k) rank_mu += weights_[k] * steps[k][i] * steps[k][j];
+                double v = (1.0 - c1_ - cmu_) * c_[i * n_ + j]
+                         + c1_ * (pc_[i] * pc_[j] + (hsig ? 0.0 : cc_ * (2.0 - cc_) * c_[i * n_ + j]))
+                         + cmu_ * rank_mu;
+                c_[i * n_ + j] = c_[j * n_ + i] = v;
+            }
+        }
+
+        sigma_ *= std::exp((cs_ / damps_) * (ps_norm / chi_n_ - 1.0));
+        sigma_ = std::min(1.0, std::max(1e-8, sigma_));
+
+        std::vector<double> eigenvalues;
+        symmetric_eigen(c_, n_, eigenvalues, b_);
+        for (size_t i = 0; i < n_; ++i) d_[i] = std::sqrt(std::max(eigenvalues[i], 1e-20));
+    }
+
+private:
+    size_t n_;
+    std::mt19937_64 rng_;
+    size_t lambda_;
+    size_t mu_;
+    std::vector<double> weights_;
+    double mueff_, cc_, cs_, c1_, cmu_, damps_, chi_n_;
+    Point mean_;
+    double sigma_;
+    Point pc_, ps_;
+    std::vector<double> c_, b_; // Covariance and its eigenvectors (row-major)
+    Point d_;                   // Square roots of the eigenvalues
+    long long generation_ = 0;
+};
+
+} // namespace
+
+ParameterSpace ParameterSpace::fromConfig(const json& param_ranges) {
+    if (!param_ranges.is_object()) {
+        throw std::invalid_argument("param_ranges must be an object");
+    }
+    ParameterSpace space;
+
+    if (param_ranges.contains("p1_name")) {
+        for (int k = 1;; ++k) {
+            const std::string p = "p" + std::to_string(k);
+            if (!param_ranges.contains(p + "_name")) break;
+            space.dimensions_.push_back(stepped_range(param_ranges.at(p + "_name").get<std::string>(),
+                                                      param_ranges.at(p + "_start"),
+                                                      param_ranges.at(p + "_end"),
+                                                      param_ranges.at(p + "_step")));
+        }
+        return space;
+    }
+
+    for (auto it = param_ranges.begin(); it != param_ranges.end(); ++it) {
+        const std::string& key = it.key();
+        const json& value = it.value();
+
+        if (value.is_array()) {
+            if (value.empty()) {
+                throw std::invalid_argument("Parameter '" + key + "' has no values");
+            }
+            Dimension dim;
+            dim.name = key;
+            dim.values.assign(value.begin(), value.end());
+            space.dimensions_.push_back(std::move(dim));
+        } else if (value.is_object()) {
+            if (value.contains("step")) {
+                space.dimensions_.push_back(stepped_range(key, value.at("min"), value.at("max"), value.at("step")));
+            } else {
+                Dimension dim;
+                dim.name = key;
+                dim.low = value.at("min").get<double>();
+                dim.high = value.at("max").get<double>();
+                dim.integer = value.value("integer", false);
+                if (dim.high < dim.low) {
+                    throw std::invalid_argument("Parameter '" + key + "' has max < min");
+                }
+                space.dimensions_.push_back(std::move(dim));
+            }
+        } else if (ends_with(key, "_start")) {
+            const std::string name = key.substr(0, key.size() - 6);
+            if (param_ranges.contains(name + "_step")) {
+                space.dimensions_.push_back(stepped_range(name, value, param_ranges.at(name + "_end"), param_ranges.at(name + "_step")));
+            } else {
+                Dimension dim;
+                dim.name = name;
+                dim.low = value.get<double>();
+                dim.high = param_ranges.at(name + "_end").get<double>();
+                dim.integer = value.is_number_integer() && param_ranges.at(name + "_end").is_number_integer();
+                space.dimensions_.push_back(std::move(dim));
+            }
+        } else if ((ends_with(key, "_end") && param_ranges.contains(key.substr(0, key.size() - 4) + "_start")) ||
+                   (ends_with(key, "_step") && param_ranges.contains(key.substr(0, key.size() - 5) + "_start"))) {
+            continue; // Part of a _start/_end/_step range
+        } else {
+            Dimension dim; // A fixed value
+            dim.name = key;
+            dim.values.push_back(value);
+            space.dimensions_.push_back(std::move(dim));
+        }
+    }
+    return space;
+}
+
+json ParameterSpace::decode(const std::vector<double>& point) const {
+    json params = json::object();
+    for (size_t d = 0; d < dimensions_.size(); ++d) {
+        const Dimension& dim = dimensions_[d];
+        if (!dim.values.empty()) {
+            params[dim.name] = dim.values[choice_index(point[d], dim.values.size())];
+        } else {
+            const double v = dim.low + clamp01(point[d]) * (dim.high - dim.low);
+            params[dim.name] = dim.integer ? json(static_cast<long long>(std::llround(v))) : json(v);
+        }
+    }
+    return params;
+}
+
+std::vector<double> ParameterSpace::snap(const std::vector<double>& point) const {
+    std::vector<double> snapped(point.size());
+    for (size_t d = 0; d < dimensions_.size(); ++d) {
+        const Dimension& dim = dimensions_[d];
+        if (!dim.values.empty()) {
+            const size_t n = dim.values.size();
+            snapped[d] = (choice_index(point[d], n) + 0.5) / n;
+        } else if (dim.integer && dim.high > dim.low) {
+            const double v = std::round(dim.low + clamp01(point[d]) * (dim.high - dim.low));
+            snapped[d] = (v - dim.low) / (dim.high - dim.low);
+        } else {
+            snapped[d] = clamp01(point[d]);
+        }
+    }
+    return snapped;
+}
+
+size_t ParameterSpace::gridSize() const {
+    size_t total = 1;
+    for (const auto& dim : dimensions_) {
+        if (dim.values.empty()) return 0;
+        total *= dim.values.size();
+    }
+    return total;
+}
+
+std::vector<json> ParameterSpace::grid() const {
+    std::vector<json> combinations;
+    const size_t total = gridSize();
+    if (total == 0 || dimensions_.empty()) {
+        return combinations;
+    }
+    combinations.reserve(total);
+    std::vector<size_t> index(dimensions_.size(), 0);
+    for (size_t n = 0; n < total; ++n) {
+        json params = json::object();
+        for (size_t d = 0; d < dimensions_.size(); ++d) {
+            params[dimensions_[d].name] = dimensions_[d].values[index[d]];
+        }
+        combinations.push_back(std::move(params));
+        // Advance like an odometer, last parameter fastest
+        for (size_t d = dimensions_.size(); d-- > 0;) {
+            if (++index[d] < dimensions_[d].values.size()) break;
+            index[d] = 0;
+        }
+    }
+    return combinations;
+}
+
+std::unique_ptr<SearchStrategy> makeSearchStrategy(const std::string& name, size_t dimensions,
+                                                   uint64_t seed, const json& options) {
+    if (name == "random") return std::make_unique<RandomSearch>(dimensions, seed);
+    if (name == "lhs") return std::make_unique<LatinHypercubeSearch>(dimensions, seed);
+    if (name == "bayesian") return std::make_unique<BayesianSearch>(dimensions, seed, options);
+    if (name == "cmaes") return std::make_unique<CmaesSearch>(dimensions, seed, options);
+    throw std::invalid_argument("Unknown search strategy: " + name);
+}
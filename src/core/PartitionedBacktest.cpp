@@ -0,0 +1,140 @@
+#include "../../include/core/PartitionedBacktest.h"
+#include "../../include/core/Backtester.h"
+#include "../../include/core/ThreadPool.h"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+class DisjointSets {
+public:
+    explicit DisjointSets(size_t size) : parent_(size) {
+        std::iota(parent_.begin(), parent_.end(), 0);
+    }
+    size_t find(size_t i) {
+        while (parent_[i] != i) {
+            parent_[i] = parent_[parent_[i]]; // Path halving
+            i = parent_[i];
+        }
+        return i;
+    }
+    void join(size_t a, size_t b) {
+        a = find(a);
+        b = find(b);
+        // The lower index stays the root, so a group's root is its first symbol.
+        if (a != b) {
+            parent_[std::max(a, b)] = std::min(a, b);
+        }
+    }
+
+private:
+    std::vector<size_t> parent_;
+};
+
+// Every symbol a strategy config trades.
+std::vector<std::string> strategy_symbols(const json& strategy_config) {
+    std::vector<std::string> symbols;
+    if (strategy_config.contains("symbol") && strategy_config["symbol"].is_string()) {
+        symbols.push_back(strategy_config["symbol"].get<std::string>());
+    }
+    if (strategy_config.contains("symbols") && strategy_config["symbols"].is_array()) {
+        for (const auto& symbol : strategy_config["symbols"]) {
+            symbols.push_back(symbol.get<std::string>());
+        }
+    }
+    return symbols;
+}
+
+} // namespace
+
+std::vector<PartitionedBacktest::Partition> PartitionedBacktest::partition(const json& config) {
+    const auto symbols = config.value("symbols", std::vector<std::string>());
+    std::unordered_map<std::string, size_t> index;
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        index.emplace(symbols[i], i);
+    }
+
+    DisjointSets sets(symbols.size());
+    std::vector<std::pair<size_t, json>> strategies; // (symbol index, config)
+    for (const auto& strategy_config : config.value("strategies", json::array())) {
+        if (!strategy_config.value("active", false)) {
+            continue;
+        }
+        const auto traded = strategy_symbols(strategy_config);
+        if (traded.empty()) {
+            throw std::runtime_error("Partitioned backtest: strategy " + strategy_config.value("name", std::string()) +
+                                     " names no symbol");
+        }
+        for (const auto& symbol : traded) {
+            if (!index.count(symbol)) {
+                throw std::runtime_error("Partitioned backtest: strategy symbol " + symbol + " is not in \"symbols\"");
+            }
+            sets.join(index.at(traded.front()), index.at(symbol));
+        }
+        strategies.emplace_back(index.at(traded.front()), strategy_config);
+    }
+
+    std::vector<Partition> partitions;
+    std::unordered_map<size_t, size_t> partition_of_root;
+    for (size_t i = 0; i < symbols.size(); ++i) {
+        const size_t root = sets.find(i);
+        if (!partition_of_root.count(root)) {
+            partition_of_root[root] = partitions.size();
+            partitions.emplace_back();
+        }
+        partitions[partition_of_root[root]].symbols.push_back(symbols[i]);
+    }
+    for (const auto& [symbol, strategy_config] : strategies) {
+        partitions[partition_of_root.at(sets.find(symbol))].strategies.push_back(strategy_config);
+    }
+
+    const double capital = config.value("initial_capital", 100000.0);
+    std::vector<Partition> traded;
+    for (auto& partition : partitions) {
+        if (partition.strategies.empty()) {
+            continue;
+        }
+        partition.initial_capital = capital * partition.strategies.size() / strategies.size();
+        traded.push_back(std::move(partition));
+    }
+    return traded;
+}
+
+PartitionedBacktest::PartitionedBacktest(const json& config)
+    : config_(config), partitions_(partition(config)) {}
+
+std::shared_ptr<Portfolio> PartitionedBacktest::run() {
+    if (partitions_.empty()) {
+        throw std::runtime_error("Partitioned backtest: no active strategy to run");
+    }
+
+    const auto settings = config_.value("partitioned", json::object());
+    const int max_threads = settings.value("max_threads", 0);
+    ThreadPool pool(max_threads > 0 ? static_cast<size_t>(max_threads) : 0, true);
+
+    portfolios_.assign(partitions_.size(), nullptr);
+    std::vector<long long> events(partitions_.size(), 0);
+    pool.parallelFor(partitions_.size(), [&](size_t i) {
+        json child_config = config_;
+        child_config["run_mode"] = "BACKTEST";
+        child_config["symbols"] = partitions_[i].symbols;
+        child_config["strategies"] = partitions_[i].strategies;
+        child_config["initial_capital"] = partitions_[i].initial_capital;
+        // The partitions already keep the cores busy.
+        child_config["partitioned"]["enabled"] = false;
+        child_config["pipeline"]["enabled"] = false;
+        child_config["strategy_threads"]["enabled"] = false;
+        child_config.erase("checkpoint"); // Partitions would share the files
+
+        Backtester backtester(child_config);
+        backtester.setReportsEnabled(false);
+        backtester.run();
+        portfolios_[i] = backtester.getPortfolio();
+        events[i] = backtester.eventCount();
+    });
+
+    event_count_ = std::accumulate(events.begin(), events.end(), 0LL);
+    return Portfolio::merge(portfolios_);
+}
@@ -1,6 +1,7 @@
 #include "../../include/core/Performance.h"
+#include "../../include/core/Philox.h"
+#include "../../include/core/ThreadPool.h"
 #include <algorithm>
-#include <random> // STAGE 5: For Monte Carlo
 #include <iostream>
 #include <chrono>
 #include <iomanip> // <-- FIX: Added missing header for std::setprecision
@@ -77,36 +78,73 @@ void Performance::calculateTradeLevelStats() {
 }
 
 // STAGE 5: Monte Carlo Simulation
-void Performance::runMonteCarloSimulation(int num_simulations) const {
+// Bootstrap: every path redraws the period returns with replacement. Path i
+// uses Philox stream i, so results don't depend on the thread count.
+MonteCarloSummary Performance::runMonteCarloSimulation(int num_simulations, uint64_t seed, int max_threads) const {
+    MonteCarloSummary summary;
     std::cout << "\n--- Monte Carlo Simulation (" << num_simulations << " runs) ---\n";
-    std::vector<double> returns = calculateReturns();
-    if (returns.size() < 2) {
+    // Compounding is a sum in log space: cumulative sums of log returns are
+    // the log of the cumulative products of growth factors. A loss of 100%
+    // or more has no log, so it counts as a near-total loss; returns off a
+    // zero equity (infinite or NaN) are dropped.
+    constexpr double kWorstReturn = -1.0 + 1e-12;
+    std::vector<double> log_returns;
+    for (double r : calculateReturns()) {
+        if (std::isfinite(r)) {
+            log_returns.push_back(std::log1p(std::max(r, kWorstReturn)));
+        }
+    }
+    if (log_returns.size() < 2 || num_simulations <= 0) {
         std::cout << "Not enough data for Monte Carlo simulation." << std::endl;
-        return;
+        return summary;
     }
+    const uint32_t n = static_cast<uint32_t>(log_returns.size());
 
-    std::vector<double> final_returns;
-    std::default_random_engine generator(std::chrono::system_clock::now().time_since_epoch().count());
-    
-    for (int i = 0; i < num_simulations; ++i) {
-        std::shuffle(returns.begin(), returns.end(), generator);
-        double simulated_equity = initial_capital_;
-        for (double r : returns) {
-            simulated_equity *= (1.0 + r);
+    const size_t paths = static_cast<size_t>(num_simulations);
+    std::vector<double> final_returns(paths);
+    std::vector<double> max_drawdowns(paths);
+    const size_t chunk = 256;
+    ThreadPool pool(std::min(ThreadPool::resolveThreadCount(max_threads), (paths + chunk - 1) / chunk));
+    pool.parallelFor((paths + chunk - 1) / chunk, [&](size_t c) {
+        std::vector<double> log_equity(n);
+        for (size_t path = c * chunk; path < std::min(paths, (c + 1) * chunk); ++path) {
+            Philox4x32 rng(seed, path);
+            for (uint32_t t = 0; t < n; ++t) {
+                log_equity[t] = log_returns[rng.below(n)];
+            }
+            std::partial_sum(log_equity.begin(), log_equity.end(), log_equity.begin());
+            double peak = 0.0;
+            double drawdown = 0.0;
+            for (double v : log_equity) {
+                peak = std::max(peak, v);
+                drawdown = std::max(drawdown, peak - v);
+            }
+            final_returns[path] = std::expm1(log_equity.back());
+            max_drawdowns[path] = -std::expm1(-drawdown);
         }
-        final_returns.push_back((simulated_equity / initial_capital_) - 1.0);
-    }
+    });
 
+    summary.paths = paths;
+    summary.mean_return = calculateMean(final_returns);
     std::sort(final_returns.begin(), final_returns.end());
-    
-    double mean_sim_return = calculateMean(final_returns);
-    double p5 = final_returns[static_cast<size_t>(num_simulations * 0.05)];
-    double p95 = final_returns[static_cast<size_t>(num_simulations * 0.95)];
+    std::sort(max_drawdowns.begin(), max_drawdowns.end());
+    auto percentile = [paths](const std::vector<double>& sorted, double q) {
+        return sorted[std::min(paths - 1, static_cast<size_t>(paths * q))];
+    };
+    summary.p5_return = percentile(final_returns, 0.05);
+    summary.p50_return = percentile(final_returns, 0.50);
+    summary.p95_return = percentile(final_returns, 0.95);
+    summary.p50_max_drawdown = percentile(max_drawdowns, 0.50);
+    summary.p95_max_drawdown = percentile(max_drawdowns, 0.95);
 
     std::cout << std::fixed << std::setprecision(2);
-    std::cout << "Average Simulated Return: " << mean_sim_return * 100.0 << "%" << std::endl;
-    std::cout << "5th Percentile Return: " << p5 * 100.0 << "%" << std::endl;
-    std::cout << "95th Percentile Return: " << p95 * 100.0 << "%" << std::endl;
+    std::cout << "Average Simulated Return: " << summary.mean_return * 100.0 << "%" << std::endl;
+    std::cout << "5th Percentile Return: " << summary.p5_return * 100.0 << "%" << std::endl;
+    std::cout << "Median Return: " << summary.p50_return * 100.0 << "%" << std::endl;
+    std::cout << "95th Percentile Return: " << summary.p95_return * 100.0 << "%" << std::endl;
+    std::cout << "Median Max Drawdown: " << summary.p50_max_drawdown * 100.0 << "%" << std::endl;
+    std::cout << "95th Percentile Max Drawdown: " << summary.p95_max_drawdown * 100.0 << "%" << std::endl;
+    return summary;
 }
 
 double Performance::calculateVaR(double confidence_level) const {
@@ -5,6 +5,7 @@
 #include <fstream>
 #include <numeric>
 #include <cmath>
+#include <algorithm>
 
 Portfolio::Portfolio(
     std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> event_queue,
@@ -14,9 +15,7 @@ Portfolio::Portfolio(
     initial_capital_(initial_capital),
     data_handler_(data_handler),
     total_equity_(initial_capital),
-    current_cash_(initial_capital),
-    peak_equity_(initial_capital),
-    max_drawdown_(0.0) {}
+    current_cash_(initial_capital) {}
 
 void Portfolio::onSignal(const SignalEvent& signal) {
     // This is handled by the RiskManager now, Portfolio does not need to generate orders.
@@ -95,36 +94,50 @@ void Portfolio::onFill(const FillEvent& fill_event) {
         strategy_trade_log_[fill_event.strategy_name].push_back(trade);
     }
 
+    markPosition(fill_event.symbol);
+    // Fills are rare next to ticks: re-add the total here so that the running
+    // deltas cannot drift.
+    holdings_value_ = 0.0;
+    for (const auto& [symbol, held] : holdings_) {
+        holdings_value_ += held.market_value;
+    }
     updateTimeIndex();
 }
 
 void Portfolio::onMarket(const MarketEvent& market_event) {
+    markPosition(market_event.symbol);
     updateTimeIndex();
 }
 
-void Portfolio::updateTimeIndex() {
-    double holdings_value = 0.0;
-    for (auto& [symbol, position] : holdings_) {
-        double market_price = data_handler_->getLatestBarValue(symbol, "price");
-        if (market_price > 0) {
-            position.market_value = position.quantity * market_price;
-            holdings_value += position.market_value;
-        } else {
-            holdings_value += position.quantity * position.average_cost;
-        }
+void Portfolio::markToMarket(const Event& event) {
+    setMarketTime(marketEventTime(event));
+    if (const std::string* symbol = pricedEventSymbol(event)) {
+        markPosition(*symbol);
     }
+    updateTimeIndex();
+}
 
-    total_equity_ = current_cash_ + holdings_value;
+void Portfolio::markPosition(const std::string& symbol) {
+    auto it = holdings_.find(symbol);
+    if (it == holdings_.end() || !data_handler_) {
+        return;
+    }
+    Position& position = it->second;
+    const double market_price = data_handler_->getLatestBarValue(symbol, "price");
+    // Without a price yet, the position counts at cost.
+    const double market_value = position.quantity * (market_price > 0 ? market_price : position.average_cost);
+    holdings_value_ += market_value - position.market_value;
+    position.market_value = market_value;
+}
 
-    equity_curve_.emplace_back(std::chrono::system_clock::now().time_since_epoch().count(), total_equity_, current_market_state_);
+void Portfolio::updateTimeIndex() {
+    total_equity_ = current_cash_ + holdings_value_;
 
-    if (total_equity_ > peak_equity_) {
-        peak_equity_ = total_equity_;
-    }
-    double drawdown = (peak_equity_ - total_equity_) / peak_equity_;
-    if (drawdown > max_drawdown_) {
-        max_drawdown_ = drawdown;
+    if (equity_curve_enabled_) {
+        const long long stamp = market_time_ > 0 ? market_time_ : std::chrono::system_clock::now().time_since_epoch().count();
+        equity_curve_.record(stamp, total_equity_, current_market_state_);
     }
+    metrics_.add(total_equity_);
 }
 
 void Portfolio::generateReport() {
@@ -134,7 +147,7 @@ void Portfolio::generateReport() {
     std::cout << "Final Equity:    $" << total_equity_ << std::endl;
 
     std::vector<double> equity_values;
-    for (const auto& p : equity_curve_) {
+    for (const auto& p : equity_curve_.points()) {
         equity_values.push_back(std::get<1>(p));
     }
 
@@ -155,7 +168,8 @@ void Portfolio::generateReport() {
 void Portfolio::writeResultsToCSV(const std::string& filename) {
     std::ofstream file(filename);
     file << "timestamp,equity,vol_regime,trend_regime\n";
-    for (const auto& point : equity_curve_) {
+    const size_t export_points = equity_curve_.resolution().export_points;
+    for (const auto& point : export_points > 0 ? equity_curve_.downsample(export_points) : equity_curve_.points()) {
         file << std::get<0>(point) << "," 
              << std::get<1>(point) << ","
              << static_cast<int>(std::get<2>(point).volatility) << ","
@@ -182,8 +196,180 @@ void Portfolio::writeTradeLogToCSV(const std::string& filename) {
 
 double Portfolio::get_total_equity() const { return total_equity_; }
 
-const std::vector<std::tuple<long long, double, MarketState>>& Portfolio::getEquityCurve() const {
-    return equity_curve_;
+namespace {
+
+void put_trade(StateWriter& out, const Trade& trade) {
+    out.put(trade.symbol);
+    out.put(trade.timestamp);
+    out.put(trade.price);
+    out.put(trade.quantity);
+    out.put(trade.aggressor_side);
+    out.put(trade.direction);
+    out.put(trade.entry_price);
+    out.put(trade.exit_price);
+    out.put(trade.entry_timestamp);
+    out.put(trade.exit_timestamp);
+    out.put(trade.pnl);
+    out.put(trade.market_state_at_entry);
+}
+
+Trade get_trade(StateReader& in) {
+    Trade trade;
+    trade.symbol = in.getString();
+    trade.timestamp = in.get<long long>();
+    trade.price = in.get<double>();
+    trade.quantity = in.get<double>();
+    trade.aggressor_side = in.getString();
+    trade.direction = in.get<OrderDirection>();
+    trade.entry_price = in.get<double>();
+    trade.exit_price = in.get<double>();
+    trade.entry_timestamp = in.get<long long>();
+    trade.exit_timestamp = in.get<long long>();
+    trade.pnl = in.get<double>();
+    trade.market_state_at_entry = in.getMarketState();
+    return trade;
+}
+
+void put_trades(StateWriter& out, const std::vector<Trade>& trades) {
+    out.put<uint64_t>(trades.size());
+    for (const auto& trade : trades) {
+        put_trade(out, trade);
+    }
+}
+
+std::vector<Trade> get_trades(StateReader& in) {
+    std::vector<Trade> trades(in.getSize());
+    for (auto& trade : trades) {
+        trade = get_trade(in);
+    }
+    return trades;
+}
+
+} // namespace
+
+void Portfolio::saveState(StateWriter& out) const {
+    out.put(initial_capital_);
+    out.put(current_cash_);
+    out.put(total_equity_);
+    out.put(current_market_state_);
+    out.put(market_time_);
+
+    out.put<uint64_t>(holdings_.size());
+    for (const auto& [symbol, position] : holdings_) {
+        out.put(symbol);
+        out.put(position.quantity);
+        out.put(position.average_cost);
+        out.put(position.market_value);
+        out.put(position.direction);
+    }
+
+    // Already delta-encoded; the curve goes in as it is held.
+    equity_curve_.saveState(out);
+    metrics_.saveState(out);
+
+    put_trades(out, trade_log_);
+    out.put<uint64_t>(strategy_trade_log_.size());
+    for (const auto& [strategy, trades] : strategy_trade_log_) {
+        out.put(strategy);
+        put_trades(out, trades);
+    }
+}
+
+void Portfolio::loadState(StateReader& in) {
+    if (in.get<double>() != initial_capital_) {
+        throw std::runtime_error("Checkpoint: portfolio was saved with a different initial capital");
+    }
+    current_cash_ = in.get<double>();
+    total_equity_ = in.get<double>();
+    current_market_state_ = in.getMarketState();
+    market_time_ = in.get<long long>();
+
+    holdings_.clear();
+    holdings_value_ = 0.0;
+    for (size_t i = in.getSize(); i > 0; --i) {
+        Position position;
+        position.symbol = in.getString();
+        position.quantity = in.get<double>();
+        position.average_cost = in.get<double>();
+        position.market_value = in.get<double>();
+        position.direction = in.get<OrderDirection>();
+        holdings_[position.symbol] = position;
+        holdings_value_ += position.market_value;
+    }
+
+    equity_curve_.loadState(in);
+    metrics_.loadState(in);
+
+    trade_log_ = get_trades(in);
+    strategy_trade_log_.clear();
+    for (size_t i = in.getSize(); i > 0; --i) {
+        std::string strategy = in.getString();
+        strategy_trade_log_[strategy] = get_trades(in);
+    }
+}
+
+std::shared_ptr<Portfolio> Portfolio::merge(const std::vector<std::shared_ptr<Portfolio>>& parts) {
+    double initial_capital = 0.0;
+    for (const auto& part : parts) {
+        initial_capital += part->initial_capital_;
+    }
+    auto merged = std::make_shared<Portfolio>(nullptr, initial_capital, nullptr);
+    merged->current_cash_ = 0.0;
+    merged->total_equity_ = 0.0;
+
+    // (time, partition, index) of every equity point, in merge order
+    std::vector<std::vector<EquityPoint>> curves;
+    std::vector<std::tuple<long long, size_t, size_t>> points;
+    for (size_t p = 0; p < parts.size(); ++p) {
+        const auto& part = *parts[p];
+        curves.push_back(part.equity_curve_.points());
+        for (size_t i = 0; i < curves[p].size(); ++i) {
+            points.emplace_back(std::get<0>(curves[p][i]), p, i);
+        }
+        merged->current_cash_ += part.current_cash_;
+        merged->total_equity_ += part.total_equity_;
+        for (const auto& [symbol, position] : part.holdings_) {
+            merged->holdings_[symbol] = position;
+        }
+        merged->holdings_value_ += part.holdings_value_;
+        for (const auto& [strategy, trades] : part.strategy_trade_log_) {
+            auto& log = merged->strategy_trade_log_[strategy];
+            log.insert(log.end(), trades.begin(), trades.end());
+        }
+        merged->trade_log_.insert(merged->trade_log_.end(), part.trade_log_.begin(), part.trade_log_.end());
+    }
+    std::sort(points.begin(), points.end());
+
+    std::vector<double> latest;
+    double equity = 0.0;
+    for (const auto& part : parts) {
+        latest.push_back(part->initial_capital_);
+        equity += part->initial_capital_;
+    }
+    if (!parts.empty()) {
+        merged->equity_curve_.setResolution(parts.front()->equity_curve_.resolution());
+    }
+    for (const auto& [time, p, i] : points) {
+        const auto& point = curves[p][i];
+        equity += std::get<1>(point) - latest[p];
+        latest[p] = std::get<1>(point);
+        merged->equity_curve_.record(time, equity, std::get<2>(point));
+        merged->metrics_.add(equity);
+    }
+
+    auto by_entry_time = [](const Trade& a, const Trade& b) { return a.entry_timestamp < b.entry_timestamp; };
+    std::stable_sort(merged->trade_log_.begin(), merged->trade_log_.end(), by_entry_time);
+    for (auto& [strategy, trades] : merged->strategy_trade_log_) {
+        std::stable_sort(trades.begin(), trades.end(), by_entry_time);
+    }
+    if (!points.empty()) {
+        merged->market_time_ = std::get<0>(points.back());
+    }
+    return merged;
+}
+
+std::vector<EquityPoint> Portfolio::getEquityCurve() const {
+    return equity_curve_.points();
 }
 
 std::string Portfolio::getPositionDirection(const std::string& symbol) const {
@@ -214,7 +400,7 @@ std::map<std::string, Position> Portfolio::getCurrentPositions() const {
 
 Performance Portfolio::getRealTimePerformance() const {
     std::vector<double> equity_values;
-    for (const auto& p : equity_curve_) {
+    for (const auto& p : equity_curve_.points()) {
         equity_values.push_back(std::get<1>(p));
     }
     return Performance(equity_values, initial_capital_, trade_log_);
@@ -230,24 +416,8 @@ void Portfolio::generateTradeLevelReport() const {
 }
 
 double Portfolio::get_max_drawdown() const {
-    if (equity_curve_.empty()) {
-        return 0.0;
-    }
-    
-    double max_drawdown = 0.0;
-    double peak = std::get<1>(equity_curve_[0]);
-    
-    for (const auto& point : equity_curve_) {
-        double equity = std::get<1>(point);
-        if (equity > peak) {
-            peak = equity;
-        } else {
-            double drawdown = (peak - equity) / peak;
-            max_drawdown = std::max(max_drawdown, drawdown);
-        }
-    }
-    
-    return max_drawdown;
+    // Same scan as over the equity curve, kept as the points come in.
+    return metrics_.maxDrawdown();
 }
 
 std::vector<Bar> Portfolio::get_latest_bars(const std::string& symbol, int n) const {
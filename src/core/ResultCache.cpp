@@ -0,0 +1,249 @@
+#include "../../include/core/ResultCache.h"
+#include "../../include/core/AsyncLogger.h"
+#include "../../include/core/Backtester.h"
+#include "../../include/core/EngineLane.h"
+#include "../../include/core/Portfolio.h"
+#include "../../include/data/HFTDataHandler.h"
+#include <openssl/evp.h>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+
+static const LogComponent kLog("ResultCache");
+
+namespace {
+
+// Settings that change how a run executes but not what it computes.
+const char* const kExecutionKeys[] = {
+    "run_mode", "headless", "pipeline", "strategy_threads", "partitioned", "checkpoint", "logging",
+    "analytics", "result_cache", "optimization", "walk_forward", "monte_carlo", "distributed",
+    "websocket", "live_port", "live_target"};
+const char* const kExecutionDataKeys[] = {"dataset_cache_mb", "shared_dataset_dir"};
+
+const std::string kKeyPrefix = "{\"key\":\"";
+constexpr size_t kKeyLength = 64; // Hex SHA-256
+const std::string kEquityField = ",\"equity\":";
+
+std::string sha256_hex(const std::string& data) {
+    unsigned char digest[EVP_MAX_MD_SIZE];
+    unsigned int length = 0;
+    if (EVP_Digest(data.data(), data.size(), digest, &length, EVP_sha256(), nullptr) != 1) {
+        throw std::runtime_error("ResultCache: SHA-256 failed");
+    }
+    static const char hex[] = "0123456789abcdef";
+    std::string out;
+    for (unsigned int i = 0; i < length; ++i) {
+        out += hex[digest[i] >> 4];
+        out += hex[digest[i] & 0xf];
+    }
+    return out;
+}
+
+// Path, size and modification time of a data file; null if it is missing.
+json file_fingerprint(const std::string& path) {
+    std::error_code ec;
+    const auto mtime = std::filesystem::last_write_time(path, ec);
+    const auto size = ec ? 0 : std::filesystem::file_size(path, ec);
+    if (ec) {
+        return nullptr;
+    }
+    return {{"path", std::filesystem::absolute(path, ec).lexically_normal().string()},
+            {"size", size},
+            {"mtime", static_cast<long long>(mtime.time_since_epoch().count())}};
+}
+
+// The files a historical run reads (see Backtester::createHistoricalDataHandler).
+json dataset_fingerprint(const json& run_config) {
+    const json data = run_config.value("data", json::object());
+    json files = json::array();
+    const std::string journal_path = data.value("journal_path", "");
+    if (!journal_path.empty()) {
+        files.push_back(file_fingerprint(journal_path));
+        return files;
+    }
+    const std::string dir = data.value("historical_data_fallback_dir", "");
+    if (!dir.empty()) {
+        for (const auto& symbol : run_config.value("symbols", json::array())) {
+            files.push_back(file_fingerprint(HFTDataHandler::tradeFilePath(dir, symbol.get<std::string>())));
+        }
+    }
+    return files;
+}
+
+// NaN metrics are written as null.
+double number(const json& object, const char* key) {
+    return object.contains(key) && object[key].is_number() ? object[key].get<double>() : std::nan("");
+}
+
+} // namespace
+
+ResultCache* ResultCache::forConfig(const json& config) {
+    const json block = config.value("result_cache", json::object());
+    if (!block.value("enabled", false)) {
+        return nullptr;
+    }
+    const std::string path = block.value("path", "result_cache.jsonl");
+    const bool store_equity = block.value("store_equity", false);
+    // Keyed on store_equity too, so a run that wants equity curves isn't
+    // handed an instance that drops them. Instances on one path share the
+    // file as separate processes would.
+    static std::mutex caches_mutex;
+    static std::map<std::pair<std::string, bool>, std::unique_ptr<ResultCache>> caches;
+    std::lock_guard<std::mutex> lock(caches_mutex);
+    auto& cache = caches[{path, store_equity}];
+    if (!cache) {
+        cache = std::make_unique<ResultCache>(path, store_equity);
+    }
+    return cache.get();
+}
+
+ResultCache::ResultCache(const std::string& path, bool store_equity) : path_(path), store_equity_(store_equity) {
+    const auto parent = std::filesystem::path(path_).parent_path();
+    if (!parent.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(parent, ec);
+    }
+}
+
+std::string ResultCache::key(const json& run_config) {
+    json identity = run_config;
+    for (const char* name : kExecutionKeys) {
+        identity.erase(name);
+    }
+    if (identity.contains("data") && identity["data"].is_object()) {
+        for (const char* name : kExecutionDataKeys) {
+            identity["data"].erase(name);
+        }
+    }
+    // nlohmann::json keeps object keys sorted, so the dump is canonical.
+    return sha256_hex(json{{"config", identity}, {"dataset", dataset_fingerprint(run_config)}}.dump());
+}
+
+CachedRun ResultCache::capture(const Backtester& backtester) {
+    CachedRun run;
+    run.metrics = backtester.runMetrics();
+    run.events = backtester.eventCount();
+    for (const auto& point : backtester.getPortfolio()->getEquityCurve()) {
+        run.equity.emplace_back(std::get<0>(point), std::get<1>(point));
+    }
+    return run;
+}
+
+CachedRun ResultCache::capture(const EngineLane& lane) {
+    CachedRun run;
+    run.metrics = lane.getPortfolio()->runMetrics();
+    run.events = lane.eventCount();
+    for (const auto& point : lane.getPortfolio()->getEquityCurve()) {
+        run.equity.emplace_back(std::get<0>(point), std::get<1>(point));
+    }
+    return run;
+}
+
+void ResultCache::scan() {
+    std::ifstream file(path_, std::ios::binary);
+    if (!file) {
+        return;
+    }
+    file.seekg(scanned_);
+    std::string line;
+    for (;;) {
+        const std::streamoff offset = file.tellg();
+        if (!std::getline(file, line) || file.eof()) {
+            break; // A line without its newline is still being written, or was cut off
+        }
+        scanned_ = offset + static_cast<std::streamoff>(line.size()) + 1;
+        if (line.size() > kKeyPrefix.size() + kKeyLength && line.compare(0, kKeyPrefix.size(), kKeyPrefix) == 0) {
+            index_[line.substr(kKeyPrefix.size(), kKeyLength)] = offset;
+        }
+    }
+}
+
+std::optional<CachedRun> ResultCache::find(const std::string& key, bool with_equity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        // Another process may have added it.
+        scan();
+        it = index_.find(key);
+    }
+    if (it != index_.end()) {
+        std::ifstream file(path_, std::ios::binary);
+        file.seekg(it->second);
+        std::string line;
+        try {
+            if (std::getline(file, line)) {
+                const size_t equity_at = line.find(kEquityField);
+                const json entry = json::parse(with_equity || equity_at == std::string::npos ? line : line.substr(0, equity_at) + "}");
+                if (entry.value("key", "") == key) {
+                    CachedRun run;
+                    const json metrics = entry.value("metrics", json::object());
+                    run.metrics.points = metrics.value("points", 0LL);
+                    run.metrics.final_equity = number(metrics, "final_equity");
+                    run.metrics.total_return = number(metrics, "total_return");
+                    run.metrics.max_drawdown = number(metrics, "max_drawdown");
+                    run.metrics.sharpe = number(metrics, "sharpe");
+                    run.metrics.trades = metrics.value("trades", size_t{0});
+                    run.events = entry.value("events", 0LL);
+                    if (entry.contains("equity")) {
+                        run.equity = entry["equity"].get<std::vector<std::pair<long long, double>>>();
+                    }
+                    ++hits_;
+                    return run;
+                }
+            }
+        } catch (const json::exception& e) {
+            LOG_WARN(kLog, "Unreadable entry in {}: {}", path_, e.what());
+        }
+        index_.erase(it); // The run is done again and stored afresh
+    }
+    ++misses_;
+    return std::nullopt;
+}
+
+void ResultCache::store(const std::string& key, const CachedRun& run) {
+    const RunMetrics& m = run.metrics;
+    const json entry = {
+        {"metrics", {{"points", m.points}, {"final_equity", m.final_equity}, {"total_return", m.total_return},
+                     {"max_drawdown", m.max_drawdown}, {"sharpe", m.sharpe}, {"trades", m.trades}}},
+        {"events", run.events}};
+    // The key goes first so scan() can index a line without parsing it, the
+    // equity curve last so find() can leave it out.
+    std::string line = kKeyPrefix + key + "\"," + entry.dump().substr(1);
+    if (store_equity_ && !run.equity.empty()) {
+        line.pop_back();
+        line += kEquityField + json(run.equity).dump() + "}";
+    }
+    line += "\n";
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::FILE* file = std::fopen(path_.c_str(), "ab");
+    if (!file) {
+        LOG_WARN(kLog, "Cannot append to {}", path_);
+        return;
+    }
+    // Unbuffered: the line goes out in one append, whole, next to other processes' lines.
+    std::setvbuf(file, nullptr, _IONBF, 0);
+    const bool written = std::fwrite(line.data(), 1, line.size(), file) == line.size();
+    std::fclose(file);
+    if (!written) {
+        LOG_WARN(kLog, "Short write to {}", path_);
+    }
+}
+
+uint64_t ResultCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+uint64_t ResultCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+size_t ResultCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return index_.size();
+}
@@ -0,0 +1,129 @@
+#include "../../include/core/StrategyRuntime.h"
+#include "../../include/core/EngineLane.h"
+#include "../../include/core/ThreadAffinity.h"
+#include <algorithm>
+
+StrategyRuntime::StrategyRuntime(const std::vector<std::shared_ptr<Strategy>>& strategies,
+                                 const std::vector<EventQueuePtr>& outboxes,
+                                 Mode mode,
+                                 size_t inbox_capacity,
+                                 bool pin_threads)
+    : mode_(mode), pin_threads_(pin_threads) {
+    for (size_t i = 0; i < strategies.size(); ++i) {
+        auto worker = std::make_unique<Worker>(inbox_capacity);
+        worker->strategy.push_back(strategies[i]);
+        worker->outbox = outboxes[i];
+        workers_.push_back(std::move(worker));
+    }
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        workers_[i]->thread = std::thread(&StrategyRuntime::worker_loop, this, std::ref(*workers_[i]), i);
+    }
+}
+
+StrategyRuntime::~StrategyRuntime() {
+    stop();
+}
+
+void StrategyRuntime::stop() {
+    stopping_ = true;
+    for (auto& worker : workers_) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+}
+
+void StrategyRuntime::worker_loop(Worker& worker, size_t index) {
+    if (pin_threads_) {
+        // Core 0 is left to the engine thread.
+        const size_t cores = std::max(1u, std::thread::hardware_concurrency());
+        pinCurrentThread(cores > 1 ? 1 + index % (cores - 1) : 0);
+    }
+
+    Backoff backoff;
+    Item item;
+    while (true) {
+        if (!worker.inbox.try_pop(item)) {
+            if (stopping_.load(std::memory_order_acquire)) {
+                break;
+            }
+            backoff.pause();
+            continue;
+        }
+        backoff.reset();
+        dispatchToStrategies(item.event, worker.strategy);
+        if (mode_ == Mode::Deterministic) {
+            while (auto output = worker.outbox->try_pop()) {
+                worker.produced.push_back({item.sequence, *output.value()});
+            }
+        }
+        worker.handled.fetch_add(1, std::memory_order_release);
+    }
+}
+
+void StrategyRuntime::publish(const std::shared_ptr<Event>& event) {
+    switch (event->type) {
+        case EventType::MARKET:
+        case EventType::TRADE:
+        case EventType::ORDER_BOOK:
+        case EventType::MARKET_REGIME_CHANGED:
+            break;
+        default:
+            return;
+    }
+
+    const Item item{next_sequence_++, event};
+    for (auto& worker : workers_) {
+        if (mode_ == Mode::Deterministic) {
+            Backoff backoff;
+            while (!worker->inbox.try_push(item)) {
+                backoff.pause();
+            }
+            ++worker->published;
+        } else if (worker->inbox.try_push(item)) {
+            ++worker->published;
+        } else {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void StrategyRuntime::drain() {
+    for (auto& worker : workers_) {
+        Backoff backoff;
+        while (worker->handled.load(std::memory_order_acquire) < worker->published) {
+            backoff.pause();
+        }
+    }
+}
+
+bool StrategyRuntime::collect(ThreadSafeQueue<std::shared_ptr<Event>>& engine_queue) {
+    if (mode_ != Mode::Deterministic) {
+        return false;
+    }
+
+    drain();
+    std::vector<std::pair<size_t, Item*>> merged; // (strategy, item)
+    for (size_t i = 0; i < workers_.size(); ++i) {
+        for (Item& item : workers_[i]->produced) {
+            merged.emplace_back(i, &item);
+        }
+    }
+    if (merged.empty()) {
+        return false;
+    }
+
+    // Serial order: events in sequence, and within an event the strategies in
+    // order; each strategy's own output is already in order.
+    std::stable_sort(merged.begin(), merged.end(), [](const auto& a, const auto& b) {
+        if (a.second->sequence != b.second->sequence) return a.second->sequence < b.second->sequence;
+        return a.first < b.first;
+    });
+    for (auto& [strategy, item] : merged) {
+        engine_queue.push(std::make_shared<std::shared_ptr<Event>>(std::move(item->event)));
+    }
+    for (auto& worker : workers_) {
+        worker->produced.clear();
+    }
+    return true;
+}
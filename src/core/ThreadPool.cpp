@@ -0,0 +1,115 @@
+#include "../../include/core/ThreadPool.h"
+#include "../../include/core/AsyncLogger.h"
+#include <algorithm>
+#include <optional>
+
+thread_local ThreadPool* ThreadPool::current_pool_ = nullptr;
+thread_local size_t ThreadPool::current_index_ = 0;
+
+ThreadPool::ThreadPool(size_t threads, bool quiet_workers) : quiet_workers_(quiet_workers) {
+    if (threads == 0) {
+        threads = resolveThreadCount(0);
+    }
+    if (quiet_workers_) {
+        ScopedLogMute::muteStdout();
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        queues_.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back(&ThreadPool::worker_loop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+        stopping_ = true;
+    }
+    wake_cond_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+size_t ThreadPool::resolveThreadCount(int requested) {
+    if (requested > 0) {
+        return static_cast<size_t>(requested);
+    }
+    return std::max(1u, std::thread::hardware_concurrency());
+}
+
+void ThreadPool::enqueue(std::function<void()> task) {
+    // A worker keeps its own sub-tasks local; outside callers spread them out.
+    const size_t index = current_pool_ == this
+        ? current_index_
+        : next_queue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    // Counted before it is visible so that a pop can never take pending_ below zero.
+    pending_.fetch_add(1, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    {
+        // Taken so the notify cannot slip in between a worker's check and its wait.
+        std::lock_guard<std::mutex> lock(wake_mutex_);
+    }
+    wake_cond_.notify_one();
+}
+
+bool ThreadPool::pop_task(size_t index, std::function<void()>& task) {
+    {
+        WorkerQueue& own = *queues_[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    for (size_t offset = 1; offset < queues_.size(); ++offset) {
+        WorkerQueue& victim = *queues_[(index + offset) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::run_one(size_t index) {
+    std::function<void()> task;
+    if (!pop_task(index, task)) {
+        return false;
+    }
+    task(); // Exceptions are captured by the packaged_task
+    return true;
+}
+
+void ThreadPool::worker_loop(size_t index) {
+    current_pool_ = this;
+    current_index_ = index;
+    std::optional<ScopedLogMute> mute;
+    if (quiet_workers_) {
+        mute.emplace();
+    }
+
+    while (true) {
+        if (run_one(index)) {
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(wake_mutex_);
+        wake_cond_.wait(lock, [this] {
+            return stopping_.load() || pending_.load(std::memory_order_acquire) > 0;
+        });
+        if (stopping_ && pending_.load() == 0) {
+            break;
+        }
+    }
+}
@@ -1,7 +1,13 @@
 #include "../../include/core/WalkForwardAnalyzer.h"
 #include "../../include/core/Optimizer.h"
 #include "../../include/core/Backtester.h"
+#include "../../include/core/ThreadPool.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
 #include <iostream>
+#include <stdexcept>
 #include <vector>
 #include <string>
 
@@ -27,7 +33,7 @@ WalkForwardAnalyzer::WalkForwardAnalyzer(const json& config) : config_(config) {
 }
 
 void WalkForwardAnalyzer::run() {
-    if (!walk_forward_params_["enabled"].get<bool>()) {
+    if (!walk_forward_params_.value("enabled", false)) {
         std::cout << "Walk-forward analysis is disabled in config.json." << std::endl;
         return;
     }
@@ -39,56 +45,139 @@ void WalkForwardAnalyzer::run() {
     int in_sample_months = walk_forward_params_["in_sample_months"];
     int out_of_sample_months = walk_forward_params_["out_of_sample_months"];
 
-    std::string current_is_start = start_date;
-
-    while (true) {
-        std::string current_is_end = add_months(current_is_start, in_sample_months);
-        std::string current_oos_start = current_is_end;
-        std::string current_oos_end = add_months(current_oos_start, out_of_sample_months);
-
-        if (current_oos_end > end_date) {
+    std::vector<WalkForwardSplit> splits;
+    for (std::string current_is_start = start_date;; current_is_start = add_months(current_is_start, out_of_sample_months)) {
+        WalkForwardSplit split;
+        split.in_sample_start = current_is_start;
+        split.in_sample_end = add_months(current_is_start, in_sample_months);
+        split.out_of_sample_start = split.in_sample_end;
+        split.out_of_sample_end = add_months(split.out_of_sample_start, out_of_sample_months);
+        if (split.out_of_sample_end > end_date) {
             break;
         }
+        splits.push_back(split);
+    }
 
-        std::cout << "\n--- Running Period ---" << std::endl;
-        std::cout << "In-Sample: " << current_is_start << " to " << current_is_end << std::endl;
-        std::cout << "Out-of-Sample: " << current_oos_start << " to " << current_oos_end << std::endl;
-
-        // 1. Run optimization on in-sample data
-        json is_config = config_;
-        is_config["data"]["start_date"] = current_is_start;
-        is_config["data"]["end_date"] = current_is_end;
-        is_config["optimization"]["enabled"] = true;
-        
-        Optimizer is_optimizer(is_config);
-        json best_params = is_optimizer.run(); 
-
-        if (best_params.empty()) {
-            std::cerr << "Optimization failed for period " << current_is_start << " to " << current_is_end << ". Skipping." << std::endl;
-            current_is_start = add_months(current_is_start, out_of_sample_months);
-            continue;
-        }
+    json optimization_config = config_.value("optimization", json::object());
+    std::string strategy_to_test = walk_forward_params_.value("strategy_to_test",
+        optimization_config.value("strategy_to_optimize", ""));
+    auto results = runSplits(config_, strategy_to_test, splits, optimization_config);
+    printReport(results);
+
+    std::cout << "\n--- Walk-Forward Analysis Complete ---" << std::endl;
+}
+
+std::vector<WalkForwardResult> WalkForwardAnalyzer::runSplits(
+    const json& base_config,
+    const std::string& strategy_name,
+    const std::vector<WalkForwardSplit>& splits,
+    const json& optimization_config
+) {
+    std::vector<WalkForwardResult> results(splits.size());
+    if (splits.empty()) {
+        return results;
+    }
+
+    ParameterSpace space = ParameterSpace::fromConfig(optimization_config.value("param_ranges", json::object()));
+    if (space.size() == 0) {
+        throw std::runtime_error("Walk-forward analysis needs optimization.param_ranges");
+    }
+    const std::string method = optimization_config.value("search", "grid");
+    const size_t threads = ThreadPool::resolveThreadCount(optimization_config.value("max_threads", 0));
+
+    std::vector<json> in_sample_configs, out_of_sample_configs;
+    for (size_t i = 0; i < splits.size(); ++i) {
+        results[i].split = splits[i];
+        json in_sample_config = base_config;
+        in_sample_config["run_mode"] = "BACKTEST";
+        in_sample_config["data"]["start_date"] = splits[i].in_sample_start;
+        in_sample_config["data"]["end_date"] = splits[i].in_sample_end;
+        in_sample_configs.push_back(std::move(in_sample_config));
+
+        json out_of_sample_config = base_config;
+        out_of_sample_config["run_mode"] = "BACKTEST";
+        out_of_sample_config["data"]["start_date"] = splits[i].out_of_sample_start;
+        out_of_sample_config["data"]["end_date"] = splits[i].out_of_sample_end;
+        out_of_sample_configs.push_back(std::move(out_of_sample_config));
+    }
 
-        std::cout << "Found best params: " << best_params.dump() << std::endl;
+    auto start_time = std::chrono::steady_clock::now();
+    ThreadPool pool(threads, true);
 
-        // 2. Run backtest on out-of-sample data with best params
-        json oos_config = config_;
-        std::string strategy_to_test = walk_forward_params_["strategy_to_test"];
-        for (auto& strategy_config : oos_config["strategies"]) {
-            if (strategy_config["name"] == strategy_to_test) {
-                strategy_config["params"] = best_params;
-                break;
+    auto run_out_of_sample = [&](size_t i, const std::vector<ParameterResult>& in_sample) {
+        WalkForwardResult& result = results[i];
+        int best = Optimizer::bestResultIndex(in_sample);
+        if (best < 0) {
+            result.error = in_sample.empty() ? "No parameter sets evaluated" : "Optimization failed: " + in_sample.front().error;
+            return;
+        }
+        result.best_params = in_sample[best].params;
+        result.in_sample_sharpe = in_sample[best].metric;
+        ParameterResult oos = Optimizer::evaluate(out_of_sample_configs[i], strategy_name, result.best_params);
+        if (!oos.ok) {
+            result.error = "Out-of-sample run failed: " + oos.error;
+        }
+        result.out_of_sample_sharpe = oos.metric;
+        result.out_of_sample_return = oos.total_return;
+        result.ok = result.error.empty();
+    };
+
+    if (method == "grid" && space.gridSize() > 0) {
+        const std::vector<json> sets = space.grid();
+        const size_t m = sets.size();
+        std::cout << "Walk-forward: " << splits.size() << " splits x " << m << " parameter sets on "
+                  << pool.size() << " threads..." << std::endl;
+
+        std::vector<ParameterResult> in_sample(splits.size() * m);
+        std::vector<std::atomic<size_t>> remaining(splits.size());
+        for (auto& counter : remaining) counter.store(m);
+
+        pool.parallelFor(in_sample.size(), [&](size_t k) {
+            const size_t i = k / m;
+            in_sample[k] = Optimizer::evaluate(in_sample_configs[i], strategy_name, sets[k % m]);
+            // The split's last in-sample run goes straight on to its out-of-sample run.
+            if (remaining[i].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                std::vector<ParameterResult> split_results(in_sample.begin() + i * m, in_sample.begin() + (i + 1) * m);
+                run_out_of_sample(i, split_results);
             }
+        });
+    } else {
+        std::vector<std::vector<ParameterResult>> in_sample(splits.size());
+        for (size_t i = 0; i < splits.size(); ++i) {
+            std::cout << "Walk-forward split " << i + 1 << "/" << splits.size() << ": " << method << " search" << std::endl;
+            in_sample[i] = Optimizer::search(in_sample_configs[i], strategy_name, space, optimization_config);
         }
-        oos_config["data"]["start_date"] = current_oos_start;
-        oos_config["data"]["end_date"] = current_oos_end;
+        pool.parallelFor(splits.size(), [&](size_t i) { run_out_of_sample(i, in_sample[i]); });
+    }
 
-        Backtester oos_backtester(oos_config);
-        oos_backtester.run();
-        // Here we would collect and aggregate performance from oos_backtester.getPortfolio()
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start_time).count();
+    std::cout << "Walk-forward analysis of " << splits.size() << " splits finished in " << elapsed << " ms." << std::endl;
+    return results;
+}
 
-        current_is_start = add_months(current_is_start, out_of_sample_months);
+void WalkForwardAnalyzer::printReport(const std::vector<WalkForwardResult>& results) {
+    std::cout << "\n--- Walk-Forward Analysis Results ---\n";
+    double return_sum = 0.0;
+    double compounded = 1.0;
+    size_t completed = 0;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const WalkForwardResult& r = results[i];
+        std::cout << "Split " << i + 1 << ": IS " << r.split.in_sample_start << " to " << r.split.in_sample_end
+                  << ", OOS " << r.split.out_of_sample_start << " to " << r.split.out_of_sample_end << "\n";
+        if (!r.ok) {
+            std::cout << "  Skipped: " << r.error << "\n";
+            continue;
+        }
+        std::cout << "  Best params: " << r.best_params.dump() << "\n";
+        printf("  In-Sample Sharpe: %.4f | Out-of-Sample Sharpe: %.4f | Out-of-Sample Return: %.2f%%\n",
+               r.in_sample_sharpe, r.out_of_sample_sharpe, r.out_of_sample_return * 100);
+        return_sum += r.out_of_sample_return;
+        compounded *= 1.0 + r.out_of_sample_return;
+        ++completed;
     }
-
-    std::cout << "\n--- Walk-Forward Analysis Complete ---" << std::endl;
-} 
\ No newline at end of file
+    double avg_return = completed == 0 ? 0 : return_sum / completed;
+    printf("\nCompleted Splits: %zu/%zu\n", completed, results.size());
+    printf("Average Out-of-Sample Return: %.2f%%\n", avg_return * 100);
+    printf("Compounded Out-of-Sample Return: %.2f%%\n", (compounded - 1.0) * 100);
+    std::cout << "-------------------------------------" << std::endl;
+}
@@ -0,0 +1,238 @@
+#include "../../include/data/BinanceMessageParser.h"
+#include <charconv>
+
+namespace {
+
+// Raw text of the top-level fields we care about. Scalars keep their quotes
+// here; scalar_text() strips them when the value is interpreted.
+struct MessageFields {
+    std::string_view e, E, s, U, u, b, a, T, t, p, q, m;
+    std::string_view data; // Combined-stream envelope payload
+};
+
+struct Cursor {
+    const char* pos;
+    const char* end;
+
+    bool done() const { return pos >= end; }
+    char peek() const { return pos < end ? *pos : '\0'; }
+
+    void skipWhitespace() {
+        while (pos < end && (*pos == ' ' || *pos == '\n' || *pos == '\r' || *pos == '\t')) {
+            ++pos;
+        }
+    }
+
+    bool consume(char c) {
+        skipWhitespace();
+        if (peek() != c) return false;
+        ++pos;
+        return true;
+    }
+};
+
+// Advances past a JSON string starting at the opening quote. Escapes are
+// skipped, not decoded; none of the fields we read contain any.
+bool skip_string(Cursor& c, std::string_view* content = nullptr) {
+    if (c.peek() != '"') return false;
+    const char* start = ++c.pos;
+    while (c.pos < c.end) {
+        if (*c.pos == '\\') {
+            c.pos += 2;
+            continue;
+        }
+        if (*c.pos == '"') {
+            if (content) *content = std::string_view(start, c.pos - start);
+            ++c.pos;
+            return true;
+        }
+        ++c.pos;
+    }
+    return false;
+}
+
+bool skip_value(Cursor& c) {
+    c.skipWhitespace();
+    char ch = c.peek();
+    if (ch == '"') {
+        return skip_string(c);
+    }
+    if (ch == '{' || ch == '[') {
+        // Track nesting depth only; strings are skipped so brackets inside them don't count.
+        int depth = 0;
+        while (c.pos < c.end) {
+            char cur = *c.pos;
+            if (cur == '"') {
+                if (!skip_string(c)) return false;
+                continue;
+            }
+            if (cur == '{' || cur == '[') ++depth;
+            else if (cur == '}' || cur == ']') {
+                if (--depth == 0) {
+                    ++c.pos;
+                    return true;
+                }
+            }
+            ++c.pos;
+        }
+        return false;
+    }
+    // Number or literal
+    const char* start = c.pos;
+    while (c.pos < c.end && *c.pos != ',' && *c.pos != '}' && *c.pos != ']' &&
+           *c.pos != ' ' && *c.pos != '\n' && *c.pos != '\r' && *c.pos != '\t') {
+        ++c.pos;
+    }
+    return c.pos > start;
+}
+
+std::string_view scalar_text(std::string_view raw) {
+    if (raw.size() >= 2 && raw.front() == '"' && raw.back() == '"') {
+        return raw.substr(1, raw.size() - 2);
+    }
+    return raw;
+}
+
+bool to_double(std::string_view raw, double& out) {
+    std::string_view text = scalar_text(raw);
+    if (text.empty()) return false;
+    auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+    return ec == std::errc() && ptr == text.data() + text.size();
+}
+
+long long to_integer(std::string_view raw) {
+    std::string_view text = scalar_text(raw);
+    long long value = 0;
+    std::from_chars(text.data(), text.data() + text.size(), value);
+    return value;
+}
+
+bool scan_object(const char* data, std::size_t size, MessageFields& fields) {
+    Cursor c{data, data + size};
+    if (!c.consume('{')) return false;
+    c.skipWhitespace();
+    if (c.peek() == '}') return true;
+
+    while (true) {
+        c.skipWhitespace();
+        std::string_view key;
+        if (!skip_string(c, &key)) return false;
+        if (!c.consume(':')) return false;
+        c.skipWhitespace();
+        const char* value_start = c.pos;
+        if (!skip_value(c)) return false;
+        std::string_view value(value_start, c.pos - value_start);
+
+        if (key.size() == 1) {
+            switch (key[0]) {
+                case 'e': fields.e = value; break;
+                case 'E': fields.E = value; break;
+                case 's': fields.s = value; break;
+                case 'U': fields.U = value; break;
+                case 'u': fields.u = value; break;
+                case 'b': fields.b = value; break;
+                case 'a': fields.a = value; break;
+                case 'T': fields.T = value; break;
+                case 't': fields.t = value; break;
+                case 'p': fields.p = value; break;
+                case 'q': fields.q = value; break;
+                case 'm': fields.m = value; break;
+                default: break;
+            }
+        } else if (key == "data") {
+            fields.data = value;
+        }
+
+        if (c.consume(',')) continue;
+        return c.consume('}');
+    }
+}
+
+// Walks [[price, qty, ...], ...] and reports each level.
+template <typename OnLevel>
+bool for_each_level(std::string_view levels, OnLevel on_level) {
+    if (levels.empty()) return true;
+    Cursor c{levels.data(), levels.data() + levels.size()};
+    if (!c.consume('[')) return false;
+    c.skipWhitespace();
+    if (c.peek() == ']') return true;
+
+    while (true) {
+        if (!c.consume('[')) return false;
+        c.skipWhitespace();
+        const char* price_start = c.pos;
+        if (!skip_value(c)) return false;
+        std::string_view price_raw(price_start, c.pos - price_start);
+        if (!c.consume(',')) return false;
+        c.skipWhitespace();
+        const char* qty_start = c.pos;
+        if (!skip_value(c)) return false;
+        std::string_view qty_raw(qty_start, c.pos - qty_start);
+        // Ignore any trailing elements in the level.
+        while (c.consume(',')) {
+            if (!skip_value(c)) return false;
+        }
+        if (!c.consume(']')) return false;
+
+        double price = 0.0;
+        double quantity = 0.0;
+        if (!to_double(price_raw, price) || !to_double(qty_raw, quantity)) return false;
+        on_level(price, quantity);
+
+        if (c.consume(',')) continue;
+        return c.consume(']');
+    }
+}
+
+} // namespace
+
+BinanceMessageType parse_binance_message(const char* data, std::size_t size, BinanceMessageSink& sink) {
+    MessageFields fields;
+    if (!scan_object(data, size, fields)) {
+        return BinanceMessageType::MALFORMED;
+    }
+    if (fields.e.empty() && !fields.data.empty()) {
+        return parse_binance_message(fields.data.data(), fields.data.size(), sink);
+    }
+
+    std::string_view event_type = scalar_text(fields.e);
+    if (event_type == "depthUpdate") {
+        BinanceDepthHeader header;
+        header.symbol = scalar_text(fields.s);
+        header.event_time = to_integer(fields.E);
+        header.first_update_id = to_integer(fields.U);
+        header.final_update_id = to_integer(fields.u);
+        if (header.symbol.empty()) {
+            return BinanceMessageType::MALFORMED;
+        }
+
+        // Sinks apply levels to their books as they arrive, so every level is
+        // checked before the first one is handed over: a malformed frame must
+        // not leave a half-applied book behind.
+        const auto ignore = [](double, double) {};
+        if (!for_each_level(fields.b, ignore) || !for_each_level(fields.a, ignore)) {
+            return BinanceMessageType::MALFORMED;
+        }
+        sink.onDepthBegin(header);
+        for_each_level(fields.b, [&](double price, double qty) { sink.onBidLevel(price, qty); });
+        for_each_level(fields.a, [&](double price, double qty) { sink.onAskLevel(price, qty); });
+        sink.onDepthEnd();
+        return BinanceMessageType::DEPTH_UPDATE;
+    }
+
+    if (event_type == "trade") {
+        BinanceTrade trade;
+        trade.symbol = scalar_text(fields.s);
+        trade.event_time = to_integer(fields.E);
+        trade.trade_time = to_integer(fields.T);
+        trade.trade_id = to_integer(fields.t);
+        trade.buyer_is_maker = scalar_text(fields.m) == "true";
+        if (trade.symbol.empty() || !to_double(fields.p, trade.price) || !to_double(fields.q, trade.quantity)) {
+            return BinanceMessageType::MALFORMED;
+        }
+        sink.onTrade(trade);
+        return BinanceMessageType::TRADE;
+    }
+
+    return BinanceMessageType::UNKNOWN;
+}
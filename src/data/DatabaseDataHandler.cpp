@@ -1,136 +1,282 @@
 #include "../../include/data/DatabaseDataHandler.h"
 #include "../../include/event/Event.h"
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <stdexcept>
 
-DatabaseDataHandler::DatabaseDataHandler(std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> event_queue, 
+void DatabaseDataHandler::BarChunk::clear() {
+    timestamp.clear();
+    open.clear();
+    high.clear();
+    low.clear();
+    close.clear();
+    volume.clear();
+}
+
+void DatabaseDataHandler::BarChunk::reserve(size_t n) {
+    timestamp.reserve(n);
+    open.reserve(n);
+    high.reserve(n);
+    low.reserve(n);
+    close.reserve(n);
+    volume.reserve(n);
+}
+
+DatabaseDataHandler::DatabaseDataHandler(std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> event_queue,
                                          const std::string& connection_string,
-                                         const std::vector<std::string>& symbols, 
+                                         const std::vector<std::string>& symbols,
                                          const std::string& start_date,
                                          const std::string& end_date)
-    : event_queue_(event_queue), 
-      symbols_(symbols), 
-      start_date_(start_date), 
-      end_date_(end_date),
-      last_loaded_timestamp_(start_date) {
-    
+    : event_queue_(event_queue),
+      symbols_(symbols),
+      start_date_(start_date),
+      end_date_(end_date) {
+
     try {
         conn = std::make_unique<pqxx::connection>(connection_string);
         if (!conn->is_open()) {
             throw std::runtime_error("Could not connect to database.");
         }
         std::cout << "Database connection established." << std::endl;
-        // Load initial chunk for all symbols
-        for(const auto& symbol : symbols_) {
-            data_iterators_[symbol] = data_chunks_[symbol].end(); // Initialize iterator
-            load_chunk(symbol);
-        }
     } catch (const std::exception &e) {
         std::cerr << "Database connection failed: " << e.what() << std::endl;
         throw;
     }
+
+    for (size_t i = 0; i < symbols_.size(); ++i) {
+        cursors_[symbols_[i]].cursor_name = "bars_cursor_" + std::to_string(i);
+    }
+
+    // The connection is used exclusively by the prefetch thread from here on.
+    prefetch_thread_ = std::thread(&DatabaseDataHandler::prefetch_loop, this);
 }
 
 DatabaseDataHandler::~DatabaseDataHandler() {
+    stop_prefetch_ = true;
+    cursors_cond_.notify_all();
+    if (prefetch_thread_.joinable()) {
+        prefetch_thread_.join();
+    }
     if (conn && conn->is_open()) {
         std::cout << "Database connection closed." << std::endl;
     }
 }
 
-void DatabaseDataHandler::load_chunk(const std::string& symbol) {
-    std::cout << "Loading next data chunk for " << symbol << " from " << last_loaded_timestamp_ << "..." << std::endl;
-    
+void DatabaseDataHandler::prefetch_loop() {
     try {
+        // One read-only transaction holds a server-side cursor per symbol, so each
+        // symbol keeps its own position and rows stream in CHUNK_SIZE batches.
         pqxx::work txn(*conn);
-        std::string query = 
-            "SELECT time, open, high, low, close, volume FROM bars "
-            "WHERE symbol = " + txn.quote(symbol) + " "
-            "AND time > " + txn.quote(last_loaded_timestamp_) + " "
-            "AND time <= " + txn.quote(end_date_) + " "
-            "ORDER BY time ASC LIMIT " + std::to_string(CHUNK_SIZE) + ";";
-
-        data_chunks_[symbol] = txn.exec(query);
-        data_iterators_[symbol] = data_chunks_[symbol].begin();
-        
-        if (data_iterators_[symbol] != data_chunks_[symbol].end()) {
-            // This needs to be smarter for multiple symbols. For now, we just update it.
-            last_loaded_timestamp_ = data_chunks_[symbol].back()[0].as<std::string>();
+        for (const auto& symbol : symbols_) {
+            txn.exec(
+                "DECLARE " + cursors_.at(symbol).cursor_name + " NO SCROLL CURSOR FOR "
+                "SELECT (EXTRACT(EPOCH FROM time) * 1000)::BIGINT, open, high, low, close, volume FROM bars "
+                "WHERE symbol = " + txn.quote(symbol) + " "
+                "AND time > " + txn.quote(start_date_) + " "
+                "AND time <= " + txn.quote(end_date_) + " "
+                "ORDER BY time ASC;");
+        }
+
+        while (!stop_prefetch_) {
+            std::string symbol_to_fetch;
+            std::string cursor_name;
+            {
+                std::unique_lock<std::mutex> lock(cursors_mutex_);
+                cursors_cond_.wait(lock, [&] {
+                    if (stop_prefetch_) return true;
+                    for (const auto& [symbol, cursor] : cursors_) {
+                        if (!cursor.prefetched_ready && !cursor.exhausted) return true;
+                    }
+                    return false;
+                });
+                if (stop_prefetch_) break;
+
+                // Serve the symbol whose active chunk has the fewest rows left.
+                size_t fewest_left = std::numeric_limits<size_t>::max();
+                for (const auto& [symbol, cursor] : cursors_) {
+                    if (cursor.prefetched_ready || cursor.exhausted) continue;
+                    size_t left = cursor.active.size() - cursor.position;
+                    if (left < fewest_left) {
+                        fewest_left = left;
+                        symbol_to_fetch = symbol;
+                        cursor_name = cursor.cursor_name;
+                    }
+                }
+            }
+
+            BarChunk chunk = fetch_chunk(txn, cursor_name);
+
+            {
+                std::lock_guard<std::mutex> lock(cursors_mutex_);
+                auto& cursor = cursors_.at(symbol_to_fetch);
+                cursor.exhausted = chunk.size() < static_cast<size_t>(CHUNK_SIZE);
+                cursor.prefetched = std::move(chunk);
+                cursor.prefetched_ready = cursor.prefetched.size() > 0;
+            }
+            cursors_cond_.notify_all();
         }
     } catch (const std::exception &e) {
-        std::cerr << "Error loading data chunk for " << symbol << ": " << e.what() << std::endl;
+        std::cerr << "Error prefetching data chunks: " << e.what() << std::endl;
+        // A partial replay must not pass for the end of the data: the
+        // replay rethrows this.
+        std::lock_guard<std::mutex> lock(cursors_mutex_);
+        prefetch_error_ = std::current_exception();
+    }
+    cursors_cond_.notify_all();
+}
+
+DatabaseDataHandler::BarChunk DatabaseDataHandler::fetch_chunk(pqxx::work& txn, const std::string& cursor_name) {
+    pqxx::result rows = txn.exec("FETCH FORWARD " + std::to_string(CHUNK_SIZE) + " FROM " + cursor_name + ";");
+
+    BarChunk chunk;
+    chunk.reserve(rows.size());
+    for (const auto& row : rows) {
+        chunk.timestamp.push_back(row[0].as<long long>());
+        chunk.open.push_back(row[1].as<double>());
+        chunk.high.push_back(row[2].as<double>());
+        chunk.low.push_back(row[3].as<double>());
+        chunk.close.push_back(row[4].as<double>());
+        chunk.volume.push_back(row[5].is_null() ? 0 : row[5].as<long long>());
+    }
+    return chunk;
+}
+
+bool DatabaseDataHandler::ensure_row(SymbolCursor& cursor, std::unique_lock<std::mutex>& lock) {
+    if (cursor.position < cursor.active.size()) {
+        return true;
+    }
+    cursors_cond_.wait(lock, [&] { return cursor.prefetched_ready || cursor.exhausted || stop_prefetch_ || prefetch_error_; });
+    if (prefetch_error_) {
+        std::rethrow_exception(prefetch_error_);
+    }
+    if (!cursor.prefetched_ready) {
+        return false;
     }
+
+    // Promote the prefetched chunk and free the slot for the next fetch.
+    std::swap(cursor.active, cursor.prefetched);
+    cursor.prefetched.clear();
+    cursor.prefetched_ready = false;
+    cursor.position = 0;
+    cursors_cond_.notify_all();
+    return true;
 }
 
 bool DatabaseDataHandler::isFinished() const {
-    for(const auto& symbol : symbols_) {
-        if (data_iterators_.at(symbol) != data_chunks_.at(symbol).end()) {
-            return false; // Found a chunk with data
+    std::lock_guard<std::mutex> lock(cursors_mutex_);
+    if (prefetch_error_) {
+        return false; // updateBars() reports it
+    }
+    for (const auto& [symbol, cursor] : cursors_) {
+        if (cursor.position < cursor.active.size() || cursor.prefetched_ready || !cursor.exhausted) {
+            return false;
         }
     }
-    // Could also check if a new chunk could be loaded, but for now this is fine.
     return true;
 }
 
 void DatabaseDataHandler::updateBars() {
-    if (isFinished()) {
-        return;
-    }
-
-    // Find next event across all symbol chunks
-    std::string next_symbol_to_process = "";
-    pqxx::result::const_iterator next_iterator;
-    std::string earliest_time = "9999-99-99";
-
-    for (const auto& symbol : symbols_) {
-        auto& it = data_iterators_.at(symbol);
-        if (it == data_chunks_.at(symbol).end()) {
-            load_chunk(symbol); // Attempt to load more data
-            it = data_iterators_.at(symbol); // Reset iterator
+    std::shared_ptr<MarketEvent> market_event;
+    {
+        std::unique_lock<std::mutex> lock(cursors_mutex_);
+        if (prefetch_error_) {
+            std::rethrow_exception(prefetch_error_);
         }
 
-        if (it != data_chunks_.at(symbol).end()) {
-            const pqxx::row& row = *it;
-            std::string current_time = row[0].as<std::string>();
+        // Find next event across all symbol chunks
+        SymbolCursor* next_cursor = nullptr;
+        const std::string* next_symbol = nullptr;
+        long long earliest_time = std::numeric_limits<long long>::max();
+        for (const auto& symbol : symbols_) {
+            auto& cursor = cursors_.at(symbol);
+            if (!ensure_row(cursor, lock)) {
+                continue;
+            }
+            long long current_time = cursor.active.timestamp[cursor.position];
             if (current_time < earliest_time) {
                 earliest_time = current_time;
-                next_symbol_to_process = symbol;
+                next_cursor = &cursor;
+                next_symbol = &symbol;
             }
         }
-    }
 
-    if (!next_symbol_to_process.empty()) {
-        const auto& row = *data_iterators_.at(next_symbol_to_process);
-        
-        // Convert timestamp string to long long before creating the event
-        long long timestamp_ll = 0;
-        try {
-            timestamp_ll = std::stoll(row[0].as<std::string>());
-        } catch (const std::invalid_argument& ia) {
-            std::cerr << "Invalid argument: " << ia.what() << " for timestamp " << row[0].as<std::string>() << std::endl;
-            // Handle error, maybe skip this bar
-            data_iterators_.at(next_symbol_to_process)++;
-            return;
-        } catch (const std::out_of_range& oor) {
-            std::cerr << "Out of Range error: " << oor.what() << " for timestamp " << row[0].as<std::string>() << std::endl;
-            // Handle error
-            data_iterators_.at(next_symbol_to_process)++;
+        if (!next_cursor) {
             return;
         }
 
-        auto market_event = std::make_shared<MarketEvent>(
-            next_symbol_to_process, 
-            timestamp_ll, 
-            row[4].as<double>() // close price
-        );
-        event_queue_->push(std::make_shared<std::shared_ptr<Event>>(std::static_pointer_cast<Event>(market_event)));
+        const BarChunk& chunk = next_cursor->active;
+        const size_t i = next_cursor->position++;
+
+        Bar bar;
+        bar.symbol = *next_symbol;
+        bar.timestamp = std::to_string(chunk.timestamp[i]);
+        bar.open = chunk.open[i];
+        bar.high = chunk.high[i];
+        bar.low = chunk.low[i];
+        bar.close = chunk.close[i];
+        bar.volume = chunk.volume[i];
+        next_cursor->latest_bar = bar;
+        if (next_cursor->history.size() < BAR_HISTORY) {
+            next_cursor->history.push_back(bar);
+        } else {
+            next_cursor->history[next_cursor->replayed % BAR_HISTORY] = bar;
+        }
+        ++next_cursor->replayed;
+
+        market_event = std::make_shared<MarketEvent>(*next_symbol, chunk.timestamp[i], chunk.close[i]);
+    }
+
+    event_queue_->push(std::make_shared<std::shared_ptr<Event>>(std::static_pointer_cast<Event>(market_event)));
+    if (on_new_data_) {
+        on_new_data_();
+    }
+}
 
-        
-        data_iterators_.at(next_symbol_to_process)++;
+std::optional<Bar> DatabaseDataHandler::getLatestBar(const std::string& symbol) const {
+    std::lock_guard<std::mutex> lock(cursors_mutex_);
+    auto it = cursors_.find(symbol);
+    if (it == cursors_.end()) {
+        return std::nullopt;
     }
+    return it->second.latest_bar;
 }
 
-// Placeholder implementations for other interface methods
-std::optional<Bar> DatabaseDataHandler::getLatestBar(const std::string& symbol) const { return std::nullopt; }
-double DatabaseDataHandler::getLatestBarValue(const std::string& symbol, const std::string& val_type) { return 0.0; }
-std::vector<Bar> DatabaseDataHandler::getLatestBars(const std::string& symbol, int n) { return {}; }
+double DatabaseDataHandler::getLatestBarValue(const std::string& symbol, const std::string& val_type) {
+    auto bar = getLatestBar(symbol);
+    if (!bar) {
+        return 0.0;
+    }
+    if (val_type == "price" || val_type == "close") return bar->close;
+    if (val_type == "open") return bar->open;
+    if (val_type == "high") return bar->high;
+    if (val_type == "low") return bar->low;
+    if (val_type == "volume") return bar->volume;
+    return 0.0;
+}
+
+std::vector<Bar> DatabaseDataHandler::getLatestBars(const std::string& symbol, int n) {
+    // History is limited to the last BAR_HISTORY bars, whatever the chunk boundaries.
+    std::lock_guard<std::mutex> lock(cursors_mutex_);
+    auto it = cursors_.find(symbol);
+    if (it == cursors_.end()) {
+        return {};
+    }
+    const SymbolCursor& cursor = it->second;
+    size_t count = std::min(static_cast<size_t>(std::max(n, 0)), cursor.history.size());
 
+    std::vector<Bar> bars;
+    bars.reserve(count);
+    for (size_t i = cursor.replayed - count; i < cursor.replayed; ++i) {
+        bars.push_back(cursor.history[i % BAR_HISTORY]);
+    }
+    return bars;
+}
+
+std::optional<OrderBook> DatabaseDataHandler::getLatestOrderBook(const std::string&) const {
+    return std::nullopt; // The bars table carries no depth data
+}
+
+const std::vector<std::string>& DatabaseDataHandler::getSymbols() const {
+    return symbols_;
+}
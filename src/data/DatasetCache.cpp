@@ -0,0 +1,418 @@
+#include "../../include/data/DatasetCache.h"
+#include "../../include/core/AsyncLogger.h"
+#include "mio/mio.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <random>
+#include <tuple>
+
+static const LogComponent kLog("DatasetCache");
+
+namespace {
+
+// Days since 1970-01-01 for a proleptic Gregorian date (no timezone involved).
+long long days_from_civil(int y, unsigned m, unsigned d) {
+    y -= m <= 2;
+    const long long era = (y >= 0 ? y : y - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(y - era * 400);
+    const unsigned doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<long long>(doe) - 719468;
+}
+
+constexpr long long MS_PER_DAY = 24LL * 60 * 60 * 1000;
+
+// Heap storage of a series parsed in this process.
+struct TradeColumns {
+    std::vector<long long> timestamp;
+    std::vector<double> price;
+    std::vector<double> quantity;
+    std::vector<uint8_t> buyer_aggressor;
+};
+
+// Shared segment layout: SegmentHeader, then the columns at 64-byte aligned
+// offsets recorded in the manifest. Sizes are rounded up to 2 MB so that the
+// segment can also live on a hugetlbfs mount.
+constexpr uint64_t SEGMENT_MAGIC = 0x5345475344534C4CULL; // "LLSDSGES"
+constexpr uint32_t SEGMENT_VERSION = 1;
+constexpr size_t SEGMENT_ALIGN = 2 * 1024 * 1024;
+
+struct SegmentHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t count;
+    uint64_t padding[5];
+};
+static_assert(sizeof(SegmentHeader) == 64, "Segment header layout changed");
+
+size_t align_up(size_t n, size_t alignment) {
+    return (n + alignment - 1) / alignment * alignment;
+}
+
+uint64_t fnv1a(const std::string& s) {
+    uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+} // namespace
+
+Trade TradeSeries::trade(size_t i) const {
+    Trade t;
+    t.symbol = symbol;
+    t.timestamp = timestamp[i];
+    t.price = price[i];
+    t.quantity = quantity[i];
+    t.aggressor_side = buyer_aggressor[i] ? "BUY" : "SELL";
+    return t;
+}
+
+size_t TradeSeries::lowerBound(long long t) const {
+    return std::lower_bound(timestamp, timestamp + count, t) - timestamp;
+}
+
+bool DatasetCache::Key::operator<(const Key& other) const {
+    return std::tie(path, symbol, mtime, size) < std::tie(other.path, other.symbol, other.mtime, other.size);
+}
+
+DatasetCache& DatasetCache::instance() {
+    static DatasetCache cache;
+    return cache;
+}
+
+long long DatasetCache::dateToEpochMs(const std::string& date) {
+    int y = 0;
+    unsigned m = 0, d = 0;
+    char tail = 0;
+    if (std::sscanf(date.c_str(), "%d-%u-%u%c", &y, &m, &d, &tail) != 3 || m < 1 || m > 12 || d < 1 || d > 31) {
+        throw std::runtime_error("Invalid date (expected YYYY-MM-DD): " + date);
+    }
+    return days_from_civil(y, m, d) * MS_PER_DAY;
+}
+
+TradeSlice DatasetCache::trades(const std::string& symbol, const std::string& path,
+                                const std::string& start_date, const std::string& end_date) {
+    std::error_code ec;
+    Key key;
+    key.path = std::filesystem::absolute(path, ec).lexically_normal().string();
+    key.symbol = symbol;
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) {
+        return {};
+    }
+    key.mtime = static_cast<long long>(mtime.time_since_epoch().count());
+    key.size = std::filesystem::file_size(path, ec);
+
+    std::shared_ptr<const TradeSeries> series;
+    {
+        // Parsing happens under the lock: concurrent runs asking for the same
+        // file wait for one parse instead of all doing it.
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = entries_.find(key);
+        if (it != entries_.end()) {
+            series = it->second.lock();
+        }
+        if (series) {
+            ++hits_;
+            LOG_DEBUG(kLog, "Cache hit for {} ({} trades)", path, series->size());
+        } else {
+            ++misses_;
+            if (!shared_dir_.empty()) {
+                series = map_shared(key);
+            }
+            if (series) {
+                LOG_INFO(kLog, "Mapped {} shared trades for {} from {}", series->size(), symbol, shared_dir_);
+            } else {
+                series = parse_trades(symbol, path);
+                if (!series) {
+                    return {};
+                }
+                LOG_INFO(kLog, "Loaded {} trades for {} from {}", series->size(), symbol, path);
+                // Switch to the published copy so this process doesn't hold a second one
+                if (!shared_dir_.empty() && publish_shared(key, *series)) {
+                    if (auto mapped = map_shared(key)) {
+                        series = std::move(mapped);
+                    }
+                }
+            }
+            entries_[key] = series;
+        }
+        retain(series);
+    }
+
+    TradeSlice slice;
+    slice.series = series;
+    slice.begin = start_date.empty() ? 0 : series->lowerBound(dateToEpochMs(start_date));
+    slice.end = end_date.empty() ? series->size() : series->lowerBound(dateToEpochMs(end_date) + MS_PER_DAY);
+    slice.end = std::max(slice.begin, slice.end);
+    return slice;
+}
+
+std::shared_ptr<const TradeSeries> DatasetCache::parse_trades(const std::string& symbol, const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return nullptr;
+    }
+
+    auto columns = std::make_shared<TradeColumns>();
+
+    std::string line;
+    std::getline(file, line); // Skip header
+    size_t skipped = 0;
+    while (std::getline(file, line)) {
+        // timestamp,price,quantity,side
+        const char* p = line.c_str();
+        char* end = nullptr;
+        long long ts = std::strtoll(p, &end, 10);
+        if (end == p || *end != ',') { ++skipped; continue; }
+        p = end + 1;
+        double price = std::strtod(p, &end);
+        if (end == p || *end != ',') { ++skipped; continue; }
+        p = end + 1;
+        double quantity = std::strtod(p, &end);
+        if (end == p) { ++skipped; continue; }
+        p = *end == ',' ? end + 1 : end;
+
+        columns->timestamp.push_back(ts);
+        columns->price.push_back(price);
+        columns->quantity.push_back(quantity);
+        columns->buyer_aggressor.push_back(*p == 'S' || *p == 's' ? 0 : 1);
+    }
+    if (skipped > 0) {
+        LOG_WARN(kLog, "Skipped {} malformed lines in {}", skipped, path);
+    }
+
+    if (!std::is_sorted(columns->timestamp.begin(), columns->timestamp.end())) {
+        // Keep equal timestamps in file order
+        std::vector<size_t> order(columns->timestamp.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return columns->timestamp[a] < columns->timestamp[b];
+        });
+        auto permute = [&order](auto& column) {
+            std::remove_reference_t<decltype(column)> sorted;
+            sorted.reserve(column.size());
+            for (size_t i : order) sorted.push_back(column[i]);
+            column.swap(sorted);
+        };
+        permute(columns->timestamp);
+        permute(columns->price);
+        permute(columns->quantity);
+        permute(columns->buyer_aggressor);
+    }
+    columns->timestamp.shrink_to_fit();
+    columns->price.shrink_to_fit();
+    columns->quantity.shrink_to_fit();
+    columns->buyer_aggressor.shrink_to_fit();
+
+    auto series = std::make_shared<TradeSeries>();
+    series->symbol = symbol;
+    series->timestamp = columns->timestamp.data();
+    series->price = columns->price.data();
+    series->quantity = columns->quantity.data();
+    series->buyer_aggressor = columns->buyer_aggressor.data();
+    series->count = columns->timestamp.size();
+    series->storage_bytes = series->count * (sizeof(long long) + 2 * sizeof(double) + 1);
+    series->storage = std::move(columns);
+    return series;
+}
+
+std::string DatasetCache::segment_name(const Key& key) const {
+    std::ostringstream id;
+    id << key.path << '|' << key.symbol << '|' << key.mtime << '|' << key.size;
+    std::ostringstream name;
+    name << "lsb-trades-" << key.symbol << '-' << std::hex << fnv1a(id.str());
+    return (std::filesystem::path(shared_dir_) / name.str()).string();
+}
+
+std::shared_ptr<const TradeSeries> DatasetCache::map_shared(const Key& key) const {
+    // The manifest only appears once its segment is complete, so a manifest
+    // that names this exact source file means the segment can be mapped.
+    const std::string base = segment_name(key);
+    std::ifstream manifest_file(base + ".json");
+    if (!manifest_file.is_open()) {
+        return nullptr;
+    }
+    try {
+        nlohmann::json manifest = nlohmann::json::parse(manifest_file);
+        if (manifest.at("source").get<std::string>() != key.path ||
+            manifest.at("symbol").get<std::string>() != key.symbol ||
+            manifest.at("mtime").get<long long>() != key.mtime ||
+            manifest.at("size").get<uintmax_t>() != key.size) {
+            return nullptr;
+        }
+
+        auto map = std::make_shared<mio::mmap_source>();
+        std::error_code ec;
+        map->map(base + ".seg", ec);
+        if (ec) {
+            LOG_WARN(kLog, "Could not map shared segment {}: {}", base, ec.message());
+            return nullptr;
+        }
+
+        const size_t count = manifest.at("count").get<size_t>();
+        const auto& columns = manifest.at("columns");
+        const size_t ts_offset = columns.at("timestamp").get<size_t>();
+        const size_t price_offset = columns.at("price").get<size_t>();
+        const size_t qty_offset = columns.at("quantity").get<size_t>();
+        const size_t side_offset = columns.at("buyer_aggressor").get<size_t>();
+
+        SegmentHeader header;
+        if (map->size() < sizeof(header) || side_offset + count > map->size()) {
+            LOG_WARN(kLog, "Shared segment {} is truncated", base);
+            return nullptr;
+        }
+        std::memcpy(&header, map->data(), sizeof(header));
+        if (header.magic != SEGMENT_MAGIC || header.version != SEGMENT_VERSION || header.count != count) {
+            LOG_WARN(kLog, "Shared segment {} does not match its manifest", base);
+            return nullptr;
+        }
+
+        const char* data = map->data();
+        auto series = std::make_shared<TradeSeries>();
+        series->symbol = key.symbol;
+        series->timestamp = reinterpret_cast<const long long*>(data + ts_offset);
+        series->price = reinterpret_cast<const double*>(data + price_offset);
+        series->quantity = reinterpret_cast<const double*>(data + qty_offset);
+        series->buyer_aggressor = reinterpret_cast<const uint8_t*>(data + side_offset);
+        series->count = count;
+        series->storage_bytes = map->size();
+        series->shared = true;
+        series->storage = std::move(map);
+        return series;
+    } catch (const std::exception& e) {
+        LOG_WARN(kLog, "Ignoring shared segment {}: {}", base, e.what());
+        return nullptr;
+    }
+}
+
+bool DatasetCache::publish_shared(const Key& key, const TradeSeries& series) const {
+    // Written under a temporary name and renamed into place, segment first and
+    // manifest last, so readers never see a partial segment. Processes racing
+    // to publish the same data just replace each other's identical copy.
+    const std::string base = segment_name(key);
+    const std::string tmp_suffix = ".tmp" + std::to_string(std::random_device{}());
+    const size_t n = series.size();
+    const size_t ts_offset = align_up(sizeof(SegmentHeader), 64);
+    const size_t price_offset = align_up(ts_offset + n * sizeof(long long), 64);
+    const size_t qty_offset = align_up(price_offset + n * sizeof(double), 64);
+    const size_t side_offset = align_up(qty_offset + n * sizeof(double), 64);
+    const size_t total = align_up(side_offset + n, SEGMENT_ALIGN);
+
+    try {
+        const std::string seg_tmp = base + ".seg" + tmp_suffix;
+        { std::ofstream create(seg_tmp, std::ios::binary | std::ios::trunc); }
+        std::filesystem::resize_file(seg_tmp, total);
+        {
+            mio::mmap_sink sink;
+            std::error_code ec;
+            sink.map(seg_tmp, 0, total, ec);
+            if (ec) {
+                throw std::runtime_error(ec.message());
+            }
+            SegmentHeader header{};
+            header.magic = SEGMENT_MAGIC;
+            header.version = SEGMENT_VERSION;
+            header.count = n;
+            std::memcpy(sink.data(), &header, sizeof(header));
+            std::memcpy(sink.data() + ts_offset, series.timestamp, n * sizeof(long long));
+            std::memcpy(sink.data() + price_offset, series.price, n * sizeof(double));
+            std::memcpy(sink.data() + qty_offset, series.quantity, n * sizeof(double));
+            std::memcpy(sink.data() + side_offset, series.buyer_aggressor, n);
+        }
+        std::filesystem::rename(seg_tmp, base + ".seg");
+
+        nlohmann::json manifest = {
+            {"source", key.path},
+            {"symbol", key.symbol},
+            {"mtime", key.mtime},
+            {"size", key.size},
+            {"count", n},
+            {"bytes", total},
+            {"columns", {
+                {"timestamp", ts_offset},
+                {"price", price_offset},
+                {"quantity", qty_offset},
+                {"buyer_aggressor", side_offset}
+            }}
+        };
+        const std::string manifest_tmp = base + ".json" + tmp_suffix;
+        {
+            std::ofstream out(manifest_tmp, std::ios::trunc);
+            out << manifest.dump(4);
+        }
+        std::filesystem::rename(manifest_tmp, base + ".json");
+        LOG_INFO(kLog, "Published {} trades for {} to {}.seg", n, key.symbol, base);
+        return true;
+    } catch (const std::exception& e) {
+        LOG_WARN(kLog, "Could not publish shared segment {}: {}", base, e.what());
+        return false;
+    }
+}
+
+void DatasetCache::retain(const std::shared_ptr<const TradeSeries>& series) {
+    auto it = std::find(resident_.begin(), resident_.end(), series);
+    if (it != resident_.end()) {
+        resident_.splice(resident_.begin(), resident_, it);
+        return;
+    }
+    resident_.push_front(series);
+    resident_bytes_ += series->bytes();
+    enforce_capacity();
+}
+
+void DatasetCache::enforce_capacity() {
+    // Always keep the most recent entry, even if it alone exceeds the budget.
+    while (resident_bytes_ > capacity_bytes_ && resident_.size() > 1) {
+        resident_bytes_ -= resident_.back()->bytes();
+        resident_.pop_back();
+    }
+    // Forget keys whose series nobody holds any more.
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        it = it->second.expired() ? entries_.erase(it) : std::next(it);
+    }
+}
+
+void DatasetCache::setCapacityBytes(size_t bytes) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_bytes_ = bytes;
+    enforce_capacity();
+}
+
+void DatasetCache::setSharedDirectory(const std::string& dir) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    shared_dir_ = dir;
+    if (!shared_dir_.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(shared_dir_, ec);
+    }
+}
+
+void DatasetCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    resident_.clear();
+    resident_bytes_ = 0;
+    enforce_capacity();
+}
+
+uint64_t DatasetCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+uint64_t DatasetCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
@@ -1,5 +1,6 @@
 #include "../../include/data/HFTDataHandler.h"
 #include "../../include/event/Event.h"
+#include "../../include/core/Checkpoint.h"
 #include <iostream>
 #include <sstream>
 #include <algorithm>
@@ -57,8 +58,8 @@ void HFTDataHandler::updateBars() {
         std::string trade_symbol = "";
         for (const auto& symbol : symbols_) {
             if (trade_indices_.count(symbol) && trade_indices_.at(symbol) < all_trades_.at(symbol).size()) {
-                if (all_trades_.at(symbol)[trade_indices_.at(symbol)].timestamp < earliest_trade_time) {
-                    earliest_trade_time = all_trades_.at(symbol)[trade_indices_.at(symbol)].timestamp;
+                if (all_trades_.at(symbol).timestamp(trade_indices_.at(symbol)) < earliest_trade_time) {
+                    earliest_trade_time = all_trades_.at(symbol).timestamp(trade_indices_.at(symbol));
                     trade_symbol = symbol;
                 }
             }
@@ -78,8 +79,11 @@ void HFTDataHandler::updateBars() {
         auto now = std::chrono::high_resolution_clock::now().time_since_epoch().count();
 
         if (!trade_symbol.empty() && (trade_symbol == book_symbol || earliest_trade_time <= earliest_book_time)) {
-            const auto& trade = all_trades_.at(trade_symbol)[trade_indices_.at(trade_symbol)++];
-            auto event = std::make_shared<TradeEvent>(trade.symbol, trade.timestamp, trade.price, trade.quantity, trade.aggressor_side);
+            const TradeSlice& trades = all_trades_.at(trade_symbol);
+            const size_t i = trade_indices_.at(trade_symbol)++;
+            update_bars_from_trade(trade_symbol, trades.timestamp(i), trades.price(i), trades.quantity(i));
+            auto event = std::make_shared<TradeEvent>(trade_symbol, trades.timestamp(i), trades.price(i), trades.quantity(i),
+                                                      trades.buyerAggressor(i) ? "BUY" : "SELL");
             event->timestamp_received = now;
             event_to_push = event;
         } else if (!book_symbol.empty()) {
@@ -112,22 +116,89 @@ bool HFTDataHandler::isFinished() const {
     return is_live_feed_ ? false : true;
 }
 
+void HFTDataHandler::update_bars_from_trade(const std::string& symbol, long long timestamp, double price, double quantity) {
+    TradeBars& state = trade_bars_[symbol];
+    const long long bar_open = timestamp - timestamp % BAR_INTERVAL_MS;
+    if (state.bars.empty() || bar_open > state.bar_open_time) {
+        Bar bar;
+        bar.symbol = symbol;
+        bar.timestamp = std::to_string(bar_open);
+        bar.open = bar.high = bar.low = price;
+        state.bars.push_back(bar);
+        if (state.bars.size() > BAR_HISTORY) {
+            state.bars.pop_front();
+        }
+        state.bar_open_time = bar_open;
+        state.volume = 0.0;
+    }
+    Bar& bar = state.bars.back();
+    bar.high = std::max(bar.high, price);
+    bar.low = std::min(bar.low, price);
+    bar.close = price;
+    state.volume += quantity;
+    bar.volume = static_cast<long long>(state.volume);
+}
+
 std::optional<Bar> HFTDataHandler::getLatestBar(const std::string& symbol) const {
-    // Bar construction logic from trades/order books would be needed here.
-    // This is a placeholder implementation.
-    return std::nullopt;
+    // Bars are built from the trades replayed so far, one per BAR_INTERVAL_MS.
+    std::lock_guard<Spinlock> lock(data_spinlock_);
+    auto it = trade_bars_.find(symbol);
+    if (it == trade_bars_.end() || it->second.bars.empty()) {
+        return std::nullopt;
+    }
+    return it->second.bars.back();
 }
 
 double HFTDataHandler::getLatestBarValue(const std::string& symbol, const std::string& val_type) {
-    // Bar construction logic would be needed here.
-    // This is a placeholder implementation.
+    auto bar = getLatestBar(symbol);
+    if (!bar) {
+        return 0.0;
+    }
+    if (val_type == "close" || val_type == "price") return bar->close;
+    if (val_type == "open") return bar->open;
+    if (val_type == "high") return bar->high;
+    if (val_type == "low") return bar->low;
+    if (val_type == "volume") return bar->volume;
     return 0.0;
 }
 
 std::vector<Bar> HFTDataHandler::getLatestBars(const std::string& symbol, int n) {
-    // Bar construction logic would be needed here.
-    // This is a placeholder implementation.
-    return {};
+    std::lock_guard<Spinlock> lock(data_spinlock_);
+    auto it = trade_bars_.find(symbol);
+    if (it == trade_bars_.end() || n <= 0) {
+        return {};
+    }
+    const auto& bars = it->second.bars;
+    size_t count = std::min(bars.size(), static_cast<size_t>(n));
+    return std::vector<Bar>(bars.end() - count, bars.end());
+}
+
+void HFTDataHandler::setTimeWindow(long long start_ms, long long end_ms) {
+    std::lock_guard<Spinlock> lock(data_spinlock_);
+    for (auto& [symbol, trades] : all_trades_) {
+        if (start_ms > 0) {
+            trades.begin = std::max(trades.begin, trades.series->lowerBound(start_ms));
+        }
+        if (end_ms > 0) {
+            trades.end = std::min(trades.end, trades.series->lowerBound(end_ms));
+        }
+        trades.end = std::max(trades.begin, trades.end);
+    }
+}
+
+std::pair<long long, long long> HFTDataHandler::timeSpan() const {
+    std::lock_guard<Spinlock> lock(data_spinlock_);
+    long long first = std::numeric_limits<long long>::max();
+    long long last = std::numeric_limits<long long>::min();
+    for (const auto& [symbol, trades] : all_trades_) {
+        if (trades.empty()) continue;
+        first = std::min(first, trades.timestamp(0));
+        last = std::max(last, trades.timestamp(trades.size() - 1));
+    }
+    if (first > last) {
+        return {0, 0};
+    }
+    return {first, last};
 }
 
 void HFTDataHandler::connectLiveFeed() {
@@ -185,36 +256,100 @@ void HFTDataHandler::fallbackToHistoricalData() {
     }
 }
 
+std::string HFTDataHandler::tradeFilePath(const std::string& dir, const std::string& symbol) {
+    return dir + "/" + symbol + "-trades.csv"; // Assuming a naming convention
+}
+
 bool HFTDataHandler::load_data(const std::string& symbol, const std::string& dir, const std::string& start_date, const std::string& end_date) {
-    std::string filepath = dir + "/" + symbol + "-trades.csv"; // Assuming a naming convention
-    std::ifstream file(filepath);
-    if (!file.is_open()) {
+    std::string filepath = tradeFilePath(dir, symbol);
+    // Parsed once per process and shared; repeated runs only get a new cursor.
+    TradeSlice trades = DatasetCache::instance().trades(symbol, filepath, start_date, end_date);
+    if (!trades.series) {
         std::cerr << "Warning: Could not open historical data file for " << symbol << " at " << filepath << std::endl;
         return false;
     }
+    all_trades_[symbol] = std::move(trades);
+    trade_indices_[symbol] = 0;
+    return true;
+}
+
+
+void HFTDataHandler::saveState(StateWriter& out) const {
+    std::lock_guard<Spinlock> lock(data_spinlock_);
+    out.put<uint64_t>(symbols_.size());
+    for (const auto& symbol : symbols_) {
+        out.put(symbol);
+        auto trades = all_trades_.find(symbol);
+        out.put<uint64_t>(trades != all_trades_.end() ? trades->second.size() : 0);
+        auto trade_index = trade_indices_.find(symbol);
+        out.put<uint64_t>(trade_index != trade_indices_.end() ? trade_index->second : 0);
+        auto book_index = orderbook_indices_.find(symbol);
+        out.put<uint64_t>(book_index != orderbook_indices_.end() ? book_index->second : 0);
 
-    std::string line;
-    getline(file, line); // Skip header
+        auto bars = trade_bars_.find(symbol);
+        const TradeBars empty_bars;
+        const TradeBars& state = bars != trade_bars_.end() ? bars->second : empty_bars;
+        // Only the tail getLatestBars() can return is worth saving.
+        const size_t kept = std::min(state.bars.size(), BAR_HISTORY);
+        out.put<uint64_t>(kept);
+        for (auto bar = state.bars.end() - kept; bar != state.bars.end(); ++bar) {
+            out.put(*bar);
+        }
+        out.put(state.bar_open_time);
+        out.put(state.volume);
 
-    while (getline(file, line)) {
-        std::stringstream ss(line);
-        std::string item;
-        Trade trade;
-        trade.symbol = symbol;
-        int i = 0;
-        while(std::getline(ss, item, ',')) {
-            if (i == 0) trade.timestamp = std::stoll(item);
-            else if (i == 1) trade.price = std::stod(item);
-            else if (i == 2) trade.quantity = std::stod(item);
-            else if (i == 3) trade.aggressor_side = item;
-            i++;
+        auto book = latest_orderbooks_.find(symbol);
+        out.put(book != latest_orderbooks_.end());
+        if (book != latest_orderbooks_.end()) {
+            out.put(book->second);
         }
-        all_trades_[symbol].push_back(trade);
     }
-    trade_indices_[symbol] = 0;
-    return true;
 }
 
+void HFTDataHandler::loadState(StateReader& in) {
+    std::lock_guard<Spinlock> lock(data_spinlock_);
+    const size_t count = in.getSize();
+    if (count != symbols_.size()) {
+        throw std::runtime_error("Checkpoint: data cursor was saved for a different symbol list");
+    }
+    for (size_t s = 0; s < count; ++s) {
+        const std::string symbol = in.getString();
+        if (symbol != symbols_[s]) {
+            throw std::runtime_error("Checkpoint: data cursor was saved for a different symbol list");
+        }
+        const auto trade_count = in.get<uint64_t>();
+        const auto trade_index = in.get<uint64_t>();
+        const auto book_index = in.get<uint64_t>();
+        auto trades = all_trades_.find(symbol);
+        const size_t available = trades != all_trades_.end() ? trades->second.size() : 0;
+        if (trade_count != available || trade_index > available) {
+            throw std::runtime_error("Checkpoint: trade data for " + symbol + " has changed since the checkpoint");
+        }
+        if (trades != all_trades_.end()) {
+            trade_indices_[symbol] = trade_index;
+        }
+        if (orderbook_indices_.count(symbol)) {
+            orderbook_indices_[symbol] = book_index;
+        }
+
+        TradeBars& state = trade_bars_[symbol];
+        state.bars.clear();
+        for (size_t b = in.getSize(); b > 0; --b) {
+            state.bars.push_back(in.getBar());
+            if (state.bars.size() > BAR_HISTORY) {
+                state.bars.pop_front();
+            }
+        }
+        state.bar_open_time = in.get<long long>();
+        state.volume = in.get<double>();
+
+        if (in.get<uint8_t>()) {
+            latest_orderbooks_[symbol] = in.getOrderBook();
+        } else {
+            latest_orderbooks_.erase(symbol);
+        }
+    }
+}
 
 std::optional<OrderBook> HFTDataHandler::getLatestOrderBook(const std::string& symbol) const {
     std::lock_guard<Spinlock> lock(data_spinlock_);
@@ -0,0 +1,167 @@
+#include "../../include/data/JournalDataHandler.h"
+#include <algorithm>
+#include <iostream>
+
+JournalDataHandler::JournalDataHandler(std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> event_queue,
+                                       const std::vector<std::string>& symbols,
+                                       const std::string& journal_path,
+                                       long long bar_interval_ms)
+    : event_queue_(std::move(event_queue)),
+      symbols_(symbols),
+      reader_(journal_path),
+      bar_interval_ms_(bar_interval_ms) {
+    for (const auto& symbol : symbols_) {
+        states_[symbol];
+    }
+    std::cout << "Replaying market data journal " << journal_path << std::endl;
+}
+
+const std::string* JournalDataHandler::find_symbol(std::string_view symbol) const {
+    for (const auto& s : symbols_) {
+        if (s == symbol) {
+            return &s;
+        }
+    }
+    return nullptr;
+}
+
+void JournalDataHandler::updateBars() {
+    // Advance to the next record that produces an event for one of our symbols.
+    JournalRecord record;
+    while (!pending_event_) {
+        if (!reader_.next(record)) {
+            finished_ = true;
+            return;
+        }
+        if (record.kind != JournalRecordKind::BINANCE_RAW) continue;
+        receive_time_ms_ = record.receive_time_ns / 1000000;
+        parse_binance_message(record.payload.data(), record.payload.size(), *this);
+    }
+
+    event_queue_->push(std::make_shared<std::shared_ptr<Event>>(std::move(pending_event_)));
+    pending_event_.reset();
+    if (on_new_data_) {
+        on_new_data_();
+    }
+}
+
+bool JournalDataHandler::isFinished() const {
+    return finished_;
+}
+
+void JournalDataHandler::onDepthBegin(const BinanceDepthHeader& header) {
+    depth_symbol_ = find_symbol(header.symbol);
+    if (!depth_symbol_) {
+        depth_state_ = nullptr;
+        return;
+    }
+    depth_state_ = &states_[*depth_symbol_];
+    depth_state_->book_timestamp = receive_time_ms_;
+    // Same event the live handler builds: the update's levels, receive time in ms
+    depth_event_ = std::make_shared<OrderBookEvent>(*depth_symbol_, receive_time_ms_);
+}
+
+void JournalDataHandler::onBidLevel(double price, double quantity) {
+    if (!depth_state_) return;
+    if (quantity > 0) {
+        depth_state_->bids[price] = quantity;
+        depth_event_->addBidLevel(price, quantity);
+    } else {
+        depth_state_->bids.erase(price);
+    }
+}
+
+void JournalDataHandler::onAskLevel(double price, double quantity) {
+    if (!depth_state_) return;
+    if (quantity > 0) {
+        depth_state_->asks[price] = quantity;
+        depth_event_->addAskLevel(price, quantity);
+    } else {
+        depth_state_->asks.erase(price);
+    }
+}
+
+void JournalDataHandler::onDepthEnd() {
+    if (!depth_state_) return;
+    pending_event_ = std::move(depth_event_);
+    depth_state_ = nullptr;
+}
+
+void JournalDataHandler::onTrade(const BinanceTrade& trade) {
+    const std::string* symbol = find_symbol(trade.symbol);
+    if (!symbol) return;
+
+    SymbolState& state = states_[*symbol];
+    const long long bar_open = trade.trade_time - trade.trade_time % bar_interval_ms_;
+    if (state.bars.empty() || bar_open > state.bar_open_time) {
+        Bar bar;
+        bar.symbol = *symbol;
+        bar.timestamp = std::to_string(bar_open);
+        bar.open = bar.high = bar.low = trade.price;
+        state.bars.push_back(bar);
+        if (state.bars.size() > BAR_HISTORY) {
+            state.bars.pop_front();
+        }
+        state.bar_open_time = bar_open;
+        state.bar_volume = 0.0;
+    }
+    Bar& bar = state.bars.back();
+    bar.high = std::max(bar.high, trade.price);
+    bar.low = std::min(bar.low, trade.price);
+    bar.close = trade.price;
+    state.bar_volume += trade.quantity;
+    bar.volume = static_cast<long long>(state.bar_volume);
+
+    // Stamped with the receive time like the book updates, so both streams
+    // share one time base (bars still bucket by the exchange's trade time).
+    pending_event_ = std::make_shared<TradeEvent>(*symbol, receive_time_ms_, trade.price, trade.quantity,
+                                                  trade.buyer_is_maker ? "SELL" : "BUY");
+}
+
+std::optional<Bar> JournalDataHandler::getLatestBar(const std::string& symbol) const {
+    auto it = states_.find(symbol);
+    if (it == states_.end() || it->second.bars.empty()) {
+        return std::nullopt;
+    }
+    return it->second.bars.back();
+}
+
+double JournalDataHandler::getLatestBarValue(const std::string& symbol, const std::string& val_type) {
+    auto bar = getLatestBar(symbol);
+    if (!bar) {
+        return 0.0;
+    }
+    if (val_type == "close" || val_type == "price") return bar->close;
+    if (val_type == "open") return bar->open;
+    if (val_type == "high") return bar->high;
+    if (val_type == "low") return bar->low;
+    if (val_type == "volume") return bar->volume;
+    return 0.0;
+}
+
+std::vector<Bar> JournalDataHandler::getLatestBars(const std::string& symbol, int n) {
+    auto it = states_.find(symbol);
+    if (it == states_.end() || n <= 0) {
+        return {};
+    }
+    const auto& bars = it->second.bars;
+    size_t count = std::min(bars.size(), static_cast<size_t>(n));
+    return std::vector<Bar>(bars.end() - static_cast<std::ptrdiff_t>(count), bars.end());
+}
+
+std::optional<OrderBook> JournalDataHandler::getLatestOrderBook(const std::string& symbol) const {
+    auto it = states_.find(symbol);
+    if (it == states_.end() || it->second.book_timestamp == 0) {
+        return std::nullopt;
+    }
+    OrderBook book;
+    book.symbol = symbol;
+    book.timestamp = it->second.book_timestamp;
+    book.bids.assign(it->second.bids.begin(), it->second.bids.end());
+    book.asks.assign(it->second.asks.begin(), it->second.asks.end());
+    return book;
+}
+
+const std::vector<std::string>& JournalDataHandler::getSymbols() const {
+    return symbols_;
+}
@@ -0,0 +1,230 @@
+#include "../../include/data/MarketDataJournal.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+namespace {
+
+constexpr uint32_t RING_WRAP_MARKER = 0xFFFFFFFF;
+constexpr size_t MAP_GRANULARITY = 64 * 1024; // Windows allocation granularity; a multiple of the page size elsewhere
+
+size_t align8(size_t n) {
+    return (n + 7) & ~static_cast<size_t>(7);
+}
+
+size_t round_up_pow2(size_t n) {
+    size_t p = 1;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+} // namespace
+
+MarketDataJournalWriter::MarketDataJournalWriter(const std::string& path, size_t staging_bytes, size_t segment_bytes)
+    : path_(path),
+      segment_bytes_(std::max(segment_bytes, MAP_GRANULARITY)),
+      ring_size_(round_up_pow2(std::max<size_t>(staging_bytes, 4096))) {
+    ring_.reset(new char[ring_size_]);
+
+    JournalFileHeader header{};
+    header.magic = JOURNAL_MAGIC;
+    header.version = JOURNAL_VERSION;
+    header.created_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    {
+        std::ofstream out(path_, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw std::runtime_error("Could not create journal: " + path_);
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    }
+    file_size_ = sizeof(header);
+    written_ = sizeof(header);
+    map_segment(0);
+
+    writer_ = std::thread(&MarketDataJournalWriter::writer_loop, this);
+}
+
+MarketDataJournalWriter::~MarketDataJournalWriter() {
+    close();
+}
+
+bool MarketDataJournalWriter::append(const char* data, size_t size, int64_t receive_time_ns, JournalRecordKind kind) {
+    if (size == 0) return true; // Nothing to keep; a zero length marks the end of the journal
+    const uint64_t sequence = next_sequence_++;
+    const size_t entry = align8(sizeof(JournalRecordHeader) + size);
+    if (!running_.load(std::memory_order_relaxed) || entry > ring_size_ / 2) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    uint64_t head = ring_head_.load(std::memory_order_relaxed);
+    const uint64_t tail = ring_tail_.load(std::memory_order_acquire);
+    size_t offset = head & (ring_size_ - 1);
+    const size_t to_end = ring_size_ - offset;
+    const size_t needed = entry <= to_end ? entry : to_end + entry;
+    if (ring_size_ - (head - tail) < needed) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    if (entry > to_end) {
+        // Not enough room before the end of the ring: mark the rest as skipped.
+        std::memcpy(ring_.get() + offset, &RING_WRAP_MARKER, sizeof(RING_WRAP_MARKER));
+        head += to_end;
+        offset = 0;
+    }
+
+    JournalRecordHeader header{};
+    header.length = static_cast<uint32_t>(size);
+    header.kind = static_cast<uint16_t>(kind);
+    header.sequence = sequence;
+    header.receive_time_ns = receive_time_ns;
+    char* slot = ring_.get() + offset;
+    std::memcpy(slot, &header, sizeof(header));
+    std::memcpy(slot + sizeof(header), data, size);
+    std::memset(slot + sizeof(header) + size, 0, entry - sizeof(header) - size);
+    ring_head_.store(head + entry, std::memory_order_release);
+
+    // Only the first record since the last drain pays for the notify.
+    if (!pending_.exchange(true, std::memory_order_acq_rel)) {
+        wake_cond_.notify_one();
+    }
+    return true;
+}
+
+void MarketDataJournalWriter::close() {
+    if (!running_.exchange(false)) return;
+    wake_cond_.notify_all();
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+
+    map_.unmap();
+    std::error_code ec;
+    std::filesystem::resize_file(path_, written_, ec);
+    if (ec) {
+        std::cerr << "Could not trim journal " << path_ << ": " << ec.message() << std::endl;
+    }
+    std::cout << "Journal " << path_ << " closed: " << recorded() << " messages recorded, "
+              << dropped() << " dropped." << std::endl;
+}
+
+void MarketDataJournalWriter::writer_loop() {
+    try {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(wake_mutex_);
+                wake_cond_.wait_for(lock, std::chrono::milliseconds(100), [&] {
+                    return pending_.load() || !running_.load();
+                });
+            }
+            pending_.store(false, std::memory_order_release);
+
+            bool stopping = !running_.load();
+            while (drain()) {}
+            if (stopping) break;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Journal writer stopped: " << e.what() << std::endl;
+        running_ = false;
+    }
+}
+
+bool MarketDataJournalWriter::drain() {
+    uint64_t tail = ring_tail_.load(std::memory_order_relaxed);
+    const uint64_t head = ring_head_.load(std::memory_order_acquire);
+    if (tail == head) return false;
+
+    while (tail != head) {
+        const size_t offset = tail & (ring_size_ - 1);
+        uint32_t length;
+        std::memcpy(&length, ring_.get() + offset, sizeof(length));
+        if (length == RING_WRAP_MARKER) {
+            tail += ring_size_ - offset;
+            continue;
+        }
+        const size_t entry = align8(sizeof(JournalRecordHeader) + length);
+        write_bytes(ring_.get() + offset, entry);
+        tail += entry;
+        recorded_.fetch_add(1, std::memory_order_relaxed);
+        ring_tail_.store(tail, std::memory_order_release);
+    }
+    ring_tail_.store(tail, std::memory_order_release);
+    return true;
+}
+
+void MarketDataJournalWriter::write_bytes(const char* data, size_t size) {
+    if (written_ + size > map_offset_ + map_.size()) {
+        map_segment(size);
+    }
+    std::memcpy(map_.data() + (written_ - map_offset_), data, size);
+    written_ += size;
+}
+
+void MarketDataJournalWriter::map_segment(size_t min_bytes) {
+    map_.unmap();
+
+    // Grow the file by a segment and map from the current write position
+    // (rounded down to the mapping granularity) to the new end.
+    file_size_ = written_ + std::max(segment_bytes_, min_bytes + MAP_GRANULARITY);
+    std::filesystem::resize_file(path_, file_size_);
+    map_offset_ = written_ & ~(MAP_GRANULARITY - 1);
+
+    std::error_code ec;
+    map_.map(path_, map_offset_, file_size_ - map_offset_, ec);
+    if (ec) {
+        throw std::runtime_error("Could not map journal " + path_ + ": " + ec.message());
+    }
+}
+
+MarketDataJournalReader::MarketDataJournalReader(const std::string& path) {
+    std::error_code ec;
+    map_.map(path, ec);
+    if (ec) {
+        throw std::runtime_error("Could not map journal: " + path + " (" + ec.message() + ")");
+    }
+    if (map_.size() < sizeof(JournalFileHeader)) {
+        throw std::runtime_error("Journal is truncated: " + path);
+    }
+
+    JournalFileHeader header;
+    std::memcpy(&header, map_.data(), sizeof(header));
+    if (header.magic != JOURNAL_MAGIC) {
+        throw std::runtime_error("Not a market data journal (bad magic): " + path);
+    }
+    if (header.version != JOURNAL_VERSION) {
+        throw std::runtime_error("Unsupported journal version " + std::to_string(header.version) + ": " + path);
+    }
+    created_ns_ = header.created_ns;
+}
+
+bool MarketDataJournalReader::next(JournalRecord& record) {
+    if (position_ + sizeof(JournalRecordHeader) > map_.size()) {
+        return false;
+    }
+    JournalRecordHeader header;
+    std::memcpy(&header, map_.data() + position_, sizeof(header));
+    // A zero length is the unwritten tail of a journal that was not closed cleanly.
+    if (header.length == 0 || position_ + sizeof(header) + header.length > map_.size()) {
+        return false;
+    }
+
+    record.sequence = header.sequence;
+    record.receive_time_ns = header.receive_time_ns;
+    record.kind = static_cast<JournalRecordKind>(header.kind);
+    record.payload = std::string_view(map_.data() + position_ + sizeof(header), header.length);
+    position_ += align8(sizeof(header) + header.length);
+    return true;
+}
+
+bool MarketDataJournalReader::isJournal(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    uint32_t magic = 0;
+    in.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+    return in && magic == JOURNAL_MAGIC;
+}
@@ -0,0 +1,104 @@
+#include "../../include/data/SnapshotDataHandler.h"
+#include "../../include/event/OrderBookEvent.h"
+#include <algorithm>
+
+namespace {
+
+// Symbol of a market data event, or nullptr for any other event.
+const std::string* market_symbol(const Event& event) {
+    switch (event.type) {
+        case EventType::MARKET:
+            return &static_cast<const MarketEvent&>(event).symbol;
+        case EventType::TRADE:
+            return &static_cast<const TradeEvent&>(event).symbol;
+        case EventType::ORDER_BOOK:
+            return &static_cast<const OrderBookEvent&>(event).symbol_;
+        default:
+            return nullptr;
+    }
+}
+
+} // namespace
+
+SnapshotDataHandler::SnapshotDataHandler(const std::vector<std::string>& symbols)
+    : symbols_(symbols) {}
+
+std::vector<MarketSnapshot> SnapshotDataHandler::capture(DataHandler& source,
+                                                         const std::vector<std::shared_ptr<Event>>& events) {
+    std::vector<MarketSnapshot> snapshots;
+    for (const auto& event : events) {
+        const std::string* symbol = market_symbol(*event);
+        if (!symbol) {
+            continue;
+        }
+        auto it = std::find_if(snapshots.begin(), snapshots.end(),
+                               [&](const MarketSnapshot& s) { return s.symbol == *symbol; });
+        if (it == snapshots.end()) {
+            snapshots.push_back({*symbol, source.getLatestBar(*symbol), std::nullopt});
+            it = snapshots.end() - 1;
+        }
+        if (event->type == EventType::ORDER_BOOK && !it->book) {
+            it->book = source.getLatestOrderBook(*symbol);
+        }
+    }
+    return snapshots;
+}
+
+void SnapshotDataHandler::apply(const std::vector<MarketSnapshot>& snapshots) {
+    for (const auto& snapshot : snapshots) {
+        SymbolState& state = states_[snapshot.symbol];
+        if (snapshot.bar) {
+            // A bar keeps its open time while it forms, so a new time means a new bar.
+            if (state.bars.empty() || state.bars.back().timestamp != snapshot.bar->timestamp) {
+                state.bars.push_back(*snapshot.bar);
+                if (state.bars.size() > BAR_HISTORY) {
+                    state.bars.pop_front();
+                }
+            } else {
+                state.bars.back() = *snapshot.bar;
+            }
+        }
+        if (snapshot.book) {
+            state.book = snapshot.book;
+        }
+    }
+}
+
+std::optional<Bar> SnapshotDataHandler::getLatestBar(const std::string& symbol) const {
+    auto it = states_.find(symbol);
+    if (it == states_.end() || it->second.bars.empty()) {
+        return std::nullopt;
+    }
+    return it->second.bars.back();
+}
+
+double SnapshotDataHandler::getLatestBarValue(const std::string& symbol, const std::string& val_type) {
+    auto bar = getLatestBar(symbol);
+    if (!bar) {
+        return 0.0;
+    }
+    if (val_type == "close" || val_type == "price") return bar->close;
+    if (val_type == "open") return bar->open;
+    if (val_type == "high") return bar->high;
+    if (val_type == "low") return bar->low;
+    if (val_type == "volume") return bar->volume;
+    return 0.0;
+}
+
+std::vector<Bar> SnapshotDataHandler::getLatestBars(const std::string& symbol, int n) {
+    auto it = states_.find(symbol);
+    if (it == states_.end() || n <= 0) {
+        return {};
+    }
+    const auto& bars = it->second.bars;
+    size_t count = std::min(bars.size(), static_cast<size_t>(n));
+    return std::vector<Bar>(bars.end() - count, bars.end());
+}
+
+std::optional<OrderBook> SnapshotDataHandler::getLatestOrderBook(const std::string& symbol) const {
+    auto it = states_.find(symbol);
+    if (it == states_.end()) {
+        return std::nullopt;
+    }
+    return it->second.book;
+}
@@ -1,5 +1,7 @@
 #include "../../include/data/WebSocketDataHandler.h"
+#include "../../include/core/AsyncLogger.h"
 #include <nlohmann/json.hpp>
+#include <algorithm>
 #include <iostream>
 #include <chrono>
 #include <iomanip>
@@ -11,6 +13,8 @@
 #pragma warning(disable: 4996)
 #endif
 
+static const LogComponent kLog("WebSocket");
+
 // Helper function to report errors
 void fail(beast::error_code ec, char const* what) {
     std::cerr << what << ": " << ec.message() << "\n";
@@ -21,22 +25,26 @@ WebSocketDataHandler::WebSocketDataHandler(
     const std::vector<std::string>& symbols,
     const std::string& host,
     const std::string& port,
-    const std::string& target)
+    const std::string& target,
+    bool tls_verify,
+    bool tls)
     : event_queue_(std::move(event_queue)),
       symbols_(symbols),
       host_(host),
       port_(port),
       target_(target),
       resolver_(ioc_),
-      ws_(ioc_, ctx_)
+      tls_(tls),
+      ws_(ioc_, ctx_),
+      plain_ws_(ioc_)
 {
     // Initialize SSL context
     ctx_.set_default_verify_paths();
-    ctx_.set_verify_mode(ssl::verify_peer);
+    ctx_.set_verify_mode(tls_verify ? ssl::verify_peer : ssl::verify_none);
     
     // Initialize data structures for each symbol
     for (const auto& symbol : symbols_) {
-        latest_bars_map_[symbol] = Bar{};
+        symbol_slots_[symbol] = std::make_unique<SymbolSlot>();
         trade_counts_[symbol] = 0;
     }
     
@@ -73,7 +81,7 @@ void WebSocketDataHandler::connect() {
         {"id", 1}
     }).dump();
     
-    std::cout << "Connecting to WebSocket at " << host_ << ":" << port_ << target_ << std::endl;
+    std::cout << "Connecting to WebSocket at " << (tls_ ? "wss://" : "ws://") << host_ << ":" << port_ << target_ << std::endl;
     
     // Resolve the host name and run the I/O context
     resolver_.async_resolve(
@@ -87,13 +95,18 @@ void WebSocketDataHandler::connect() {
     ioc_thread_ = std::thread([this]() { ioc_.run(); });
 }
 
+void WebSocketDataHandler::enableJournal(const std::string& path) {
+    journal_ = std::make_unique<MarketDataJournalWriter>(path);
+    std::cout << "Recording market data journal to " << path << std::endl;
+}
+
 void WebSocketDataHandler::stop() {
     std::cout << "Stopping WebSocket connection..." << std::endl;
     
     try {
         // Cancel any outstanding operations
         beast::error_code ec;
-        ws_.close(websocket::close_code::normal, ec);
+        with_stream([&](auto& ws) { ws.close(websocket::close_code::normal, ec); });
         
         // Stop the I/O context
         ioc_.stop();
@@ -108,6 +121,11 @@ void WebSocketDataHandler::stop() {
 
     }
     
+    // The read loop has stopped, so everything received is staged by now
+    if (journal_) {
+        journal_->close();
+    }
+    
     finished_ = true;
     std::cout << "WebSocket connection stopped." << std::endl;
 }
@@ -123,7 +141,7 @@ void WebSocketDataHandler::on_resolve(beast::error_code ec, tcp::resolver::resul
     }
 
     // Set SNI Hostname (many hosts need this to handshake successfully)
-    if(!SSL_set_tlsext_host_name(ws_.next_layer().native_handle(), host_.c_str())) {
+    if(tls_ && !SSL_set_tlsext_host_name(ws_.next_layer().native_handle(), host_.c_str())) {
         ec = beast::error_code(static_cast<int>(::ERR_get_error()),
             net::error::get_ssl_category());
         fail(ec, "set SNI Hostname");
@@ -131,11 +149,13 @@ void WebSocketDataHandler::on_resolve(beast::error_code ec, tcp::resolver::resul
     }
 
     // Make the connection on the IP address we get from a lookup
-    beast::get_lowest_layer(ws_).async_connect(
-        results,
-        beast::bind_front_handler(
-            &WebSocketDataHandler::on_connect,
-            shared_from_this()));
+    with_stream([&](auto& ws) {
+        beast::get_lowest_layer(ws).async_connect(
+            results,
+            beast::bind_front_handler(
+                &WebSocketDataHandler::on_connect,
+                shared_from_this()));
+    });
 }
 
 void WebSocketDataHandler::on_connect(beast::error_code ec, tcp::resolver::results_type::endpoint_type) {
@@ -144,6 +164,11 @@ void WebSocketDataHandler::on_connect(beast::error_code ec, tcp::resolver::resul
         return;
     }
 
+    if (!tls_) {
+        on_ssl_handshake(ec);
+        return;
+    }
+
     // Perform the SSL handshake
     ws_.next_layer().async_handshake(
         ssl::stream_base::client,
@@ -158,34 +183,25 @@ void WebSocketDataHandler::on_ssl_handshake(beast::error_code ec) {
         return;
     }
 
-    beast::get_lowest_layer(ws_).expires_never();
-
-    ws_.set_option(
-        websocket::stream_base::timeout::suggested(
-            beast::role_type::client));
-
-    ws_.set_option(websocket::stream_base::decorator(
-        [](websocket::request_type& req) {
-            req.set(http::field::user_agent,
-                std::string(BOOST_BEAST_VERSION_STRING) +
-                    " websocket-client-cpp");
-        }));
+    with_stream([&](auto& ws) {
+        beast::get_lowest_layer(ws).expires_never();
 
-    // Set suggested timeout settings for the websocket
-    ws_.set_option(websocket::stream_base::timeout::suggested(beast::role_type::client));
+        // Set suggested timeout settings for the websocket
+        ws.set_option(websocket::stream_base::timeout::suggested(beast::role_type::client));
 
-    // Set a decorator to change the User-Agent of the handshake
-    ws_.set_option(websocket::stream_base::decorator(
-        [](websocket::request_type& req) {
-            req.set(http::field::user_agent, 
-                std::string(BOOST_BEAST_VERSION_STRING) + " websocket-client-async");
-        }));
+        // Set a decorator to change the User-Agent of the handshake
+        ws.set_option(websocket::stream_base::decorator(
+            [](websocket::request_type& req) {
+                req.set(http::field::user_agent, 
+                    std::string(BOOST_BEAST_VERSION_STRING) + " websocket-client-async");
+            }));
 
-    // Perform the websocket handshake
-    ws_.async_handshake(host_, target_,
-        beast::bind_front_handler(
-            &WebSocketDataHandler::on_handshake,
-            shared_from_this()));
+        // Perform the websocket handshake
+        ws.async_handshake(host_, target_,
+            beast::bind_front_handler(
+                &WebSocketDataHandler::on_handshake,
+                shared_from_this()));
+    });
 }
 
 void WebSocketDataHandler::on_handshake(beast::error_code ec) {
@@ -196,12 +212,15 @@ void WebSocketDataHandler::on_handshake(beast::error_code ec) {
 
     std::cout << "WebSocket handshake successful. Connected to " << host_ << target_ << std::endl;
 
-    // Start reading
-    ws_.async_read(
-        buffer_,
-        beast::bind_front_handler(
-            &WebSocketDataHandler::on_read,
-            shared_from_this()));
+    // Subscribe to the depth and trade streams; on_write starts the read loop
+    with_stream([&](auto& ws) {
+        ws.text(true);
+        ws.async_write(
+            net::buffer(subscribe_message_),
+            beast::bind_front_handler(
+                &WebSocketDataHandler::on_write,
+                shared_from_this()));
+    });
 }
 
 void WebSocketDataHandler::on_write(beast::error_code ec, std::size_t) {
@@ -210,12 +229,18 @@ void WebSocketDataHandler::on_write(beast::error_code ec, std::size_t) {
         return;
     }
 
+    read_next();
+}
+
+void WebSocketDataHandler::read_next() {
     // Read a message into our buffer
-    ws_.async_read(
-        buffer_,
-        beast::bind_front_handler(
-            &WebSocketDataHandler::on_read,
-            shared_from_this()));
+    with_stream([&](auto& ws) {
+        ws.async_read(
+            buffer_,
+            beast::bind_front_handler(
+                &WebSocketDataHandler::on_read,
+                shared_from_this()));
+    });
 }
 
 void WebSocketDataHandler::on_read(beast::error_code ec, std::size_t bytes_transferred) {
@@ -225,32 +250,25 @@ void WebSocketDataHandler::on_read(beast::error_code ec, std::size_t bytes_trans
     }
     
     try {
-        // Get message as string
-        std::string msg = boost::beast::buffers_to_string(buffer_.data());
+        // Parse the frame in place; flat_buffer always holds it contiguously.
+        auto frame = buffer_.cdata();
+        int64_t receive_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+        receive_stamp_ = std::chrono::high_resolution_clock::now().time_since_epoch().count();
+        process_message(static_cast<const char*>(frame.data()), frame.size(), receive_time_ns);
         
         // Clear buffer for next read
         buffer_.consume(buffer_.size());
         
-        // Process the message
-        process_message(msg);
-        
         // Continue reading
-        ws_.async_read(
-            buffer_,
-            beast::bind_front_handler(
-                &WebSocketDataHandler::on_read,
-                shared_from_this()));
+        read_next();
     } 
     catch(const std::exception& e) {
-        std::cerr << "Exception in on_read: " << e.what() << std::endl;
+        LOG_ERROR(kLog, "Exception in on_read: {}", e.what());
         
         // Try to continue reading despite errors
         buffer_.consume(buffer_.size());
-        ws_.async_read(
-            buffer_,
-            beast::bind_front_handler(
-                &WebSocketDataHandler::on_read,
-                shared_from_this()));
+        read_next();
     }
 
 }
@@ -264,180 +282,152 @@ void WebSocketDataHandler::on_close(beast::error_code ec) {
     std::cout << "WebSocket connection closed gracefully" << std::endl;
 }
 
-void WebSocketDataHandler::process_message(const std::string& message) {
-    try {
+void WebSocketDataHandler::process_message(const char* data, std::size_t size, int64_t receive_time_ns) {
+    if (journal_) {
+        journal_->append(data, size, receive_time_ns);
+    }
+    receive_time_ms_ = receive_time_ns / 1000000;
+    if (parse_binance_message(data, size, *this) == BinanceMessageType::MALFORMED) {
+        LOG_WARN(kLog, "Malformed market data message: {}", std::string_view(data, std::min<std::size_t>(size, 200)));
+    }
+}
 
-        // Parse JSON message
-        nlohmann::json j = nlohmann::json::parse(message);
-        
-        // Check if this is a depth update message
-        if (j.contains("e")) {
-            std::string event_type = j["e"];
-            
-            // Process depth update (order book)
-            if (event_type == "depthUpdate" && j.contains("s")) {
-                std::string symbol = j["s"];
-                
-                auto now = std::chrono::system_clock::now();
-                auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-                    now.time_since_epoch()).count();
-                
-                // Create the order book event
-                auto orderbook = std::make_shared<OrderBookEvent>(
-                    symbol,
-                    timestamp
-                );
-                
-                // Process bids
-                if (j.contains("b")) {
-                    for (const auto& bid : j["b"]) {
-                        if (bid.size() >= 2) {
-                            try {
-                                // Handle both string and number formats safely
-                                double price = 0.0;
-                                double quantity = 0.0;
-                                
-                                // Parse price
-                                if (bid[0].is_string()) {
-                                    price = std::stod(bid[0].get<std::string>());
-                                } else if (bid[0].is_number()) {
-                                    price = bid[0].get<double>();
-                                }
-                                
-                                // Parse quantity
-                                if (bid[1].is_string()) {
-                                    quantity = std::stod(bid[1].get<std::string>());
-                                } else if (bid[1].is_number()) {
-                                    quantity = bid[1].get<double>();
-                                }
-                                
-                                // Only process non-zero quantities
-                                if (quantity > 0) {
-                                    // Update stored order book
-                                    auto& stored_book = orderbooks_[symbol];
-                                    stored_book.bids[price] = std::make_pair(price, quantity);
-                                    
-                                    // Add to the orderbook event object
-                                    orderbook->addBidLevel(price, quantity);
-                                } else {
-                                    // Remove price level with zero quantity
-                                    orderbooks_[symbol].bids.erase(price);
-                                }
-                            } catch (const std::exception& e) {
-                                std::cerr << "Error processing bid: " << e.what() << std::endl;
-                            }
-                        }
-                    }
-                }
-                
-                // Process asks
-                if (j.contains("a")) {
-                    for (const auto& ask : j["a"]) {
-                        if (ask.size() >= 2) {
-                            try {
-                                // Handle both string and number formats safely
-                                double price = 0.0;
-                                double quantity = 0.0;
-                                
-                                // Parse price
-                                if (ask[0].is_string()) {
-                                    price = std::stod(ask[0].get<std::string>());
-                                } else if (ask[0].is_number()) {
-                                    price = ask[0].get<double>();
-                                }
-                                
-                                // Parse quantity
-                                if (ask[1].is_string()) {
-                                    quantity = std::stod(ask[1].get<std::string>());
-                                } else if (ask[1].is_number()) {
-                                    quantity = ask[1].get<double>();
-                                }
-                                
-                                // Only process non-zero quantities
-                                if (quantity > 0) {
-                                    // Update stored order book
-                                    auto& stored_book = orderbooks_[symbol];
-                                    stored_book.asks[price] = std::make_pair(price, quantity);
-                                    
-                                    // Add to the orderbook event object
-                                    orderbook->addAskLevel(price, quantity);
-                                } else {
-                                    // Remove price level with zero quantity
-                                    orderbooks_[symbol].asks.erase(price);
-                                }
-                            } catch (const std::exception& e) {
-                                std::cerr << "Error processing ask: " << e.what() << std::endl;
-                            }
-                        }
-                    }
-                }
-                
-                // Update latest_orderbooks_
-                std::vector<std::pair<double, double>> bidVec;
-                for (const auto& [price, level] : orderbooks_[symbol].bids) {
-                    bidVec.push_back(level);
-                }
-
-                std::vector<std::pair<double, double>> askVec;
-                for (const auto& [price, level] : orderbooks_[symbol].asks) {
-                    askVec.push_back(level);
-                }
-
-                latest_orderbooks_[symbol] = OrderBook{
-                    symbol,
-                    timestamp,
-                    bidVec,
-                    askVec
-                };
-                
-                // Print a more useful order book summary showing some prices
-                std::cout << "ORDER BOOK: " << symbol << " | Timestamp: " << timestamp << std::endl;
-                std::cout << "  Bids: " << orderbook->getBidLevels().size() << " levels";
-                
-                // Show top 3 bids if available
-                const auto& bids = orderbook->getBidLevels();
-                if (!bids.empty()) {
-                    std::cout << " (Top: ";
-                    int count = 0;
-                    for (const auto& bid : bids) {
-                        std::cout << bid.price << "@" << bid.quantity << " ";
-                        if (++count >= 3) break;
-                    }
-                    std::cout << ")";
-                }
-                std::cout << std::endl;
-                
-                // Show top 3 asks if available
-                std::cout << "  Asks: " << orderbook->getAskLevels().size() << " levels";
-                const auto& asks = orderbook->getAskLevels();
-                if (!asks.empty()) {
-                    std::cout << " (Top: ";
-                    int count = 0;
-                    for (const auto& ask : asks) {
-                        std::cout << ask.price << "@" << ask.quantity << " ";
-                        if (++count >= 3) break;
-                    }
-                    std::cout << ")";
-                }
-                std::cout << std::endl;
-                
-                // Push event to queue correctly
-                event_queue_->push(std::make_shared<std::shared_ptr<Event>>(orderbook));
-                
-                // Notify any listeners
-                if (on_new_data_) {
-                    on_new_data_();
-                }
-            }
+const std::string* WebSocketDataHandler::find_symbol(std::string_view symbol) const {
+    for (const auto& s : symbols_) {
+        if (s == symbol) {
+            return &s;
         }
-    } catch (const nlohmann::json::parse_error& e) {
-        std::cerr << "JSON parse error: " << e.what() << std::endl;
-    } catch (const std::exception& e) {
-        std::cerr << "Error processing message: " << e.what() << std::endl;
+    }
+    return nullptr;
+}
+
+void WebSocketDataHandler::onDepthBegin(const BinanceDepthHeader& header) {
+    depth_symbol_ = find_symbol(header.symbol);
+    if (!depth_symbol_) {
+        depth_book_ = nullptr;
+        depth_event_.reset();
+        return;
+    }
+
+    depth_book_ = &orderbooks_[*depth_symbol_];
+    depth_event_ = std::make_shared<OrderBookEvent>(*depth_symbol_, receive_time_ms_);
+    depth_event_->timestamp_received = receive_stamp_;
+}
+
+void WebSocketDataHandler::onBidLevel(double price, double quantity) {
+    if (!depth_book_) return;
+    if (quantity > 0) {
+        depth_book_->bids[price] = std::make_pair(price, quantity);
+        depth_event_->addBidLevel(price, quantity);
+    } else {
+        // Remove price level with zero quantity
+        depth_book_->bids.erase(price);
+    }
+}
+
+void WebSocketDataHandler::onAskLevel(double price, double quantity) {
+    if (!depth_book_) return;
+    if (quantity > 0) {
+        depth_book_->asks[price] = std::make_pair(price, quantity);
+        depth_event_->addAskLevel(price, quantity);
+    } else {
+        // Remove price level with zero quantity
+        depth_book_->asks.erase(price);
+    }
+}
+
+void WebSocketDataHandler::onDepthEnd() {
+    if (!depth_book_) return;
+
+    const std::string& symbol = *depth_symbol_;
+    auto orderbook = std::move(depth_event_);
+    depth_book_ = nullptr;
+
+    // Update latest_orderbooks_
+    OrderBook& latest = latest_orderbooks_[symbol];
+    latest.symbol = symbol;
+    latest.timestamp = orderbook->timestamp_;
+    latest.bids.clear();
+    for (auto it = orderbooks_[symbol].bids.rbegin(); it != orderbooks_[symbol].bids.rend(); ++it) {
+        latest.bids.push_back(it->second); // Best (highest) bid first
+    }
+    latest.asks.clear();
+    for (const auto& [price, level] : orderbooks_[symbol].asks) {
+        latest.asks.push_back(level);
+    }
+    
+    // Order book summary with the top of each side
+    const auto& bids = orderbook->getBidLevels();
+    const auto& asks = orderbook->getAskLevels();
+    if (!bids.empty() && !asks.empty()) {
+        LOG_INFO(kLog, "ORDER BOOK: {} | Timestamp: {} | Bids: {} levels (Top: {}@{}) | Asks: {} levels (Top: {}@{})",
+                 symbol, orderbook->timestamp_, bids.size(), bids.front().price, bids.front().quantity,
+                 asks.size(), asks.front().price, asks.front().quantity);
+    } else {
+        LOG_INFO(kLog, "ORDER BOOK: {} | Timestamp: {} | Bids: {} levels | Asks: {} levels",
+                 symbol, orderbook->timestamp_, bids.size(), asks.size());
+    }
+    
+    // Push event to queue correctly
+    event_queue_->push(std::make_shared<std::shared_ptr<Event>>(orderbook));
+    
+    // Notify any listeners
+    if (on_new_data_) {
+        on_new_data_();
+    }
+}
 
+void WebSocketDataHandler::onTrade(const BinanceTrade& trade) {
+    const std::string* symbol = find_symbol(trade.symbol);
+    if (!symbol) return;
+    trade_counts_[*symbol]++;
+
+    // Roll the trade into the symbol's current bar and publish it.
+    SymbolSlot& slot = *symbol_slots_.at(*symbol);
+    LiveBar& bar = slot.building;
+    const long long bar_open = trade.trade_time - trade.trade_time % BAR_INTERVAL_MS;
+    if (bar.open_time != 0 && bar_open > bar.open_time) {
+        uint64_t completed = slot.completed.load(std::memory_order_relaxed);
+        slot.history[completed % BAR_HISTORY].store(bar);
+        slot.completed.store(completed + 1, std::memory_order_release);
+    }
+    if (bar.open_time == 0 || bar_open > bar.open_time) {
+        bar = LiveBar{};
+        bar.open_time = bar_open;
+        bar.open = bar.high = bar.low = trade.price;
+    }
+    bar.last_trade_time = trade.trade_time;
+    bar.high = std::max(bar.high, trade.price);
+    bar.low = std::min(bar.low, trade.price);
+    bar.close = trade.price;
+    bar.volume += trade.quantity;
+    slot.current.store(bar);
+
+    // "m" is true when the buyer was the maker, i.e. the aggressor sold. Trades
+    // are stamped with the receive time, like book updates, so both streams
+    // share one time base (and a journal replay reproduces it).
+    auto trade_event = std::make_shared<TradeEvent>(*symbol, receive_time_ms_, trade.price, trade.quantity,
+                                                    trade.buyer_is_maker ? "SELL" : "BUY");
+    trade_event->timestamp_received = receive_stamp_;
+    event_queue_->push(std::make_shared<std::shared_ptr<Event>>(trade_event));
+
+    if (on_new_data_) {
+        on_new_data_();
     }
 }
 
+Bar WebSocketDataHandler::to_bar(const std::string& symbol, const LiveBar& live) {
+    Bar bar;
+    bar.symbol = symbol;
+    bar.timestamp = std::to_string(live.open_time);
+    bar.open = live.open;
+    bar.high = live.high;
+    bar.low = live.low;
+    bar.close = live.close;
+    bar.volume = static_cast<long long>(live.volume);
+    return bar;
+}
+
 void WebSocketDataHandler::setOnNewDataCallback(std::function<void()> callback) {
     on_new_data_ = std::move(callback);
 }
@@ -453,11 +443,15 @@ bool WebSocketDataHandler::isFinished() const {
 }
 
 std::optional<Bar> WebSocketDataHandler::getLatestBar(const std::string& symbol) const {
-    auto it = latest_bars_map_.find(symbol);
-    if (it != latest_bars_map_.end() && std::stoll(it->second.timestamp) > 0) {
-        return it->second;
+    auto it = symbol_slots_.find(symbol);
+    if (it == symbol_slots_.end()) {
+        return std::nullopt;
     }
-    return std::nullopt;
+    LiveBar bar = it->second->current.load();
+    if (bar.open_time == 0) {
+        return std::nullopt; // No trade received yet
+    }
+    return to_bar(symbol, bar);
 }
 
 double WebSocketDataHandler::getLatestBarValue(const std::string& symbol, const std::string& val_type) {
@@ -471,20 +465,36 @@ double WebSocketDataHandler::getLatestBarValue(const std::string& symbol, const
     if (val_type == "open") return bar.open;
     if (val_type == "high") return bar.high;
     if (val_type == "low") return bar.low;
-    if (val_type == "close") return bar.close;
+    if (val_type == "close" || val_type == "price") return bar.close;
     if (val_type == "volume") return bar.volume;
     
     return 0.0;
 }
 
 std::vector<Bar> WebSocketDataHandler::getLatestBars(const std::string& symbol, int n) {
-    // In a real implementation, we would keep a history of bars
-    // For now, just return the latest bar if available
+    // Up to n bars, oldest first; the last one is the bar still being formed.
     std::vector<Bar> bars;
-    auto bar_opt = getLatestBar(symbol);
-    if (bar_opt) {
-        bars.push_back(*bar_opt);
+    auto it = symbol_slots_.find(symbol);
+    if (it == symbol_slots_.end() || n <= 0) {
+        return bars;
+    }
+    const SymbolSlot& slot = *it->second;
+    LiveBar current = slot.current.load();
+    if (current.open_time == 0) {
+        return bars;
+    }
+
+    uint64_t completed = slot.completed.load(std::memory_order_acquire);
+    uint64_t available = std::min<uint64_t>(completed, BAR_HISTORY - 1); // Leave a slot of slack for the writer
+    uint64_t count = std::min<uint64_t>(available, static_cast<uint64_t>(n - 1));
+    bars.reserve(count + 1);
+    for (uint64_t i = completed - count; i < completed; ++i) {
+        LiveBar bar = slot.history[i % BAR_HISTORY].load();
+        if (bar.open_time < current.open_time) {
+            bars.push_back(to_bar(symbol, bar));
+        }
     }
+    bars.push_back(to_bar(symbol, current));
     return bars;
 }
 
@@ -1,30 +1,194 @@
-#include "serialization/DataSerialization.h"
+#include "../../../include/data/serialization/DataSerialization.h"
+#include <charconv>
+#include <cstring>
 #include <fstream>
 #include <stdexcept>
+#include <unordered_map>
 
 namespace serialization {
 
+namespace {
+
+constexpr uint32_t BAR_COLUMN_COUNT = 6;
+
+size_t align8(size_t n) {
+    return (n + 7) & ~static_cast<size_t>(7);
+}
+
+long long parse_bar_timestamp(const Bar& bar) {
+    long long value = 0;
+    const char* first = bar.timestamp.data();
+    const char* last = first + bar.timestamp.size();
+    auto [ptr, ec] = std::from_chars(first, last, value);
+    if (ec != std::errc() || ptr != last) {
+        throw std::invalid_argument("Bar timestamp is not an integer: '" + bar.timestamp + "' (" + bar.symbol + ")");
+    }
+    return value;
+}
+
+template <typename T>
+void write_column(std::ofstream& out, const std::vector<T>& column) {
+    out.write(reinterpret_cast<const char*>(column.data()), column.size() * sizeof(T));
+}
+
+} // namespace
+
 void serialize_bars(const std::vector<Bar>& bars, const std::string& file_path) {
-    std::ofstream out(file_path, std::ios::binary);
+    // Group row indices by symbol, keeping first-seen symbol order.
+    std::vector<std::string> symbols;
+    std::unordered_map<std::string, std::vector<size_t>> rows_by_symbol;
+    for (size_t i = 0; i < bars.size(); ++i) {
+        auto& rows = rows_by_symbol[bars[i].symbol];
+        if (rows.empty()) {
+            if (bars[i].symbol.size() > BAR_FILE_MAX_SYMBOL_LEN) {
+                throw std::invalid_argument("Symbol too long for bar file: " + bars[i].symbol);
+            }
+            symbols.push_back(bars[i].symbol);
+        }
+        rows.push_back(i);
+    }
+
+    BarFileHeader header{};
+    header.magic = BAR_FILE_MAGIC;
+    header.version = BAR_FILE_VERSION;
+    header.symbol_count = static_cast<uint32_t>(symbols.size());
+    header.column_count = BAR_COLUMN_COUNT;
+    header.row_count = bars.size();
+
+    std::vector<BarFileSymbolEntry> table(symbols.size());
+    size_t offset = align8(sizeof(BarFileHeader) + table.size() * sizeof(BarFileSymbolEntry));
+    for (size_t s = 0; s < symbols.size(); ++s) {
+        std::memset(&table[s], 0, sizeof(BarFileSymbolEntry));
+        std::memcpy(table[s].symbol, symbols[s].data(), symbols[s].size());
+        table[s].columns_offset = offset;
+        table[s].row_count = rows_by_symbol[symbols[s]].size();
+        offset += table[s].row_count * BAR_COLUMN_COUNT * 8;
+    }
+
+    std::ofstream out(file_path, std::ios::binary | std::ios::trunc);
     if (!out) {
         throw std::runtime_error("Failed to open file for writing: " + file_path);
     }
-    for (const auto& bar : bars) {
-        out.write(reinterpret_cast<const char*>(&bar), sizeof(Bar));
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(table.data()), table.size() * sizeof(BarFileSymbolEntry));
+    size_t written = sizeof(header) + table.size() * sizeof(BarFileSymbolEntry);
+    static const char padding[8] = {};
+    out.write(padding, align8(written) - written);
+
+    std::vector<long long> timestamps, volumes;
+    std::vector<double> opens, highs, lows, closes;
+    for (const auto& symbol : symbols) {
+        const auto& rows = rows_by_symbol[symbol];
+        timestamps.clear(); opens.clear(); highs.clear(); lows.clear(); closes.clear(); volumes.clear();
+        for (size_t idx : rows) {
+            const Bar& bar = bars[idx];
+            timestamps.push_back(parse_bar_timestamp(bar));
+            opens.push_back(bar.open);
+            highs.push_back(bar.high);
+            lows.push_back(bar.low);
+            closes.push_back(bar.close);
+            volumes.push_back(bar.volume);
+        }
+        write_column(out, timestamps);
+        write_column(out, opens);
+        write_column(out, highs);
+        write_column(out, lows);
+        write_column(out, closes);
+        write_column(out, volumes);
+    }
+
+    if (!out) {
+        throw std::runtime_error("Failed to write bar file: " + file_path);
     }
 }
 
 std::vector<Bar> deserialize_bars(const std::string& file_path) {
-    std::ifstream in(file_path, std::ios::binary);
-    if (!in) {
-        throw std::runtime_error("Failed to open file for reading: " + file_path);
-    }
+    MappedBarFile file(file_path);
     std::vector<Bar> bars;
-    Bar bar;
-    while (in.read(reinterpret_cast<char*>(&bar), sizeof(Bar))) {
-        bars.push_back(bar);
+    bars.reserve(file.rowCount());
+    for (const auto& series : file.allSeries()) {
+        for (size_t i = 0; i < series.size; ++i) {
+            bars.push_back(series.bar(i));
+        }
     }
     return bars;
 }
 
+MappedBarFile::MappedBarFile(const std::string& file_path) {
+    std::error_code error;
+    mmap_.map(file_path, error);
+    if (error) {
+        throw std::runtime_error("Could not map bar file: " + file_path + " (" + error.message() + ")");
+    }
+
+    const char* base = mmap_.data();
+    const size_t file_size = mmap_.size();
+    if (file_size < sizeof(BarFileHeader)) {
+        throw std::runtime_error("Bar file is truncated: " + file_path);
+    }
+
+    BarFileHeader header;
+    std::memcpy(&header, base, sizeof(header));
+    if (header.magic != BAR_FILE_MAGIC) {
+        throw std::runtime_error("Not a bar file (bad magic): " + file_path);
+    }
+    if (header.version != BAR_FILE_VERSION) {
+        throw std::runtime_error("Unsupported bar file version " + std::to_string(header.version) + ": " + file_path);
+    }
+    if (header.column_count != BAR_COLUMN_COUNT) {
+        throw std::runtime_error("Unexpected bar file column count: " + file_path);
+    }
+
+    const size_t table_end = sizeof(BarFileHeader) + static_cast<size_t>(header.symbol_count) * sizeof(BarFileSymbolEntry);
+    if (table_end > file_size) {
+        throw std::runtime_error("Bar file symbol table is truncated: " + file_path);
+    }
+
+    version_ = header.version;
+    row_count_ = header.row_count;
+    series_.reserve(header.symbol_count);
+
+    const auto* table = reinterpret_cast<const BarFileSymbolEntry*>(base + sizeof(BarFileHeader));
+    uint64_t rows_seen = 0;
+    for (uint32_t s = 0; s < header.symbol_count; ++s) {
+        const BarFileSymbolEntry& entry = table[s];
+        // Checked without sums or products that a corrupt offset or row
+        // count could make wrap around.
+        if (entry.row_count > file_size / 8 / BAR_COLUMN_COUNT ||
+            entry.columns_offset % 8 != 0 || entry.columns_offset < table_end || entry.columns_offset > file_size) {
+            throw std::runtime_error("Bar file column block out of range: " + file_path);
+        }
+        const size_t column_bytes = entry.row_count * 8;
+        if (column_bytes > (file_size - entry.columns_offset) / BAR_COLUMN_COUNT) {
+            throw std::runtime_error("Bar file column block out of range: " + file_path);
+        }
+
+        const char* columns = base + entry.columns_offset;
+        BarSeries series;
+        series.symbol = std::string_view(entry.symbol, strnlen(entry.symbol, sizeof(entry.symbol)));
+        series.timestamp = reinterpret_cast<const long long*>(columns);
+        series.open = reinterpret_cast<const double*>(columns + column_bytes);
+        series.high = reinterpret_cast<const double*>(columns + column_bytes * 2);
+        series.low = reinterpret_cast<const double*>(columns + column_bytes * 3);
+        series.close = reinterpret_cast<const double*>(columns + column_bytes * 4);
+        series.volume = reinterpret_cast<const long long*>(columns + column_bytes * 5);
+        series.size = entry.row_count;
+        series_.push_back(series);
+        rows_seen += entry.row_count;
+    }
+
+    if (rows_seen != row_count_) {
+        throw std::runtime_error("Bar file row count does not match its symbol table: " + file_path);
+    }
+}
+
+std::optional<BarSeries> MappedBarFile::series(const std::string& symbol) const {
+    for (const auto& s : series_) {
+        if (s.symbol == symbol) {
+            return s;
+        }
+    }
+    return std::nullopt;
+}
+
 } // namespace serialization
@@ -1,8 +1,10 @@
 #include "../../include/execution/SimulatedExecutionHandler.h"
-#include <iostream>
+#include "../../include/core/AsyncLogger.h"
 #include <memory>
 #include <numeric>
 
+static const LogComponent kLog("Execution");
+
 // Update the constructor signature to match the corrected header
 SimulatedExecutionHandler::SimulatedExecutionHandler(
     std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> event_queue,
@@ -28,6 +30,6 @@ void SimulatedExecutionHandler::onOrder(const OrderEvent& order_event) {
         // The queue expects a std::shared_ptr<std::shared_ptr<Event>>, so we must wrap the event pointer.
         event_queue_->push(std::make_shared<std::shared_ptr<Event>>(fill_event));
     } else {
-        std::cerr << "SimulatedExecutionHandler: Could not get latest bar for " << order_event.symbol << " to fill order." << std::endl;
+        LOG_WARN(kLog, "Could not get latest bar for {} to fill order.", order_event.symbol);
     }
 }
\ No newline at end of file
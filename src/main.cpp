@@ -1,7 +1,9 @@
 #define _HAS_STD_BYTE 0
 #include <iostream>
+#include <map>
 #include <memory>
 #include <fstream>
+#include <set>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -9,9 +11,193 @@
 #include <nlohmann/json.hpp>
 
 #include "../include/ui/ConsoleUI.h"
+#include "../include/core/BatchRunner.h"
+#include "../include/core/DistributedSweep.h"
 
-int main() {
+namespace {
+
+// Command line options by name; flags map to "".
+using Options = std::map<std::string, std::string>;
+
+void printUsage() {
+    std::cerr << "Usage: backtester                      interactive menu\n"
+              << "       backtester --batch JOBS [options]\n"
+              << "       backtester --coordinator optimization|monte_carlo|JOBS [options]\n"
+              << "       backtester --worker HOST:PORT [--threads N]\n"
+              << "       backtester --worker-dir DIR [--threads N]\n"
+              << "  --batch JOBS          job file, one JSON config patch per line\n"
+              << "  --config FILE         base config (default: config.json)\n"
+              << "  --out FILE            result file (default: stdout)\n"
+              << "  --format F            jsonl (default) or csv\n"
+              << "  --threads N           concurrent jobs per process (default: all cores)\n"
+              << "  --resume              skip jobs that succeeded in the result file\n"
+              << "Distributed sweeps (defaults from the config's \"distributed\" block):\n"
+              << "  --coordinator SOURCE  the optimization grid, monte_carlo draws, or a job file\n"
+              << "  --address ADDR        coordinator listen address (default 127.0.0.1; 0.0.0.0 for all)\n"
+              << "  --port P              coordinator port (0: any free port)\n"
+              << "  --shard-size N        jobs handed to a worker at a time\n"
+              << "  --local-workers N     worker processes to start on this machine\n"
+              << "  --shared-dir DIR      exchange shards through files in DIR instead of TCP\n"
+              << "  --simulations N       Monte Carlo draws (default: monte_carlo.num_simulations)\n"
+              << "  --worker HOST:PORT    run shards for the coordinator at HOST:PORT\n"
+              << "  --worker-dir DIR      run shards from a coordinator's shared directory\n";
+}
+
+// Parses "--name value" pairs and flags; returns false on a usage error.
+bool parseOptions(const std::vector<std::string>& args, Options& options) {
+    static const std::set<std::string> flags = {"--resume"};
+    static const std::set<std::string> valued = {
+        "--batch", "--coordinator", "--worker", "--worker-dir", "--config", "--out", "--format", "--threads",
+        "--address", "--port", "--shard-size", "--local-workers", "--shared-dir", "--simulations"};
+    for (size_t i = 0; i < args.size(); ++i) {
+        const std::string& arg = args[i];
+        if (flags.count(arg)) {
+            options[arg] = "";
+        } else if (valued.count(arg) && i + 1 < args.size()) {
+            options[arg] = args[++i];
+        } else {
+            std::cerr << "Unknown or incomplete option: " << arg << std::endl;
+            return false;
+        }
+    }
+    const int modes = static_cast<int>(options.count("--batch") + options.count("--coordinator") +
+                                       options.count("--worker") + options.count("--worker-dir"));
+    if (modes != 1) {
+        std::cerr << "Give exactly one of --batch, --coordinator, --worker and --worker-dir." << std::endl;
+        return false;
+    }
+    if (options.count("--resume") && (!options.count("--batch") || !options.count("--out"))) {
+        std::cerr << "--resume needs --batch and --out." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+std::string option(const Options& options, const std::string& name, const std::string& fallback = "") {
+    const auto it = options.find(name);
+    return it == options.end() ? fallback : it->second;
+}
+
+int runBatch(const Options& options) {
+    BatchOptions batch;
+    batch.jobs_path = option(options, "--batch");
+    batch.config_path = option(options, "--config", batch.config_path);
+    batch.out_path = option(options, "--out");
+    batch.format = option(options, "--format", batch.format);
+    batch.threads = std::stoi(option(options, "--threads", "0"));
+    batch.resume = options.count("--resume") > 0;
+    BatchRunner runner(batch);
+    return runner.run() == 0 ? 0 : 1;
+}
+
+int runCoordinator(const Options& options, const std::string& executable) {
+    const std::string config_path = option(options, "--config", "config.json");
+    std::ifstream config_file(config_path);
+    if (!config_file) {
+        throw std::runtime_error("Sweep: cannot open config " + config_path);
+    }
+    const json config = json::parse(config_file);
+    const std::string format = option(options, "--format", "jsonl");
+    if (format != "jsonl" && format != "csv") {
+        throw std::runtime_error("Sweep: unknown result format '" + format + "' (jsonl or csv)");
+    }
+
+    DistributedOptions distributed = DistributedOptions::fromConfig(config);
+    distributed.address = option(options, "--address", distributed.address);
+    distributed.port = static_cast<unsigned short>(std::stoi(option(options, "--port", std::to_string(distributed.port))));
+    distributed.shard_size = std::stoul(option(options, "--shard-size", std::to_string(distributed.shard_size)));
+    distributed.local_workers = std::stoi(option(options, "--local-workers", std::to_string(distributed.local_workers)));
+    distributed.local_worker_threads = std::stoi(option(options, "--threads", std::to_string(distributed.local_worker_threads)));
+    distributed.shared_dir = option(options, "--shared-dir", distributed.shared_dir);
+    distributed.worker_executable = executable;
+
+    const std::string source = option(options, "--coordinator");
+    std::vector<BatchJob> jobs;
+    if (source == "optimization") {
+        jobs = SweepCoordinator::optimizationJobs(config);
+    } else if (source == "monte_carlo") {
+        const int default_simulations = config.value("monte_carlo", json::object()).value("num_simulations", 100);
+        jobs = SweepCoordinator::monteCarloJobs(config, std::stoi(option(options, "--simulations", std::to_string(default_simulations))));
+    } else {
+        jobs = BatchRunner::loadJobs(source);
+    }
+
+    std::ofstream file;
+    const std::string out_path = option(options, "--out");
+    if (!out_path.empty()) {
+        file.open(out_path, std::ios::trunc);
+        if (!file) {
+            throw std::runtime_error("Sweep: cannot write " + out_path);
+        }
+    }
+    std::ostream& out = out_path.empty() ? std::cout : file;
+    if (format == "csv") {
+        out << BatchRunner::csvHeader() << '\n' << std::flush;
+    }
+
+    // Each result is written as it arrives, so a coordinator that dies keeps
+    // what the sweep has done so far.
+    SweepCoordinator coordinator(config, std::move(jobs), distributed);
+    coordinator.onResult([&out, &format](const BatchResult& result) {
+        out << BatchRunner::formatResult(result, format) << '\n' << std::flush;
+    });
+    const std::vector<BatchResult> results = coordinator.run();
+
+    size_t failed = 0;
+    const BatchResult* best = nullptr;
+    for (const auto& result : results) {
+        if (!result.ok) {
+            ++failed;
+            std::cerr << "Sweep: job " << result.id << " failed: " << result.error << std::endl;
+        } else if (!best || result.metrics.sharpe > best->metrics.sharpe) {
+            best = &result;
+        }
+    }
+    std::cerr << "Sweep: " << results.size() << " jobs, " << failed << " failed." << std::endl;
+    if (best) {
+        std::cerr << "Sweep: best Sharpe " << best->metrics.sharpe << " (return " << best->metrics.total_return
+                  << ", max drawdown " << best->metrics.max_drawdown << ") for " << best->id << std::endl;
+    }
+    return failed == 0 ? 0 : 1;
+}
+
+int runWorker(const Options& options) {
+    DistributedOptions distributed;
+    const int threads = std::stoi(option(options, "--threads", "0"));
+    if (options.count("--worker-dir")) {
+        distributed.shared_dir = option(options, "--worker-dir");
+        SweepWorker(distributed, threads).runSharedDirectory();
+        return 0;
+    }
+    const std::string address = option(options, "--worker");
+    const size_t colon = address.rfind(':');
+    if (colon == std::string::npos || colon == 0) {
+        throw std::runtime_error("--worker needs HOST:PORT, got '" + address + "'");
+    }
+    SweepWorker(distributed, threads).runTcp(address.substr(0, colon), static_cast<unsigned short>(std::stoi(address.substr(colon + 1))));
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::vector<std::string> args(argv + 1, argv + argc);
     try {
+        if (!args.empty()) {
+            Options options;
+            if (args[0] == "--help" || args[0] == "-h" || !parseOptions(args, options)) {
+                printUsage();
+                return args[0] == "--help" || args[0] == "-h" ? 0 : 2;
+            }
+            if (options.count("--batch")) {
+                return runBatch(options);
+            }
+            if (options.count("--coordinator")) {
+                return runCoordinator(options, argv[0]);
+            }
+            return runWorker(options);
+        }
+
         ConsoleUI ui;
         ui.displayMainMenu();
     } catch (const std::exception& e) {
@@ -20,4 +206,4 @@ int main() {
     }
     
     return 0;
-}
\ No newline at end of file
+}
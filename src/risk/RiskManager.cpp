@@ -1,12 +1,13 @@
 #include "../../include/risk/RiskManager.h" 
 #include "../../include/event/Event.h"
+#include "../../include/core/AsyncLogger.h"
 #include <cmath>
-#include <iostream>
-#include <iomanip> // <--- ADD THIS LINE for std::setprecision
 #include <memory> 
 #include <numeric>
 #include <vector> 
 
+static const LogComponent kLog("RiskManager");
+
 // Helper function to convert OrderDirection enum to string for logging
 std::string orderDirectionToString(OrderDirection dir) {
     switch (dir) {
@@ -34,7 +35,7 @@ RiskManager::RiskManager(std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>
 
 void RiskManager::onSignal(const SignalEvent& signal) {
     if (trading_halted_) {
-        std::cout << "RISK ALERT: Trading halted. Ignoring signal for " << signal.symbol << std::endl;
+        LOG_WARN(kLog, "RISK ALERT: Trading halted. Ignoring signal for {}", signal.symbol);
         return;
     }
 
@@ -44,7 +45,7 @@ void RiskManager::onSignal(const SignalEvent& signal) {
     double last_price = portfolio_->get_last_price(signal.symbol);
 
     if (last_price <= 0) {
-        std::cerr << "RiskManager: Could not get last price for " << signal.symbol << ". Order rejected." << std::endl;
+        LOG_ERROR(kLog, "Could not get last price for {}. Order rejected.", signal.symbol);
         return;
     }
 
@@ -55,7 +56,7 @@ void RiskManager::onSignal(const SignalEvent& signal) {
             double risk_amount = total_equity * risk_per_trade_pct_;
             quantity = risk_amount / (volatility * last_price);
         } else {
-            std::cerr << "RiskManager: Volatility is zero for " << signal.symbol << ". Using fixed sizing." << std::endl;
+            LOG_WARN(kLog, "Volatility is zero for {}. Using fixed sizing.", signal.symbol);
             quantity = (total_equity * risk_per_trade_pct_) / last_price;
         }
     } else {
@@ -86,8 +87,7 @@ void RiskManager::onDataSourceStatus(const DataSourceStatusEvent& event) {
         case DataSourceStatus::RECONNECTING: status_str = "RECONNECTING"; break;
         case DataSourceStatus::FALLBACK_ACTIVE: status_str = "FALLBACK_ACTIVE"; break;
     }
-    std::cout << "RISK MANAGER: Data source status changed to " << status_str 
-              << ". Message: " << event.message << std::endl;
+    LOG_INFO(kLog, "Data source status changed to {}. Message: {}", status_str, event.message);
 }
 
 void RiskManager::monitorRealTimeRisk() {
@@ -100,8 +100,7 @@ void RiskManager::monitorRealTimeRisk() {
                   std::to_string(current_max_drawdown * 100) + "% | Threshold: " + 
                   std::to_string(thresholds_.max_drawdown_pct * 100) + "%");
     } else {
-        std::cout << "Current Max Drawdown: " << std::fixed << std::setprecision(2) 
-                  << current_max_drawdown * 100 << "% (Below threshold)" << std::endl;
+        LOG_DEBUG(kLog, "Current Max Drawdown: {:.2f}% (Below threshold)", current_max_drawdown * 100);
     }
 
     Performance current_performance = portfolio_->getRealTimePerformance();
@@ -112,24 +111,19 @@ void RiskManager::monitorRealTimeRisk() {
                   std::to_string(current_var_95 * 100) + "% | Threshold: " + 
                   std::to_string(thresholds_.daily_var_95_pct * 100) + "%");
     } else {
-        std::cout << "Current VaR (95%): " << std::fixed << std::setprecision(2) 
-                  << current_var_95 * 100 << "% (Below threshold)" << std::endl;
+        LOG_DEBUG(kLog, "Current VaR (95%): {:.2f}% (Below threshold)", current_var_95 * 100);
     }
 
     std::map<std::string, Position> current_positions = portfolio_->getCurrentPositions();
     if (!current_positions.empty()) {
-        std::cout << "Current Open Positions:" << std::endl;
         for (const auto& pair : current_positions) {
             const Position& pos = pair.second;
-            std::cout << "  " << pos.symbol << ": Quantity=" << pos.quantity 
-                      << ", Avg Cost=" << std::fixed << std::setprecision(2) << pos.average_cost
-                      << ", Market Value=" << std::fixed << std::setprecision(2) << pos.market_value 
-                      << ", Direction=" << orderDirectionToString(pos.direction) << std::endl;
+            LOG_DEBUG(kLog, "Open position {}: Quantity={}, Avg Cost={:.2f}, Market Value={:.2f}, Direction={}",
+                      pos.symbol, pos.quantity, pos.average_cost, pos.market_value, orderDirectionToString(pos.direction));
         }
     } else {
-        std::cout << "No open positions." << std::endl;
+        LOG_DEBUG(kLog, "No open positions.");
     }
-    std::cout << "--------------------------------------\n";
 
     double current_equity = portfolio_->get_total_equity();
     double initial_capital = portfolio_->getInitialCapital();
@@ -141,8 +135,16 @@ void RiskManager::monitorRealTimeRisk() {
     }
 }
 
+void RiskManager::saveState(StateWriter& out) const {
+    out.put(trading_halted_);
+}
+
+void RiskManager::loadState(StateReader& in) {
+    trading_halted_ = in.get<uint8_t>() != 0;
+}
+
 void RiskManager::sendAlert(const std::string& message) {
-    std::cerr << "!!!!! RISK ALERT !!!!! " << message << std::endl;
+    LOG_ERROR(kLog, "!!!!! RISK ALERT !!!!! {}", message);
     // auto alert_event = std::make_shared<Event>(); 
     // event_queue_->push(alert_event);
 }
@@ -1,5 +1,7 @@
 #include "../../include/strategy/MLStrategyClassifier.h"
-#include <iostream>
+#include "../../include/core/AsyncLogger.h"
+
+static const LogComponent kLog("StrategyClassifier");
 
 MLStrategyClassifier::MLStrategyClassifier(const std::string& model_path) : model_path_(model_path) {
     load_model();
@@ -8,7 +10,7 @@ MLStrategyClassifier::MLStrategyClassifier(const std::string& model_path) : mode
 void MLStrategyClassifier::load_model() {
     // In a real implementation, this would load the ML model from model_path_
     // using a library like ONNX Runtime or TensorFlow Lite.
-    std::cout << "Loading ML model from: " << model_path_ << " (stub)" << std::endl;
+    LOG_INFO(kLog, "Loading ML model from: {} (stub)", model_path_);
     // For now, it's just a placeholder.
 }
 
@@ -17,9 +19,8 @@ std::vector<std::string> MLStrategyClassifier::classify(const MarketState& state
     // In a real scenario, we would preprocess the MarketState into a feature vector,
     // run inference with the model, and post-process the output to get strategy names.
     
-    std::cout << "Classifying market state (stub)..." << std::endl;
-    std::cout << "Volatility: " << static_cast<int>(state.volatility) 
-              << ", Trend: " << static_cast<int>(state.trend) << std::endl;
+    LOG_DEBUG(kLog, "Classifying market state (stub): Volatility={}, Trend={}",
+              static_cast<int>(state.volatility), static_cast<int>(state.trend));
 
     // Example logic:
     if (state.volatility == VolatilityLevel::HIGH && state.trend == TrendDirection::TRENDING_UP) {
@@ -35,7 +36,7 @@ std::vector<std::string> MLStrategyClassifier::classify(const std::vector<Bar>&
     // This is a more advanced stub.
     // It would use recent bar data to create features (e.g., RSI, MACD, etc.)
     // and feed them to the ML model.
-    std::cout << "Classifying based on recent bars (stub)..." << std::endl;
+    LOG_DEBUG(kLog, "Classifying based on recent bars (stub)...");
     if (recent_data.empty()) {
         return {};
     }
@@ -1,7 +1,9 @@
 #include "../../include/strategy/MarketRegimeDetector.h"
+#include "../../include/core/AsyncLogger.h"
 #include <numeric>
 #include <cmath>
-#include <iostream>
+
+static const LogComponent kLog("MarketRegime");
 
 MarketRegimeDetector::MarketRegimeDetector(
     std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> event_queue,
@@ -37,9 +39,8 @@ void MarketRegimeDetector::onMarket(const MarketEvent& event) {
     update_trend();
 
     if (old_state.volatility != current_state_.volatility || old_state.trend != current_state_.trend) {
-        std::cout << "Market regime changed for " << symbol 
-                  << ": Volatility=" << static_cast<int>(current_state_.volatility) 
-                  << ", Trend=" << static_cast<int>(current_state_.trend) << std::endl;
+        LOG_INFO(kLog, "Market regime changed for {}: Volatility={}, Trend={}",
+                 symbol, current_state_.volatility, current_state_.trend);
         auto regime_event = std::make_shared<MarketRegimeChangedEvent>(current_state_);
         event_queue_->push(std::make_shared<std::shared_ptr<Event>>(regime_event));
     }
@@ -59,6 +60,20 @@ void MarketRegimeDetector::onFill(const FillEvent& event) {
     // Not used for this strategy
 }
 
+void MarketRegimeDetector::saveState(StateWriter& out) const {
+    Strategy::saveState(out);
+    out.put(current_state_);
+    out.putSequence(recent_prices_vol_);
+    out.putSequence(recent_prices_trend_);
+}
+
+void MarketRegimeDetector::loadState(StateReader& in) {
+    Strategy::loadState(in);
+    current_state_ = in.getMarketState();
+    recent_prices_vol_ = in.getDeque<double>();
+    recent_prices_trend_ = in.getDeque<double>();
+}
+
 MarketState MarketRegimeDetector::getCurrentState() const {
     return current_state_;
 }
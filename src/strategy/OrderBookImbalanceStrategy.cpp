@@ -1,5 +1,6 @@
 #include "../../include/strategy/OrderBookImbalanceStrategy.h"
 #include "../../include/data/HFTDataHandler.h"
+#include "../../include/core/AsyncLogger.h"
 #include <iostream>
 #include <numeric>
 #include <algorithm> // For std::min
@@ -8,6 +9,8 @@
 // STAGE 3: SIMD for accelerated math
 #include <immintrin.h>
 
+static const LogComponent kLog("OrderBookImbalance");
+
 OrderBookImbalanceStrategy::OrderBookImbalanceStrategy(
     std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> event_queue,
     std::shared_ptr<DataHandler> data_handler,
@@ -32,9 +35,8 @@ OrderBookImbalanceStrategy::OrderBookImbalanceStrategy(
     signal_cooldown_ms_ = 10000; // 10 seconds cooldown between signals
     current_position_ = PositionState::FLAT;
     
-    std::cout << "OrderBookImbalanceStrategy initialized with lookback_levels=" 
-              << lookback_levels_ << ", imbalance_threshold=" 
-              << base_imbalance_threshold_ << std::endl;
+    LOG_INFO(kLog, "OrderBookImbalanceStrategy initialized with lookback_levels={}, imbalance_threshold={}",
+             lookback_levels_, base_imbalance_threshold_);
 
 }
 
@@ -97,12 +99,10 @@ void OrderBookImbalanceStrategy::onOrderBook(const OrderBookEvent& event) {
     // Log the imbalance periodically
     if (now_ms % 5000 < 100) { // Log roughly every 5 seconds
         // Fix 4: Use symbol_ from event
-        std::cout << "ORDER BOOK IMBALANCE: " << event.symbol_ 
-                << " | Ratio: " << imbalance_ratio 
-                << " | Threshold: " << base_imbalance_threshold_ 
-                << " | Position: " << (current_position_ == PositionState::LONG ? "LONG" : 
-                                     current_position_ == PositionState::SHORT ? "SHORT" : "FLAT")
-                << std::endl;
+        LOG_INFO(kLog, "ORDER BOOK IMBALANCE: {} | Ratio: {} | Threshold: {} | Position: {}",
+                 event.symbol_, imbalance_ratio, base_imbalance_threshold_,
+                 current_position_ == PositionState::LONG ? "LONG" :
+                 current_position_ == PositionState::SHORT ? "SHORT" : "FLAT");
     }
     
     // Only generate new signals if enough time has passed since the last one
@@ -136,11 +136,23 @@ void OrderBookImbalanceStrategy::onOrderBook(const OrderBookEvent& event) {
 
 void OrderBookImbalanceStrategy::onFill(const FillEvent& event) {
     // Update position state based on fills
-    if (event.direction == OrderDirection::BUY) {
-        std::cout << "Fill received: BUY " << event.quantity << " " << event.symbol << " @ " << event.fill_price << std::endl;
-    } else {
-        std::cout << "Fill received: SELL " << event.quantity << " " << event.symbol << " @ " << event.fill_price << std::endl;
-    }
+    LOG_INFO(kLog, "Fill received: {} {} {} @ {}",
+             event.direction == OrderDirection::BUY ? "BUY" : "SELL",
+             event.quantity, event.symbol, event.fill_price);
+}
+
+void OrderBookImbalanceStrategy::saveState(StateWriter& out) const {
+    Strategy::saveState(out);
+    out.put(imbalance_threshold_);
+    out.put(last_signal_time_);
+    out.put(current_position_);
+}
+
+void OrderBookImbalanceStrategy::loadState(StateReader& in) {
+    Strategy::loadState(in);
+    imbalance_threshold_ = in.get<double>();
+    last_signal_time_ = in.get<long long>();
+    current_position_ = in.get<PositionState>();
 }
 
 void OrderBookImbalanceStrategy::generate_signal(OrderDirection direction) {
@@ -149,13 +161,10 @@ void OrderBookImbalanceStrategy::generate_signal(OrderDirection direction) {
     // Fix 5: Use getName() and getSymbol() from base class
     auto signal = std::make_shared<SignalEvent>(getName(), getSymbol(), timestamp, direction, 0.0, 1.0);
     
-    // Fix 6: Wrap signal in another shared_ptr to match the queue's expected type
-    event_queue_->push(std::make_shared<std::shared_ptr<Event>>(signal));
+    emitSignal(signal);
     
-    std::cout << "\n🚨 SIGNAL GENERATED: " << getSymbol()
-              << " | Direction: " << (direction == OrderDirection::BUY ? "BUY" : "SELL")
-              << " | Time: " << timestamp << std::endl;
-
+    LOG_INFO(kLog, "SIGNAL GENERATED: {} | Direction: {} | Time: {}",
+             getSymbol(), direction == OrderDirection::BUY ? "BUY" : "SELL", timestamp);
 }
 
 void OrderBookImbalanceStrategy::onMarketRegimeChanged(const MarketRegimeChangedEvent& event) {
@@ -166,13 +175,11 @@ void OrderBookImbalanceStrategy::onMarketRegimeChanged(const MarketRegimeChanged
     if (event.new_state.volatility == VolatilityLevel::HIGH) {
         // Adjust thresholds for high volatility
         imbalance_threshold_ = base_imbalance_threshold_ * 1.5;
-        std::cout << "Market regime changed to HIGH_VOLATILITY. Adjusted imbalance threshold to: " 
-                  << imbalance_threshold_ << std::endl;
+        LOG_INFO(kLog, "Market regime changed to HIGH_VOLATILITY. Adjusted imbalance threshold to: {}", imbalance_threshold_);
     } else if (event.new_state.volatility == VolatilityLevel::LOW) {
         // Adjust thresholds for low volatility
         imbalance_threshold_ = base_imbalance_threshold_ * 0.8;
-        std::cout << "Market regime changed to LOW_VOLATILITY. Adjusted imbalance threshold to: " 
-                  << imbalance_threshold_ << std::endl;
+        LOG_INFO(kLog, "Market regime changed to LOW_VOLATILITY. Adjusted imbalance threshold to: {}", imbalance_threshold_);
     } else {
         // Reset to base threshold for other states
         imbalance_threshold_ = base_imbalance_threshold_;
@@ -194,7 +201,7 @@ void OrderBookImbalanceStrategy::onMarketRegimeChanged(const MarketRegimeChanged
             default: trend_str = "UNKNOWN";
         }
         
-        std::cout << "Market regime changed to Vol: " << volatility_str << ", Trend: " << trend_str
-                  << ". Reset to base imbalance threshold: " << imbalance_threshold_ << std::endl;
+        LOG_INFO(kLog, "Market regime changed to Vol: {}, Trend: {}. Reset to base imbalance threshold: {}",
+                 volatility_str, trend_str, imbalance_threshold_);
     }
 }
\ No newline at end of file
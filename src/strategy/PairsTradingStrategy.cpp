@@ -91,8 +91,24 @@ void PairsTradingStrategy::onFill(const FillEvent& event) {
     // Implement fill event handling logic
 }
 
+void PairsTradingStrategy::saveState(StateWriter& out) const {
+    Strategy::saveState(out);
+    out.put(latest_prices_.at(symbol_a_));
+    out.put(latest_prices_.at(symbol_b_));
+    out.putSequence(ratio_history_);
+    out.put(current_position_);
+}
+
+void PairsTradingStrategy::loadState(StateReader& in) {
+    Strategy::loadState(in);
+    latest_prices_[symbol_a_] = in.get<double>();
+    latest_prices_[symbol_b_] = in.get<double>();
+    ratio_history_ = in.getDeque<double>();
+    current_position_ = in.get<PositionState>();
+}
+
 void PairsTradingStrategy::generate_signal(const std::string& signal_symbol, OrderDirection direction) {
     long long timestamp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
     auto signal = std::make_shared<SignalEvent>(name, signal_symbol, timestamp, direction, 0.0, 1.0);
-    event_queue_->push(std::make_shared<std::shared_ptr<Event>>(signal));
+    emitSignal(signal);
 }
\ No newline at end of file
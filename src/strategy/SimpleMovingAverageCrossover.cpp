@@ -17,9 +17,18 @@ SimpleMovingAverageCrossover::SimpleMovingAverageCrossover(
 
 void SimpleMovingAverageCrossover::onMarket(const MarketEvent& event) {
     if (event.symbol != symbol) return;
+    on_price(event.price);
+}
+
+// Historical replays deliver trades rather than bars; trade prices drive the same logic.
+void SimpleMovingAverageCrossover::onTrade(const TradeEvent& event) {
+    if (event.symbol != symbol) return;
+    on_price(event.price);
+}
 
+void SimpleMovingAverageCrossover::on_price(double price) {
     // Add the new price to our deque and maintain the size
-    prices_.push_back(event.price);
+    prices_.push_back(price);
     if (prices_.size() > long_window_) {
         prices_.pop_front();
     }
@@ -67,12 +76,27 @@ void SimpleMovingAverageCrossover::onMarket(const MarketEvent& event) {
     last_long_sma_ = long_sma;
 }
 
-void SimpleMovingAverageCrossover::onTrade(const TradeEvent& event) {}
 void SimpleMovingAverageCrossover::onOrderBook(const OrderBookEvent& event) {}
 void SimpleMovingAverageCrossover::onFill(const FillEvent& event) {}
 void SimpleMovingAverageCrossover::onMarketRegimeChanged(const MarketRegimeChangedEvent& event) {}
 
 
+void SimpleMovingAverageCrossover::saveState(StateWriter& out) const {
+    Strategy::saveState(out);
+    out.putSequence(prices_);
+    out.put(last_short_sma_);
+    out.put(last_long_sma_);
+    out.put(current_position_);
+}
+
+void SimpleMovingAverageCrossover::loadState(StateReader& in) {
+    Strategy::loadState(in);
+    prices_ = in.getDeque<double>();
+    last_short_sma_ = in.get<double>();
+    last_long_sma_ = in.get<double>();
+    current_position_ = in.get<PositionState>();
+}
+
 double SimpleMovingAverageCrossover::calculate_sma(int period) {
     if (prices_.size() < period) {
         return 0.0;
@@ -91,5 +115,5 @@ void SimpleMovingAverageCrossover::generate_signal(OrderDirection direction) {
     // and the base Strategy class provides 'name', 'symbol', and 'event_queue_'
     long long timestamp = std::chrono::high_resolution_clock::now().time_since_epoch().count();
     auto signal = std::make_shared<SignalEvent>(name, symbol, timestamp, direction, 0.0, 1.0);
-    event_queue_->push(std::make_shared<std::shared_ptr<Event>>(signal));
+    emitSignal(signal);
 };
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "strategy/StrategyFactory.h"
 #include "strategy/OrderBookImbalanceStrategy.h"
+#include "strategy/PairsTradingStrategy.h"
+#include "strategy/SimpleMovingAverageCrossover.h"
 #include <stdexcept>
 
 std::shared_ptr<Strategy> StrategyFactory::createStrategy(
@@ -7,16 +9,43 @@ std::shared_ptr<Strategy> StrategyFactory::createStrategy(
     std::shared_ptr<ThreadSafeQueue<std::shared_ptr<Event>>> event_queue,
     std::shared_ptr<DataHandler> data_handler)
 {
-    std::string strategy_name = strategy_config["name"];
-    
+    std::string strategy_name = strategy_config.value("name", "");
+
+    nlohmann::json params = nlohmann::json::object();
+    if (strategy_config.contains("params") && strategy_config["params"].is_object()) {
+        params = strategy_config["params"];
+    }
+
     if (strategy_name == "ORDER_BOOK_IMBALANCE") {
-        auto params = strategy_config["params"];
         return std::make_shared<OrderBookImbalanceStrategy>(
             event_queue, 
             data_handler, 
-            strategy_config["symbol"],
-            params["lookback_levels"], 
-            params["imbalance_threshold"]
+            strategy_config.value("symbol", ""),
+            params.value("lookback_levels", 10),
+            params.value("imbalance_threshold", 1.5)
+        );
+    } else if (strategy_name == "PAIRS_TRADING") {
+        auto symbols = strategy_config.value("symbols", std::vector<std::string>());
+        if (symbols.size() < 2) {
+            throw std::runtime_error("PairsTradingStrategy requires at least 2 symbols.");
+        }
+        return std::make_shared<PairsTradingStrategy>(
+            event_queue,
+            data_handler,
+            strategy_name,
+            symbols[0],
+            symbols[1],
+            params.value("window", 50),
+            params.value("z_score_threshold", 2.0)
+        );
+    } else if (strategy_name == "SMA_CROSSOVER") {
+        return std::make_shared<SimpleMovingAverageCrossover>(
+            event_queue,
+            data_handler,
+            strategy_name,
+            strategy_config.value("symbol", ""),
+            params.value("short_window", 20),
+            params.value("long_window", 50)
         );
     }
     // Add other strategies here with else if
@@ -0,0 +1,480 @@
+// Local stand-in for the Binance stream endpoint. Replays recorded
+// depthUpdate/trade messages to WebSocketDataHandler (or any other client)
+// over a Boost.Beast WebSocket so SHADOW mode can be driven, benchmarked and
+// regression-tested without network access.
+//
+// Input is a JSON-lines file with one raw Binance message per line (single
+// stream or combined-stream envelope). Message timing comes from the event
+// time "E": --speed 1 replays in real time, --speed N N times faster and
+// --speed 0 as fast as the client accepts them.
+//
+// The engine connects with data_handler.live_host/live_port pointing here,
+// live_tls_verify = false (wss://) or live_tls = false (--plain). In SHADOW
+// mode it reports tick-to-signal latency, frame receipt to signal, with its
+// live status. SIGINT/SIGTERM stops the sessions and exits.
+
+#include "../../include/data/BinanceMessageParser.h"
+
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/signal_set.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/beast/websocket.hpp>
+#include <boost/beast/websocket/ssl.hpp>
+#include <nlohmann/json.hpp>
+#include <openssl/evp.h>
+#include <openssl/ec.h>
+#include <openssl/x509.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <csignal>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace websocket = beast::websocket;
+namespace net = boost::asio;
+namespace ssl = boost::asio::ssl;
+using tcp = boost::asio::ip::tcp;
+
+namespace {
+
+// Set on SIGINT/SIGTERM; sessions stop sending and the server exits once they have.
+std::atomic<bool> stopping{false};
+std::mutex stop_mutex;
+std::condition_variable stop_cond;
+
+// Sleeps until `due` unless the server is stopping first; false if it is.
+bool wait_until(std::chrono::steady_clock::time_point due) {
+    std::unique_lock<std::mutex> lock(stop_mutex);
+    return !stop_cond.wait_until(lock, due, [] { return stopping.load(); });
+}
+
+struct ReplayOptions {
+    std::string input_path;
+    std::string address = "127.0.0.1";
+    unsigned short port = 9443;
+    double speed = 1.0;          // 0 = flat-out
+    int loops = 1;               // 0 = forever
+    bool tls = true;
+    std::string cert_path;       // PEM; a self-signed certificate is generated when empty
+    std::string key_path;
+    bool restamp = false;        // Overwrite "E" with the send time (clients timing from "E")
+};
+
+struct RecordedMessage {
+    std::string payload;
+    std::string stream;          // e.g. "btcusdt@depth" or "btcusdt@trade"
+    long long event_time = 0;    // ms
+    size_t event_time_pos = std::string::npos; // Offset of the "E" digits, for --restamp
+    size_t event_time_len = 0;
+};
+
+// Pulls out what the replayer needs from each message.
+class ClassifyingSink : public BinanceMessageSink {
+public:
+    std::string symbol;
+    long long event_time = 0;
+
+    void onDepthBegin(const BinanceDepthHeader& header) override {
+        symbol.assign(header.symbol);
+        event_time = header.event_time;
+    }
+    void onBidLevel(double, double) override {}
+    void onAskLevel(double, double) override {}
+    void onDepthEnd() override {}
+    void onTrade(const BinanceTrade& trade) override {
+        symbol.assign(trade.symbol);
+        event_time = trade.event_time;
+    }
+};
+
+std::string to_lower(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
+    return s;
+}
+
+// "btcusdt@depth@100ms" -> "btcusdt@depth": update speed suffixes don't change which messages match.
+std::string normalize_stream(const std::string& stream) {
+    std::string lower = to_lower(stream);
+    size_t first = lower.find('@');
+    if (first == std::string::npos) return lower;
+    size_t second = lower.find('@', first + 1);
+    return second == std::string::npos ? lower : lower.substr(0, second);
+}
+
+void locate_event_time(RecordedMessage& message) {
+    // The last "E": is the payload's own one when a combined-stream envelope is used.
+    size_t key = message.payload.rfind("\"E\":");
+    if (key == std::string::npos) return;
+    size_t pos = key + 4;
+    while (pos < message.payload.size() && message.payload[pos] == ' ') ++pos;
+    size_t end = pos;
+    while (end < message.payload.size() && std::isdigit(static_cast<unsigned char>(message.payload[end]))) ++end;
+    if (end > pos) {
+        message.event_time_pos = pos;
+        message.event_time_len = end - pos;
+    }
+}
+
+std::vector<RecordedMessage> load_recording(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open recording: " + path);
+    }
+
+    std::vector<RecordedMessage> messages;
+    std::string line;
+    size_t skipped = 0;
+    while (std::getline(file, line)) {
+        if (line.empty()) continue;
+        ClassifyingSink sink;
+        BinanceMessageType type = parse_binance_message(line.data(), line.size(), sink);
+        if (type != BinanceMessageType::DEPTH_UPDATE && type != BinanceMessageType::TRADE) {
+            ++skipped;
+            continue;
+        }
+        RecordedMessage message;
+        message.payload = std::move(line);
+        message.event_time = sink.event_time;
+        message.stream = to_lower(sink.symbol) + (type == BinanceMessageType::DEPTH_UPDATE ? "@depth" : "@trade");
+        locate_event_time(message);
+        messages.push_back(std::move(message));
+    }
+
+    // Replay in event-time order; the recording may interleave several connections.
+    std::stable_sort(messages.begin(), messages.end(), [](const RecordedMessage& a, const RecordedMessage& b) {
+        return a.event_time < b.event_time;
+    });
+
+    std::cout << "Loaded " << messages.size() << " messages from " << path;
+    if (skipped > 0) std::cout << " (" << skipped << " lines skipped)";
+    std::cout << std::endl;
+    return messages;
+}
+
+void use_self_signed_certificate(ssl::context& ctx) {
+    std::unique_ptr<EVP_PKEY_CTX, decltype(&EVP_PKEY_CTX_free)> key_ctx(EVP_PKEY_CTX_new_id(EVP_PKEY_EC, nullptr), EVP_PKEY_CTX_free);
+    EVP_PKEY* raw_key = nullptr;
+    if (!key_ctx || EVP_PKEY_keygen_init(key_ctx.get()) <= 0 ||
+        EVP_PKEY_CTX_set_ec_paramgen_curve_nid(key_ctx.get(), NID_X9_62_prime256v1) <= 0 ||
+        EVP_PKEY_keygen(key_ctx.get(), &raw_key) <= 0) {
+        throw std::runtime_error("Failed to generate TLS key");
+    }
+    std::unique_ptr<EVP_PKEY, decltype(&EVP_PKEY_free)> key(raw_key, EVP_PKEY_free);
+
+    std::unique_ptr<X509, decltype(&X509_free)> cert(X509_new(), X509_free);
+    X509_set_version(cert.get(), 2);
+    ASN1_INTEGER_set(X509_get_serialNumber(cert.get()), 1);
+    X509_gmtime_adj(X509_getm_notBefore(cert.get()), 0);
+    X509_gmtime_adj(X509_getm_notAfter(cert.get()), 7 * 24 * 3600);
+    X509_set_pubkey(cert.get(), key.get());
+    X509_NAME* name = X509_get_subject_name(cert.get());
+    X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+    X509_set_issuer_name(cert.get(), name);
+    if (X509_sign(cert.get(), key.get(), EVP_sha256()) <= 0 ||
+        SSL_CTX_use_certificate(ctx.native_handle(), cert.get()) != 1 ||
+        SSL_CTX_use_PrivateKey(ctx.native_handle(), key.get()) != 1) {
+        throw std::runtime_error("Failed to install self-signed certificate");
+    }
+}
+
+// Streams named in the request target, e.g. /ws/btcusdt@trade or /stream?streams=a/b.
+std::set<std::string> streams_from_target(std::string target) {
+    std::set<std::string> streams;
+    size_t query = target.find("streams=");
+    if (query != std::string::npos) {
+        target = target.substr(query + 8);
+    } else if (target.rfind("/ws/", 0) == 0) {
+        target = target.substr(4);
+    } else {
+        return streams;
+    }
+    size_t start = 0;
+    while (start <= target.size()) {
+        size_t end = target.find('/', start);
+        std::string stream = target.substr(start, end == std::string::npos ? std::string::npos : end - start);
+        if (!stream.empty()) streams.insert(normalize_stream(stream));
+        if (end == std::string::npos) break;
+        start = end + 1;
+    }
+    return streams;
+}
+
+template <class Stream>
+void replay_session(websocket::stream<Stream>& ws, const std::string& target,
+                    const std::vector<RecordedMessage>& messages, const ReplayOptions& options) {
+    std::set<std::string> streams = streams_from_target(target);
+
+    // Clients on the bare /ws endpoint subscribe with the same message connect() sends.
+    beast::flat_buffer buffer;
+    while (streams.empty()) {
+        ws.read(buffer);
+        auto request = nlohmann::json::parse(beast::buffers_to_string(buffer.data()), nullptr, false);
+        buffer.consume(buffer.size());
+        if (request.is_discarded() || request.value("method", "") != "SUBSCRIBE" || !request.contains("params")) {
+            std::cerr << "Ignoring unexpected client message" << std::endl;
+            continue;
+        }
+        for (const auto& stream : request["params"]) {
+            if (stream.is_string()) streams.insert(normalize_stream(stream.get<std::string>()));
+        }
+        ws.text(true);
+        ws.write(net::buffer(nlohmann::json({{"result", nullptr}, {"id", request.value("id", 0)}}).dump()));
+    }
+
+    std::cout << "Client subscribed to " << streams.size() << " stream(s)" << std::endl;
+
+    ws.text(true);
+    std::string restamped;
+    size_t sent = 0;
+    size_t sent_this_second = 0;
+    double max_lag_ms = 0.0;
+    const auto session_start = std::chrono::steady_clock::now();
+    auto second_start = session_start;
+
+    for (int loop = 0; !stopping && (options.loops == 0 || loop < options.loops); ++loop) {
+        const auto loop_start = std::chrono::steady_clock::now();
+        const long long first_event_time = messages.empty() ? 0 : messages.front().event_time;
+
+        for (const auto& message : messages) {
+            if (stopping) break;
+            if (!streams.count(message.stream)) continue;
+
+            if (options.speed > 0) {
+                auto offset = std::chrono::duration<double, std::milli>((message.event_time - first_event_time) / options.speed);
+                auto due = loop_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(offset);
+                auto now = std::chrono::steady_clock::now();
+                if (due > now) {
+                    if (!wait_until(due)) break;
+                } else {
+                    max_lag_ms = std::max(max_lag_ms, std::chrono::duration<double, std::milli>(now - due).count());
+                }
+            }
+
+            const std::string* payload = &message.payload;
+            if (options.restamp && message.event_time_pos != std::string::npos) {
+                std::string now_ms = std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::system_clock::now().time_since_epoch()).count());
+                restamped = message.payload;
+                restamped.replace(message.event_time_pos, message.event_time_len, now_ms);
+                payload = &restamped;
+            }
+            ws.write(net::buffer(*payload));
+            ++sent;
+            ++sent_this_second;
+
+            auto now = std::chrono::steady_clock::now();
+            if (now - second_start >= std::chrono::seconds(1)) {
+                std::cout << "  " << sent_this_second << " msg/s";
+                if (options.speed > 0) std::cout << " | max lag behind schedule " << std::fixed << std::setprecision(1) << max_lag_ms << " ms";
+                std::cout << std::endl;
+                sent_this_second = 0;
+                second_start = now;
+            }
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - session_start).count();
+    std::cout << "Replay finished: " << sent << " messages in " << std::fixed << std::setprecision(2) << seconds << " s";
+    if (seconds > 0) std::cout << " (" << std::setprecision(0) << sent / seconds << " msg/s)";
+    if (options.speed > 0) std::cout << ", max lag behind schedule " << std::setprecision(1) << max_lag_ms << " ms";
+    std::cout << std::endl;
+
+    ws.close(websocket::close_code::normal);
+}
+
+template <class Stream>
+void accept_and_replay(Stream& stream, const std::vector<RecordedMessage>& messages, const ReplayOptions& options) {
+    // Read the upgrade request ourselves so the target (and any streams in it) is known.
+    beast::flat_buffer buffer;
+    http::request<http::string_body> request;
+    http::read(stream, buffer, request);
+
+    websocket::stream<Stream&> ws(stream);
+    ws.accept(request);
+    replay_session(ws, std::string(request.target()), messages, options);
+}
+
+// A client being served on its own thread. The socket stays with the server
+// so that shutdown can unblock the session's reads and writes.
+struct Session {
+    std::unique_ptr<tcp::socket> socket;
+    std::thread thread;
+    std::atomic<bool> done{false};
+};
+
+void handle_connection(tcp::socket& socket, ssl::context* tls_context,
+                       const std::vector<RecordedMessage>& messages, const ReplayOptions& options) {
+    beast::error_code peer_ec;
+    std::string peer = socket.remote_endpoint(peer_ec).address().to_string();
+    try {
+        if (tls_context) {
+            beast::ssl_stream<tcp::socket&> stream(socket, *tls_context);
+            stream.handshake(ssl::stream_base::server);
+            accept_and_replay(stream, messages, options);
+        } else {
+            accept_and_replay(socket, messages, options);
+        }
+    } catch (const beast::system_error& e) {
+        if (e.code() != websocket::error::closed) {
+            std::cerr << "Session with " << peer << " ended: " << e.code().message() << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Session with " << peer << " failed: " << e.what() << std::endl;
+    }
+}
+
+void print_usage() {
+    std::cout << "Usage: feed_replayer <messages.jsonl> [options]\n"
+              << "Replays recorded Binance depthUpdate/trade messages over a local WebSocket.\n\n"
+              << "  --port N         Listen port (default 9443)\n"
+              << "  --address A      Listen address (default 127.0.0.1)\n"
+              << "  --speed X        1 = real time, N = N times faster, 0 = flat-out (default 1)\n"
+              << "  --loop N         Replay the recording N times, 0 = forever (default 1)\n"
+              << "  --plain          Serve ws:// instead of wss:// (engine: data_handler.live_tls = false)\n"
+              << "  --cert F --key F PEM certificate and key (default: generated self-signed)\n"
+              << "  --restamp        Replace each event time \"E\" with the send time\n";
+}
+
+ReplayOptions parse_options(int argc, char* argv[]) {
+    ReplayOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument("Missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--port") options.port = static_cast<unsigned short>(std::stoi(next()));
+        else if (arg == "--address") options.address = next();
+        else if (arg == "--speed") options.speed = std::stod(next());
+        else if (arg == "--loop") options.loops = std::stoi(next());
+        else if (arg == "--plain") options.tls = false;
+        else if (arg == "--cert") options.cert_path = next();
+        else if (arg == "--key") options.key_path = next();
+        else if (arg == "--restamp") options.restamp = true;
+        else if (!arg.empty() && arg[0] == '-') throw std::invalid_argument("Unknown option: " + arg);
+        else options.input_path = arg;
+    }
+    if (options.input_path.empty()) throw std::invalid_argument("No recording given");
+    if (options.speed < 0) throw std::invalid_argument("--speed must be >= 0");
+    if (options.cert_path.empty() != options.key_path.empty()) throw std::invalid_argument("--cert and --key go together");
+    return options;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    ReplayOptions options;
+    try {
+        options = parse_options(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << "\n\n";
+        print_usage();
+        return 1;
+    }
+
+    try {
+        const std::vector<RecordedMessage> messages = load_recording(options.input_path);
+
+        std::unique_ptr<ssl::context> tls_context;
+        if (options.tls) {
+            tls_context = std::make_unique<ssl::context>(ssl::context::tlsv12_server);
+            if (options.cert_path.empty()) {
+                use_self_signed_certificate(*tls_context);
+            } else {
+                tls_context->use_certificate_chain_file(options.cert_path);
+                tls_context->use_private_key_file(options.key_path, ssl::context::pem);
+            }
+        }
+
+        net::io_context ioc;
+        tcp::acceptor acceptor(ioc, {net::ip::make_address(options.address), options.port});
+        std::cout << "Replaying on " << (options.tls ? "wss://" : "ws://") << options.address << ":" << options.port
+                  << " at " << (options.speed > 0 ? std::to_string(options.speed) + "x" : std::string("full speed"))
+                  << std::endl;
+
+        // One thread per client; sessions only read the shared recording.
+        // Finished sessions are joined as new clients arrive, the rest on shutdown.
+        std::list<Session> sessions;
+        auto reap = [&sessions] {
+            for (auto it = sessions.begin(); it != sessions.end();) {
+                if (it->done) {
+                    it->thread.join();
+                    it = sessions.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        };
+        std::function<void()> accept_next = [&] {
+            acceptor.async_accept([&](beast::error_code ec, tcp::socket socket) {
+                if (ec == net::error::operation_aborted) {
+                    return; // Shutting down
+                }
+                if (ec) {
+                    std::cerr << "Accept failed: " << ec.message() << std::endl;
+                } else {
+                    reap();
+                    beast::error_code peer_ec;
+                    std::cout << "Client connected from " << socket.remote_endpoint(peer_ec) << std::endl;
+                    Session& session = sessions.emplace_back();
+                    session.socket = std::make_unique<tcp::socket>(std::move(socket));
+                    session.thread = std::thread([&session, &tls_context, &messages, &options] {
+                        handle_connection(*session.socket, tls_context.get(), messages, options);
+                        session.done = true;
+                    });
+                }
+                accept_next();
+            });
+        };
+
+        net::signal_set signals(ioc, SIGINT, SIGTERM);
+        signals.async_wait([&](beast::error_code ec, int) {
+            if (ec) return;
+            std::cout << "Shutting down..." << std::endl;
+            {
+                std::lock_guard<std::mutex> lock(stop_mutex);
+                stopping = true;
+            }
+            stop_cond.notify_all();
+            acceptor.close();
+        });
+
+        accept_next();
+        ioc.run();
+
+        // Sessions still blocked on their client (e.g. waiting for a SUBSCRIBE) are woken by the shutdown.
+        for (auto& session : sessions) {
+            if (!session.done) {
+                beast::error_code ignored;
+                session.socket->shutdown(tcp::socket::shutdown_both, ignored);
+            }
+        }
+        for (auto& session : sessions) {
+            session.thread.join();
+        }
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
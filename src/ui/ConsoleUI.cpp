@@ -4,6 +4,7 @@
 #include "../../include/core/Optimizer.h"
 #include "../../include/core/WalkForwardAnalyzer.h"
 #include "../../include/core/MonteCarloSimulator.h"
+#include "../../include/core/AsyncLogger.h"
 #include "../../include/analytics/Analytics.h"
 
 #include <iostream>
@@ -67,6 +68,14 @@ void ConsoleUI::loadConfig() {
             {"max_drawdown_pct", config.risk.max_drawdown_pct}
         };
         
+        config_["logging"] = {
+            {"level", config.logging.level},
+            {"file", config.logging.file},
+            {"rate_limit_per_sec", config.logging.rate_limit_per_sec},
+            {"components", config.logging.component_levels}
+        };
+        AsyncLogger::instance().configure(config_["logging"]);
+        
     } catch (const std::exception& e) {
         std::cerr << "Configuration Error: " << e.what() << std::endl;
         std::cerr << "Using default configuration." << std::endl;
@@ -130,6 +139,14 @@ void ConsoleUI::saveConfig() {
             }
         }
         
+        if (config_.contains("logging") && config_["logging"].is_object()) {
+            auto logging = config_["logging"];
+            config.logging.level = logging.value("level", "INFO");
+            config.logging.file = logging.value("file", "");
+            config.logging.rate_limit_per_sec = logging.value("rate_limit_per_sec", 0u);
+            config.logging.component_levels = logging.value("components", std::map<std::string, std::string>());
+        }
+        
         // Save using the type-safe method
         config.saveToFile("config.json");
         
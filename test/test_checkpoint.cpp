@@ -0,0 +1,179 @@
+#include "gtest/gtest.h"
+#include "core/Checkpoint.h"
+#include "core/Portfolio.h"
+#include "data/DataHandler.h"
+#include "event/Event.h"
+#include <filesystem>
+#include <limits>
+#include <memory>
+#include <string>
+
+TEST(StateWriterTest, RoundTripPreservesValuesInOrder) {
+    Bar bar{"BTCUSDT", "1720828800000", 100.0, 101.0, 99.5, 100.5, 12};
+    OrderBook book;
+    book.symbol = "ETHUSDT";
+    book.timestamp = 1720828800123;
+    book.bids = {{10.0, 1.5}, {9.5, 2.0}};
+    book.asks = {{10.5, 0.25}};
+
+    StateWriter out;
+    out.put<int32_t>(-7);
+    out.put(3.25);
+    out.put(true);
+    out.put(std::string("momentum"));
+    out.put(bar);
+    out.put(book);
+    out.putVarint(0);
+    out.putVarint(127);
+    out.putVarint(128);
+    out.putVarint(std::numeric_limits<uint64_t>::max());
+    out.putSignedVarint(-1);
+    out.putSignedVarint(std::numeric_limits<int64_t>::min());
+    out.putSequence(std::deque<double>{1.0, 2.0, 3.0});
+
+    StateReader in(out.bytes().data(), out.bytes().size());
+    EXPECT_EQ(in.get<int32_t>(), -7);
+    EXPECT_EQ(in.get<double>(), 3.25);
+    EXPECT_EQ(in.get<uint8_t>(), 1);
+    EXPECT_EQ(in.getString(), "momentum");
+    const Bar loaded_bar = in.getBar();
+    EXPECT_EQ(loaded_bar.symbol, "BTCUSDT");
+    EXPECT_EQ(loaded_bar.timestamp, "1720828800000");
+    EXPECT_EQ(loaded_bar.close, 100.5);
+    EXPECT_EQ(loaded_bar.volume, 12);
+    const OrderBook loaded_book = in.getOrderBook();
+    EXPECT_EQ(loaded_book.symbol, "ETHUSDT");
+    EXPECT_EQ(loaded_book.timestamp, 1720828800123);
+    EXPECT_EQ(loaded_book.bids, book.bids);
+    EXPECT_EQ(loaded_book.asks, book.asks);
+    EXPECT_EQ(in.getVarint(), 0u);
+    EXPECT_EQ(in.getVarint(), 127u);
+    EXPECT_EQ(in.getVarint(), 128u);
+    EXPECT_EQ(in.getVarint(), std::numeric_limits<uint64_t>::max());
+    EXPECT_EQ(in.getSignedVarint(), -1);
+    EXPECT_EQ(in.getSignedVarint(), std::numeric_limits<int64_t>::min());
+    EXPECT_EQ(in.getDeque<double>(), (std::deque<double>{1.0, 2.0, 3.0}));
+    EXPECT_TRUE(in.atEnd());
+}
+
+TEST(StateWriterTest, SmallVarintsTakeOneByte) {
+    StateWriter out;
+    out.putVarint(127);
+    out.putSignedVarint(-64);
+    EXPECT_EQ(out.bytes().size(), 2u);
+}
+
+TEST(StateWriterTest, SectionsAreFoundByTag) {
+    StateWriter out;
+    out.section(CheckpointSection::RISK, [](StateWriter& s) { s.put<uint32_t>(2); });
+    out.section(CheckpointSection::DATA, [](StateWriter& s) { s.put(std::string("cursor")); });
+
+    StateReader in(out.bytes().data(), out.bytes().size());
+    auto sections = in.sections();
+    ASSERT_EQ(sections.size(), 2u);
+    EXPECT_EQ(sections.at(CheckpointSection::DATA).getString(), "cursor");
+    EXPECT_EQ(sections.at(CheckpointSection::RISK).get<uint32_t>(), 2u);
+    EXPECT_TRUE(sections.at(CheckpointSection::RISK).atEnd());
+    EXPECT_EQ(sections.count(CheckpointSection::PORTFOLIO), 0u);
+}
+
+TEST(StateReaderTest, TruncatedInputThrows) {
+    StateWriter out;
+    out.put(std::string("truncated"));
+    StateReader short_read(out.bytes().data(), out.bytes().size() - 1);
+    EXPECT_THROW(short_read.getString(), std::runtime_error);
+
+    const char unterminated[] = {'\x80', '\x80'};
+    StateReader varint(unterminated, sizeof(unterminated));
+    EXPECT_THROW(varint.getVarint(), std::runtime_error);
+}
+
+namespace {
+
+class StubDataHandler : public DataHandler {
+public:
+    void updateBars() override {}
+    bool isFinished() const override { return true; }
+    std::optional<Bar> getLatestBar(const std::string&) const override { return std::nullopt; }
+    double getLatestBarValue(const std::string&, const std::string&) override { return 0.0; }
+    std::vector<Bar> getLatestBars(const std::string&, int) override { return {}; }
+    std::optional<OrderBook> getLatestOrderBook(const std::string&) const override { return std::nullopt; }
+    const std::vector<std::string>& getSymbols() const override { return symbols_; }
+    void notifyOnNewData(std::function<void()>) override {}
+
+private:
+    std::vector<std::string> symbols_{"TEST"};
+};
+
+} // namespace
+
+class CheckpointFileTest : public ::testing::Test {
+protected:
+    std::string dir = "test_checkpoints";
+
+    void SetUp() override { std::filesystem::remove_all(dir); }
+    void TearDown() override { std::filesystem::remove_all(dir); }
+
+    std::shared_ptr<Portfolio> makePortfolio() {
+        return std::make_shared<Portfolio>(std::make_shared<ThreadSafeQueue<std::shared_ptr<Event>>>(),
+                                           100000.0, std::make_shared<StubDataHandler>());
+    }
+
+    static CheckpointHeader header(long long market_time, long long event_count) {
+        CheckpointHeader h{};
+        h.magic = CHECKPOINT_MAGIC;
+        h.version = CHECKPOINT_VERSION;
+        h.fingerprint = 42;
+        h.market_time = market_time;
+        h.event_count = event_count;
+        return h;
+    }
+};
+
+TEST_F(CheckpointFileTest, FindsTheLatestCheckpointAtOrBefore) {
+    for (long long time : {1000, 2000, 3000}) {
+        checkpoint::write(checkpoint::pathFor(dir, time), header(time, time / 10), "");
+    }
+    EXPECT_EQ(checkpoint::findAtOrBefore(dir, 2500), checkpoint::pathFor(dir, 2000));
+    EXPECT_EQ(checkpoint::findAtOrBefore(dir, 3000), checkpoint::pathFor(dir, 3000));
+    EXPECT_EQ(checkpoint::findAtOrBefore(dir, -1), checkpoint::pathFor(dir, 3000));
+    EXPECT_FALSE(checkpoint::findAtOrBefore(dir, 999).has_value());
+    EXPECT_FALSE(checkpoint::findAtOrBefore("no_such_dir", -1).has_value());
+}
+
+TEST_F(CheckpointFileTest, RejectsFilesThatAreNotCheckpoints) {
+    auto bad = header(1000, 0);
+    bad.version = CHECKPOINT_VERSION + 1;
+    const std::string path = checkpoint::pathFor(dir, 1000);
+    checkpoint::write(path, bad, "");
+    EXPECT_THROW(checkpoint::read(path), std::runtime_error);
+}
+
+TEST_F(CheckpointFileTest, PortfolioSurvivesSaveAndRestore) {
+    auto original = makePortfolio();
+    original->setMarketTime(1720828800000);
+    original->onFill(FillEvent(1720828800000, "TEST", "momentum", OrderDirection::BUY, 10, 100.0, 5.0));
+    original->setMarketTime(1720828801000);
+    original->onFill(FillEvent(1720828801000, "TEST", "momentum", OrderDirection::SELL, 4, 110.0, 2.0));
+
+    StateWriter body;
+    body.section(CheckpointSection::PORTFOLIO, [&](StateWriter& out) { original->saveState(out); });
+    const std::string path = checkpoint::pathFor(dir, original->marketTime());
+    checkpoint::write(path, header(original->marketTime(), 2), body.bytes());
+
+    auto loaded = checkpoint::read(path);
+    EXPECT_EQ(loaded.header.market_time, 1720828801000);
+    EXPECT_EQ(loaded.header.event_count, 2);
+    EXPECT_EQ(loaded.header.fingerprint, 42u);
+    StateReader reader(loaded.body.data(), loaded.body.size());
+    auto sections = reader.sections();
+    auto restored = makePortfolio();
+    restored->loadState(sections.at(CheckpointSection::PORTFOLIO));
+
+    EXPECT_TRUE(sections.at(CheckpointSection::PORTFOLIO).atEnd());
+    EXPECT_EQ(restored->marketTime(), original->marketTime());
+    EXPECT_EQ(restored->get_cash(), original->get_cash());
+    EXPECT_EQ(restored->get_position("TEST"), 6.0);
+    EXPECT_EQ(restored->get_total_equity(), original->get_total_equity());
+    EXPECT_EQ(restored->get_max_drawdown(), original->get_max_drawdown());
+}
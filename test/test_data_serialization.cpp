@@ -0,0 +1,80 @@
+#include "gtest/gtest.h"
+#include "data/serialization/DataSerialization.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class BarSerializationTest : public ::testing::Test {
+protected:
+    std::string path = "test_bars.bin";
+    std::vector<Bar> bars;
+
+    void SetUp() override {
+        bars.push_back(Bar{"BTCUSDT", "1720828800000", 100.0, 101.0, 99.5, 100.5, 12});
+        bars.push_back(Bar{"ETHUSDT", "1720828800000", 10.0, 10.5, 9.5, 10.25, 7});
+        bars.push_back(Bar{"BTCUSDT", "1720828801000", 100.5, 102.0, 100.0, 101.75, 30});
+    }
+
+    void TearDown() override { std::remove(path.c_str()); }
+};
+
+TEST_F(BarSerializationTest, RoundTripPreservesBarsGroupedBySymbol) {
+    serialization::serialize_bars(bars, path);
+    auto loaded = serialization::deserialize_bars(path);
+
+    ASSERT_EQ(loaded.size(), 3u);
+    EXPECT_EQ(loaded[0].symbol, "BTCUSDT");
+    EXPECT_EQ(loaded[0].timestamp, "1720828800000");
+    EXPECT_EQ(loaded[1].symbol, "BTCUSDT");
+    EXPECT_EQ(loaded[1].close, 101.75);
+    EXPECT_EQ(loaded[2].symbol, "ETHUSDT");
+    EXPECT_EQ(loaded[2].volume, 7);
+}
+
+TEST_F(BarSerializationTest, MappedFileExposesColumnsWithoutCopying) {
+    serialization::serialize_bars(bars, path);
+    serialization::MappedBarFile file(path);
+
+    EXPECT_EQ(file.version(), serialization::BAR_FILE_VERSION);
+    EXPECT_EQ(file.rowCount(), 3u);
+
+    auto btc = file.series("BTCUSDT");
+    ASSERT_TRUE(btc.has_value());
+    ASSERT_EQ(btc->size, 2u);
+    EXPECT_EQ(btc->timestamp[1], 1720828801000LL);
+    EXPECT_EQ(btc->high[1], 102.0);
+    EXPECT_FALSE(file.series("XRPUSDT").has_value());
+}
+
+TEST_F(BarSerializationTest, RejectsNonNumericTimestamps) {
+    bars[0].timestamp = "2025-07-13 00:00:00";
+    EXPECT_THROW(serialization::serialize_bars(bars, path), std::invalid_argument);
+}
+
+TEST_F(BarSerializationTest, RejectsColumnBlocksPastTheEndOfTheFile) {
+    // Rewrites the first symbol's entry, keeping the header's total in step
+    // so that only the range check can catch it.
+    const auto corrupt = [this](uint64_t columns_offset, uint64_t row_count) {
+        serialization::serialize_bars(bars, path);
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        serialization::BarFileHeader header;
+        serialization::BarFileSymbolEntry entry;
+        file.read(reinterpret_cast<char*>(&header), sizeof(header));
+        file.read(reinterpret_cast<char*>(&entry), sizeof(entry));
+        header.row_count += row_count - entry.row_count;
+        entry.columns_offset = columns_offset;
+        entry.row_count = row_count;
+        file.seekp(0);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+    };
+    const uint64_t first_column = sizeof(serialization::BarFileHeader) + 2 * sizeof(serialization::BarFileSymbolEntry);
+
+    // Offset + size wraps around to the first column.
+    corrupt(first_column - 32 * 8 * 6, 32); // Six columns
+    EXPECT_THROW(serialization::MappedBarFile file(path), std::runtime_error);
+    // Row count * 8 wraps around to 8.
+    corrupt(first_column, (1ULL << 61) + 1);
+    EXPECT_THROW(serialization::MappedBarFile file(path), std::runtime_error);
+}
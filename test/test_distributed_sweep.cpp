@@ -0,0 +1,111 @@
+#include "gtest/gtest.h"
+#include "core/DistributedSweep.h"
+#include <boost/asio/buffers_iterator.hpp>
+#include <boost/asio/connect.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/read_until.hpp>
+#include <boost/asio/streambuf.hpp>
+#include <boost/asio/write.hpp>
+#include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <set>
+#include <thread>
+
+namespace net = boost::asio;
+using tcp = boost::asio::ip::tcp;
+
+// A coordinator on a loopback port picked by the OS, a worker that takes a
+// shard and dies, and a real worker that has to pick that shard up.
+class DistributedSweepTest : public ::testing::Test {
+protected:
+    std::string dir = "test_sweep_data";
+    json config;
+    std::vector<BatchJob> jobs;
+
+    void SetUp() override {
+        std::filesystem::create_directories(dir);
+        std::ofstream trades(dir + "/BTC-trades.csv");
+        trades << "timestamp,price,quantity,side\n";
+        for (int i = 0; i < 400; ++i) {
+            trades << 1752400000000LL + i * 1000 << ',' << 100.0 + (i % 40 < 20 ? i % 20 : 20 - i % 20) << ",0.5,"
+                   << (i % 2 ? "BUY" : "SELL") << '\n';
+        }
+        config = {
+            {"run_mode", "BACKTEST"},
+            {"symbols", {"BTC"}},
+            {"initial_capital", 100000.0},
+            {"data", {{"start_date", "2025-07-13"}, {"end_date", "2025-07-13"}, {"historical_data_fallback_dir", dir}}},
+            {"strategies", json::array()}};
+        for (int window : {5, 10}) {
+            json strategies = json::array({{{"name", "SMA_CROSSOVER"}, {"symbol", "BTC"}, {"active", true},
+                                            {"params", {{"short_window", window}, {"long_window", 30}}}}});
+            jobs.push_back({"sma-" + std::to_string(window), {{"strategies", strategies}}});
+        }
+    }
+
+    void TearDown() override { std::filesystem::remove_all(dir); }
+};
+
+TEST_F(DistributedSweepTest, ShardOfAKilledWorkerIsRequeued) {
+    DistributedOptions options;
+    options.port = 0;
+    options.shard_size = 1;
+    options.heartbeat_ms = 50;
+    options.heartbeat_timeout_ms = 5000;
+    SweepCoordinator coordinator(config, jobs, options);
+
+    std::mutex mutex;
+    std::condition_variable listening;
+    unsigned short port = 0;
+    std::vector<std::string> arrived;
+    coordinator.onListening([&](unsigned short p) {
+        std::lock_guard<std::mutex> lock(mutex);
+        port = p;
+        listening.notify_one();
+    });
+    coordinator.onResult([&](const BatchResult& result) { arrived.push_back(result.id); });
+
+    std::vector<BatchResult> results;
+    std::thread coordinator_thread([&]() { results = coordinator.run(); });
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        ASSERT_TRUE(listening.wait_for(lock, std::chrono::seconds(10), [&]() { return port != 0; }));
+    }
+    EXPECT_EQ(options.address, "127.0.0.1");
+
+    // The first worker takes shard 0 and is killed before it answers.
+    net::io_context io;
+    tcp::socket doomed(io);
+    doomed.connect(tcp::endpoint(net::ip::make_address("127.0.0.1"), port));
+    net::write(doomed, net::buffer(json{{"type", "hello"}, {"worker", "doomed"}, {"threads", 1}}.dump() + "\n"));
+    net::streambuf buffer;
+    auto receive = [&]() {
+        const size_t bytes = net::read_until(doomed, buffer, '\n');
+        const auto data = buffer.data();
+        const std::string line(net::buffers_begin(data), net::buffers_begin(data) + bytes);
+        buffer.consume(bytes);
+        return json::parse(line);
+    };
+    EXPECT_EQ(receive().value("type", ""), "config");
+    const json shard = receive();
+    ASSERT_EQ(shard.value("type", ""), "shard");
+    EXPECT_EQ(shard.value("shard", 99), 0);
+
+    std::thread worker_thread([&]() { SweepWorker(options, 1).runTcp("127.0.0.1", port, 5000); });
+    doomed.close();
+
+    worker_thread.join();
+    coordinator_thread.join();
+
+    ASSERT_EQ(results.size(), 2u);
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        EXPECT_EQ(results[i].id, jobs[i].id);
+        EXPECT_TRUE(results[i].ok) << results[i].error;
+        EXPECT_GT(results[i].events, 0);
+    }
+    EXPECT_EQ(std::set<std::string>(arrived.begin(), arrived.end()), (std::set<std::string>{"sma-5", "sma-10"}));
+    EXPECT_EQ(arrived.size(), 2u);
+}
@@ -0,0 +1,153 @@
+#include "gtest/gtest.h"
+#include "core/EquityRecorder.h"
+#include <cmath>
+#include <vector>
+
+namespace {
+
+MarketState state(VolatilityLevel volatility, TrendDirection trend, double value) {
+    MarketState s;
+    s.volatility = volatility;
+    s.trend = trend;
+    s.volatility_value = value;
+    return s;
+}
+
+void expect_same_point(const EquityPoint& actual, const EquityPoint& expected) {
+    EXPECT_EQ(std::get<0>(actual), std::get<0>(expected));
+    EXPECT_EQ(std::get<1>(actual), std::get<1>(expected)); // Bit-exact, not approximate
+    EXPECT_EQ(std::get<2>(actual).volatility, std::get<2>(expected).volatility);
+    EXPECT_EQ(std::get<2>(actual).trend, std::get<2>(expected).trend);
+    EXPECT_EQ(std::get<2>(actual).volatility_value, std::get<2>(expected).volatility_value);
+}
+
+} // namespace
+
+TEST(EquityRecorderTest, DecodesExactlyWhatWasRecorded) {
+    const MarketState calm = state(VolatilityLevel::LOW, TrendDirection::SIDEWAYS, 0.01);
+    const MarketState stormy = state(VolatilityLevel::HIGH, TrendDirection::TRENDING_DOWN, 0.2);
+    std::vector<EquityPoint> recorded;
+    double equity = 100000.0;
+    for (int i = 0; i < 1000; ++i) {
+        // Unchanged values, small moves, large jumps, and time running backwards once
+        if (i % 3 == 1) equity += 0.01 * (i % 7);
+        if (i % 97 == 0) equity *= 0.5;
+        const long long time = 1720828800000LL + i * 250 - (i == 500 ? 10000 : 0);
+        recorded.emplace_back(time, equity, i < 600 ? calm : stormy);
+    }
+    recorded.emplace_back(1720829100000LL, -1234.5, stormy);
+    recorded.emplace_back(1720829100001LL, 0.0, stormy);
+
+    EquityRecorder recorder;
+    for (const auto& [time, value, market_state] : recorded) {
+        recorder.record(time, value, market_state);
+    }
+    ASSERT_EQ(recorder.size(), recorded.size());
+    EXPECT_LT(recorder.encodedBytes(), recorded.size() * sizeof(EquityPoint) / 4);
+
+    const auto decoded = recorder.points();
+    ASSERT_EQ(decoded.size(), recorded.size());
+    for (size_t i = 0; i < recorded.size(); ++i) {
+        SCOPED_TRACE(i);
+        expect_same_point(decoded[i], recorded[i]);
+    }
+}
+
+TEST(EquityRecorderTest, SampledCurveKeepsStateChangesAndTheLatestPoint) {
+    EquityResolution resolution;
+    resolution.mode = EquityResolution::Mode::EVERY_N;
+    resolution.every_n = 10;
+    EquityRecorder recorder(resolution);
+    const MarketState calm = state(VolatilityLevel::LOW, TrendDirection::TRENDING_UP, 0.01);
+    const MarketState stormy = state(VolatilityLevel::HIGH, TrendDirection::TRENDING_UP, 0.3);
+    for (int i = 0; i < 95; ++i) {
+        recorder.record(i, 1000.0 + i, i == 33 ? stormy : calm);
+    }
+    EXPECT_EQ(recorder.offered(), 95);
+
+    const auto points = recorder.points();
+    std::vector<long long> times;
+    for (const auto& point : points) {
+        times.push_back(std::get<0>(point));
+    }
+    // Every tenth point, the state changes at 33 and 34, and the latest point
+    EXPECT_EQ(times, (std::vector<long long>{0, 10, 20, 30, 33, 34, 40, 50, 60, 70, 80, 90, 94}));
+    EXPECT_EQ(std::get<1>(points.back()), 1094.0);
+}
+
+TEST(EquityRecorderTest, StateRoundTripContinuesTheCurve) {
+    EquityResolution resolution;
+    resolution.mode = EquityResolution::Mode::EVERY_N;
+    resolution.every_n = 4;
+    const MarketState calm = state(VolatilityLevel::NORMAL, TrendDirection::SIDEWAYS, 0.05);
+    EquityRecorder original(resolution);
+    for (int i = 0; i < 10; ++i) {
+        original.record(i * 1000, 500.0 - i, calm);
+    }
+
+    StateWriter out;
+    original.saveState(out);
+    StateReader in(out.bytes().data(), out.bytes().size());
+    EquityRecorder restored(resolution);
+    restored.loadState(in);
+    EXPECT_TRUE(in.atEnd());
+
+    for (int i = 10; i < 20; ++i) {
+        original.record(i * 1000, 500.0 - i, calm);
+        restored.record(i * 1000, 500.0 - i, calm);
+    }
+    EXPECT_EQ(restored.offered(), original.offered());
+    const auto expected = original.points();
+    const auto actual = restored.points();
+    ASSERT_EQ(actual.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        expect_same_point(actual[i], expected[i]);
+    }
+}
+
+TEST(LttbTest, ReturnsEveryPointWhenThereAreNoMoreThanTheThreshold) {
+    std::vector<EquityPoint> points;
+    for (int i = 0; i < 10; ++i) {
+        points.emplace_back(i, i * 2.0, MarketState());
+    }
+    EXPECT_EQ(EquityRecorder::lttb(points, 10).size(), 10u);
+    EXPECT_EQ(EquityRecorder::lttb(points, 50).size(), 10u);
+    EXPECT_EQ(EquityRecorder::lttb(points, 2).size(), 10u); // Fewer than 3 can't keep both ends
+    EXPECT_TRUE(EquityRecorder::lttb({}, 5).empty());
+}
+
+TEST(LttbTest, KeepsTheEndsAndTheExtremes) {
+    std::vector<EquityPoint> points;
+    for (int i = 0; i < 1000; ++i) {
+        double equity = 100.0 + std::sin(i * 0.01);
+        if (i == 437) equity = 300.0;  // A spike
+        if (i == 812) equity = -50.0;  // A crash
+        points.emplace_back(1000 + i, equity, MarketState());
+    }
+
+    const auto sampled = EquityRecorder::lttb(points, 50);
+    ASSERT_EQ(sampled.size(), 50u);
+    EXPECT_EQ(std::get<0>(sampled.front()), 1000);
+    EXPECT_EQ(std::get<0>(sampled.back()), 1999);
+    bool spike = false, crash = false;
+    for (size_t i = 0; i < sampled.size(); ++i) {
+        if (i > 0) {
+            EXPECT_LT(std::get<0>(sampled[i - 1]), std::get<0>(sampled[i])); // In order, no repeats
+        }
+        spike |= std::get<1>(sampled[i]) == 300.0;
+        crash |= std::get<1>(sampled[i]) == -50.0;
+    }
+    EXPECT_TRUE(spike);
+    EXPECT_TRUE(crash);
+}
+
+TEST(LttbTest, DownsampleUsesTheKeptPoints) {
+    EquityRecorder recorder;
+    for (int i = 0; i < 500; ++i) {
+        recorder.record(i, 100.0 + (i % 50), MarketState());
+    }
+    const auto sampled = recorder.downsample(20);
+    ASSERT_EQ(sampled.size(), 20u);
+    EXPECT_EQ(std::get<0>(sampled.front()), 0);
+    EXPECT_EQ(std::get<0>(sampled.back()), 499);
+}
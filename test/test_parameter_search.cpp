@@ -0,0 +1,21 @@
+#include "gtest/gtest.h"
+#include "core/ParameterSearch.h"
+#include <limits>
+
+TEST(BayesianSearchTest, DegenerateFitStillProposesFullPoints) {
+    // Infinite scores leave no finite expected improvement anywhere.
+    auto search = makeSearchStrategy("bayesian", 2, 1, json::object());
+    const auto initial = search->ask(5);
+    ASSERT_EQ(initial.size(), 5u);
+    search->tell(initial, std::vector<double>(initial.size(), std::numeric_limits<double>::infinity()));
+
+    const auto next = search->ask(3);
+    ASSERT_EQ(next.size(), 3u);
+    for (const auto& point : next) {
+        ASSERT_EQ(point.size(), 2u);
+        for (double u : point) {
+            EXPECT_GE(u, 0.0);
+            EXPECT_LE(u, 1.0);
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#include "gtest/gtest.h"
+#include "core/Performance.h"
+#include <cmath>
+#include <vector>
+
+TEST(MonteCarloTest, TotalLossKeepsThePercentilesFinite) {
+    // A -100% period, then a recovery off zero equity (an infinite return).
+    const std::vector<double> equity = {100.0, 110.0, 105.0, 0.0, 50.0, 55.0, 60.0};
+    Performance performance(equity, 100.0);
+    const MonteCarloSummary summary = performance.runMonteCarloSimulation(1000, 7, 2);
+
+    ASSERT_EQ(summary.paths, 1000u);
+    for (double value : {summary.mean_return, summary.p5_return, summary.p50_return, summary.p95_return,
+                         summary.p50_max_drawdown, summary.p95_max_drawdown}) {
+        EXPECT_TRUE(std::isfinite(value));
+    }
+    // Paths that draw the wipe-out lose (almost) everything.
+    EXPECT_NEAR(summary.p5_return, -1.0, 1e-6);
+    EXPECT_NEAR(summary.p95_max_drawdown, 1.0, 1e-6);
+    EXPECT_GE(summary.p95_return, summary.p50_return);
+    EXPECT_GE(summary.p50_return, summary.p5_return);
+}
+
+TEST(MonteCarloTest, SameSeedGivesTheSameSummaryOnAnyThreadCount) {
+    std::vector<double> equity = {1000.0};
+    for (int i = 1; i < 200; ++i) {
+        equity.push_back(equity.back() * (1.0 + 0.01 * std::sin(i * 0.7)));
+    }
+    Performance performance(equity, 1000.0);
+    const MonteCarloSummary one = performance.runMonteCarloSimulation(600, 11, 1);
+    const MonteCarloSummary many = performance.runMonteCarloSimulation(600, 11, 4);
+    EXPECT_EQ(one.mean_return, many.mean_return);
+    EXPECT_EQ(one.p50_return, many.p50_return);
+    EXPECT_EQ(one.p95_max_drawdown, many.p95_max_drawdown);
+}
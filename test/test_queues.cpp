@@ -0,0 +1,126 @@
+#include "gtest/gtest.h"
+#include "event/SpscQueue.h"
+#include "event/ThreadSafeQueue.h"
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+TEST(ThreadSafeQueueTest, PopsInPushOrder) {
+    ThreadSafeQueue<int> queue;
+    EXPECT_FALSE(queue.try_pop().has_value());
+    for (int i = 0; i < 10; ++i) {
+        queue.push(std::make_shared<int>(i));
+    }
+    for (int i = 0; i < 10; ++i) {
+        auto item = queue.try_pop();
+        ASSERT_TRUE(item.has_value());
+        EXPECT_EQ(**item, i);
+    }
+    EXPECT_FALSE(queue.try_pop().has_value());
+}
+
+TEST(ThreadSafeQueueTest, ManyProducersLoseAndDuplicateNothing) {
+    constexpr int kProducers = 4;
+    constexpr int kItemsEach = 200000;
+    ThreadSafeQueue<std::pair<int, int>> queue; // (producer, sequence)
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&queue, p] {
+            for (int i = 0; i < kItemsEach; ++i) {
+                queue.push(std::make_shared<std::pair<int, int>>(p, i));
+            }
+        });
+    }
+
+    // Each producer's items must arrive exactly once and in the order pushed.
+    std::vector<int> next(kProducers, 0);
+    int received = 0;
+    while (received < kProducers * kItemsEach) {
+        auto item = queue.try_pop();
+        if (!item) {
+            std::this_thread::yield();
+            continue;
+        }
+        const auto [producer, sequence] = **item;
+        ASSERT_GE(producer, 0);
+        ASSERT_LT(producer, kProducers);
+        ASSERT_EQ(sequence, next[producer]) << "producer " << producer;
+        ++next[producer];
+        ++received;
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    EXPECT_FALSE(queue.try_pop().has_value());
+    for (int p = 0; p < kProducers; ++p) {
+        EXPECT_EQ(next[p], kItemsEach);
+    }
+}
+
+TEST(SpscQueueTest, WrapsAroundAndReportsFullAndEmpty) {
+    SpscQueue<int> queue(3);
+    ASSERT_EQ(queue.capacity(), 4u);
+
+    int value = 0;
+    int expected = 0;
+    // Many passes over the ring, at every fill level, so the indices wrap the slots.
+    for (int round = 0; round < 100; ++round) {
+        const int batch = round % 4 + 1;
+        for (int i = 0; i < batch; ++i) {
+            ASSERT_TRUE(queue.try_push(value++));
+        }
+        if (batch == 4) {
+            EXPECT_FALSE(queue.try_push(-1));
+        }
+        int out = 0;
+        for (int i = 0; i < batch; ++i) {
+            ASSERT_TRUE(queue.try_pop(out));
+            EXPECT_EQ(out, expected++);
+        }
+        EXPECT_FALSE(queue.try_pop(out));
+    }
+}
+
+TEST(SpscQueueTest, MoveOnlyPushLeavesValueWhenFull) {
+    SpscQueue<std::unique_ptr<int>> queue(2);
+    ASSERT_TRUE(queue.try_push(std::make_unique<int>(1)));
+    ASSERT_TRUE(queue.try_push(std::make_unique<int>(2)));
+    auto rejected = std::make_unique<int>(3);
+    EXPECT_FALSE(queue.try_push(std::move(rejected)));
+    ASSERT_NE(rejected, nullptr);
+    EXPECT_EQ(*rejected, 3);
+
+    std::unique_ptr<int> out;
+    ASSERT_TRUE(queue.try_pop(out));
+    EXPECT_EQ(*out, 1);
+}
+
+TEST(SpscQueueTest, ProducerAndConsumerThreadsKeepOrder) {
+    constexpr int kItems = 1000000;
+    SpscQueue<int> queue(16); // Small, so both sides keep hitting full and empty
+
+    std::thread producer([&queue] {
+        for (int i = 0; i < kItems;) {
+            if (queue.try_push(i)) {
+                ++i;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    int expected = 0;
+    int out = 0;
+    while (expected < kItems) {
+        if (queue.try_pop(out)) {
+            ASSERT_EQ(out, expected);
+            ++expected;
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    producer.join();
+    EXPECT_FALSE(queue.try_pop(out));
+}